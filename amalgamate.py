@@ -69,9 +69,16 @@ def amalgamate_source( source_top_dir=None,
     header.add_file( 'include/json/config.h' )
     header.add_file( 'include/json/forwards.h' )
     header.add_file( 'include/json/features.h' )
+    header.add_file( 'include/json/statistics.h' )
     header.add_file( 'include/json/value.h' )
+    header.add_file( 'include/json/document.h' )
+    header.add_file( 'include/json/file.h' )
     header.add_file( 'include/json/reader.h' )
     header.add_file( 'include/json/writer.h' )
+    header.add_file( 'include/json/lazy.h' )
+    header.add_file( 'include/json/binding.h' )
+    header.add_file( 'include/json/patch.h' )
+    header.add_file( 'include/json/reclaimer.h' )
     header.add_text( '#endif //ifndef JSON_AMALGATED_H_INCLUDED' )
 
     target_header_path = os.path.join( os.path.dirname(target_source_path), header_include_path )
@@ -109,11 +116,18 @@ def amalgamate_source( source_top_dir=None,
     source.add_text( '#include <%s>' % header_include_path )
     source.add_text( '' )
     source.add_file( 'src/lib_json\json_tool.h' )
+    source.add_file( 'src/lib_json\json_statistics.cpp' )
     source.add_file( 'src/lib_json\json_reader.cpp' )
     source.add_file( 'src/lib_json\json_batchallocator.h' )
     source.add_file( 'src/lib_json\json_valueiterator.inl' )
     source.add_file( 'src/lib_json\json_value.cpp' )
+    source.add_file( 'src/lib_json\json_document.cpp' )
+    source.add_file( 'src/lib_json\json_file.cpp' )
     source.add_file( 'src/lib_json\json_writer.cpp' )
+    source.add_file( 'src/lib_json\json_lazy.cpp' )
+    source.add_file( 'src/lib_json\json_binding.cpp' )
+    source.add_file( 'src/lib_json\json_patch.cpp' )
+    source.add_file( 'src/lib_json\json_reclaimer.cpp' )
 
     print 'Writing amalgated source to %r' % target_source_path
     source.write_to( target_source_path )
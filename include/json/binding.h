@@ -0,0 +1,562 @@
+#pragma once
+
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef JSONCPP_BINDING_H_INCLUDED
+#define JSONCPP_BINDING_H_INCLUDED
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include "reader.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <cmath>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+namespace Json {
+
+    class Binder;
+
+    /// \brief A C++ object, with the Binder that reads and writes it.
+    class JSONCPP_API BoundValue {
+    public:
+        void* object_;
+        /// nullptr if the value is not bound: the JSON value is then skipped.
+        const Binder* binder_;
+
+        BoundValue() : object_{ nullptr }, binder_{ nullptr } {}
+        BoundValue(void* object, const Binder* binder) : object_{ object }, binder_{ binder } {}
+    };
+
+    /** \brief Reads and writes the objects of a C++ type, for BindingReader and BindingWriter.
+     *
+     * The object passed to each function is of the bound type. The read functions
+     * return \c false if the JSON value cannot be stored in the object; their default
+     * implementations reject the value. Binders have no state: binderOf() creates one
+     * for each bound type.
+     */
+    class JSONCPP_API Binder {
+    public:
+        static const size_t notAField = size_t(-1);
+
+        virtual ~Binder();
+
+        /// JSON values accepted, for error messages: "an integer", "an array"...
+        virtual const char* expected() const = 0;
+
+        /// \name Scalar values
+        /// @{
+        virtual bool readNull(void* object) const;
+        virtual bool readBool(void* object, bool value) const;
+        /// Integers that fit in a LargestInt.
+        virtual bool readInt(void* object, LargestInt value) const;
+        /// Positive integers greater than LargestInt max.
+        virtual bool readUInt(void* object, LargestUInt value) const;
+        virtual bool readDouble(void* object, double value) const;
+        virtual bool readString(void* object, std::string_view value) const;
+        /// @}
+
+        /// \name Arrays
+        /// @{
+        /// \brief Prepare object to receive the elements of an array.
+        /// \return The container receiving the elements; its binder_ is nullptr if arrays are rejected.
+        virtual BoundValue startArray(void* object) const;
+        /// Append an element to a container returned by startArray().
+        virtual BoundValue element(void* array) const;
+        /// @}
+
+        /// \name Objects
+        /// @{
+        /// \brief Prepare object to receive the members of an object.
+        /// \return The container receiving the members; its binder_ is nullptr if objects are rejected.
+        virtual BoundValue startObject(void* object) const;
+        /** \brief Member named name of a container returned by startObject().
+         * \param field On input, the field following the previous member of the object, or 0.
+         *              On output, the field of the member, or notAField.
+         * \return A value whose binder_ is nullptr if the member is ignored.
+         */
+        virtual BoundValue member(void* object, std::string_view name, size_t& field) const;
+        /// Number of fields tracked by member() and missingMember().
+        virtual size_t fieldCount() const;
+        /// \brief Name of the first required field that was not read, or nullptr.
+        /// \param seen fieldCount() flags, set for each field returned by member().
+        virtual const char* missingMember(const unsigned char* seen) const;
+        /// @}
+
+        /// \c true if the object is not written as a member, like an empty std::optional.
+        virtual bool isAbsent(const void* object) const;
+
+        /// Append the JSON representation of object to document, without formatting.
+        virtual void write(const void* object, std::string& document) const = 0;
+
+    protected:
+        static void writeInt(LargestInt value, std::string& document);
+        static void writeUInt(LargestUInt value, std::string& document);
+        static void writeDouble(double value, std::string& document);
+        static void writeString(std::string_view value, std::string& document);
+    };
+
+    /** \brief Declares the fields of a struct, by a specialization of this template.
+     *
+     * The specialization provides a static function returning the Fields of T,
+     * in the order they are written:
+     * \code
+     * struct Address { std::string city; int zip; };
+     * struct Person { std::string name; Json::Int64 id; std::vector<Address> addresses; std::optional<std::string> email; };
+     *
+     * template <> class Json::Binding<Address> {
+     * public:
+     *    static Json::Fields fields() { return { JSONCPP_FIELD(Address, city), JSONCPP_FIELD(Address, zip) }; }
+     * };
+     * template <> class Json::Binding<Person> {
+     * public:
+     *    static Json::Fields fields() {
+     *       return { JSONCPP_FIELD(Person, name), Json::field<&Person::id>("personId"),
+     *                JSONCPP_FIELD(Person, addresses), JSONCPP_FIELD(Person, email) };
+     *    }
+     * };
+     * \endcode
+     * fields() is only called once.
+     */
+    template <typename T>
+    class Binding;
+
+    /// Presence of a field in a JSON object. \sa field()
+    enum FieldPresence {
+        fieldRequired = 0, ///< The member must be present, unless the field is a std::optional
+        fieldOptional      ///< The field keeps its value if the member is absent
+    };
+
+    /// \brief A field of a struct, created by field(). \sa Binding
+    class JSONCPP_API Field {
+    public:
+        /// Name of the JSON member.
+        std::string name_;
+        const Binder& (*binder_)();
+        /// Returns the field of a struct.
+        void* (*member_)(void* object);
+        bool required_;
+    };
+
+    typedef std::vector<Field> Fields;
+
+    /** \brief Binder of a struct declared by a Binding specialization.
+     *
+     * Members are found from their names by a table sorted when the binder is created.
+     * The field following the previous member is checked first, so that members
+     * written in declaration order are found without searching. Unknown members are ignored.
+     */
+    class JSONCPP_API StructBinder : public Binder {
+    public:
+        explicit StructBinder(Fields&& fields);
+
+        const char* expected() const override;
+        BoundValue startObject(void* object) const override;
+        BoundValue member(void* object, std::string_view name, size_t& field) const override;
+        size_t fieldCount() const override;
+        const char* missingMember(const unsigned char* seen) const override;
+        void write(const void* object, std::string& document) const override;
+
+    private:
+        Fields fields_;
+        // "name": of each field.
+        std::vector<std::string> prefixes_;
+        // Positions in fields_, sorted by names.
+        std::vector<size_t> byName_;
+    };
+
+    template <typename T>
+    const Binder& binderOf();
+
+    /// \cond INTERNAL
+    namespace Bindings {
+
+        template <typename T>
+        class MemberPointer;
+
+        template <typename Class, typename Member>
+        class MemberPointer<Member Class::*> {
+        public:
+            typedef Class ClassType;
+            typedef Member MemberType;
+        };
+
+        template <typename T>
+        constexpr bool isOptional = false;
+        template <typename T>
+        constexpr bool isOptional<std::optional<T>> = true;
+
+        template <typename T>
+        constexpr bool isVector = false;
+        template <typename T, typename Allocator>
+        constexpr bool isVector<std::vector<T, Allocator>> = !std::is_same_v<T, bool>;
+
+        template <typename T>
+        constexpr bool isStringMap = false;
+        template <typename T, typename Compare, typename Allocator>
+        constexpr bool isStringMap<std::map<std::string, T, Compare, Allocator>> = true;
+
+        class JSONCPP_API BoolBinder : public Binder {
+        public:
+            const char* expected() const override;
+            bool readBool(void* object, bool value) const override;
+            void write(const void* object, std::string& document) const override;
+        };
+
+        class JSONCPP_API StringBinder : public Binder {
+        public:
+            const char* expected() const override;
+            bool readString(void* object, std::string_view value) const override;
+            void write(const void* object, std::string& document) const override;
+        };
+
+        /* Integers out of the range of T are rejected. Numbers written with a fraction
+         * or an exponent are accepted if their value is an integer.
+         */
+        template <typename T>
+        class IntegerBinder : public Binder {
+        public:
+            const char* expected() const override { return "an integer in the range of the field"; }
+
+            bool readInt(void* object, LargestInt value) const override { return store(object, value); }
+
+            bool readUInt(void* object, LargestUInt value) const override { return store(object, value); }
+
+            bool readDouble(void* object, double value) const override {
+                // Bounds are powers of two, so they are exact doubles.
+                const double limit = std::ldexp(1.0, std::numeric_limits<T>::digits);
+                const double lowest = std::is_signed_v<T> ? -limit : 0.0;
+                if (!(value >= lowest && value < limit) || value != std::trunc(value))
+                    return false;
+                *static_cast<T*>(object) = T(value);
+                return true;
+            }
+
+            void write(const void* object, std::string& document) const override {
+                if constexpr (std::is_signed_v<T>)
+                    writeInt(LargestInt(*static_cast<const T*>(object)), document);
+                else
+                    writeUInt(LargestUInt(*static_cast<const T*>(object)), document);
+            }
+
+        private:
+            template <typename Integer>
+            static bool store(void* object, Integer value) {
+                if (!std::in_range<T>(value))
+                    return false;
+                *static_cast<T*>(object) = T(value);
+                return true;
+            }
+        };
+
+        template <typename T>
+        class RealBinder : public Binder {
+        public:
+            const char* expected() const override { return "a number"; }
+
+            bool readInt(void* object, LargestInt value) const override { return store(object, double(value)); }
+
+            bool readUInt(void* object, LargestUInt value) const override { return store(object, double(value)); }
+
+            bool readDouble(void* object, double value) const override { return store(object, value); }
+
+            void write(const void* object, std::string& document) const override { writeDouble(double(*static_cast<const T*>(object)), document); }
+
+        private:
+            static bool store(void* object, double value) {
+                *static_cast<T*>(object) = T(value);
+                return true;
+            }
+        };
+
+        template <typename Vector>
+        class VectorBinder : public Binder {
+        public:
+            const char* expected() const override { return "an array"; }
+
+            BoundValue startArray(void* object) const override {
+                static_cast<Vector*>(object)->clear();
+                return BoundValue(object, this);
+            }
+
+            BoundValue element(void* array) const override {
+                return BoundValue(&static_cast<Vector*>(array)->emplace_back(), &binderOf<typename Vector::value_type>());
+            }
+
+            void write(const void* object, std::string& document) const override {
+                const Binder& binder = binderOf<typename Vector::value_type>();
+                document += '[';
+                bool first = true;
+                for (const auto& element : *static_cast<const Vector*>(object)) {
+                    if (!std::exchange(first, false))
+                        document += ',';
+                    binder.write(&element, document);
+                }
+                document += ']';
+            }
+        };
+
+        /* Objects whose member names are not known in advance. */
+        template <typename Map>
+        class MapBinder : public Binder {
+        public:
+            const char* expected() const override { return "an object"; }
+
+            BoundValue startObject(void* object) const override {
+                static_cast<Map*>(object)->clear();
+                return BoundValue(object, this);
+            }
+
+            BoundValue member(void* object, std::string_view name, size_t& field) const override {
+                field = notAField;
+                return BoundValue(&(*static_cast<Map*>(object))[std::string(name)], &binderOf<typename Map::mapped_type>());
+            }
+
+            void write(const void* object, std::string& document) const override {
+                const Binder& binder = binderOf<typename Map::mapped_type>();
+                document += '{';
+                bool first = true;
+                for (const auto& [name, member] : *static_cast<const Map*>(object)) {
+                    if (binder.isAbsent(&member))
+                        continue;
+                    if (!std::exchange(first, false))
+                        document += ',';
+                    writeString(name, document);
+                    document += ':';
+                    binder.write(&member, document);
+                }
+                document += '}';
+            }
+        };
+
+        /* null resets the optional. Any other value is stored in its value, which is
+         * created if needed. Empty optionals are not written as members.
+         */
+        template <typename Optional>
+        class OptionalBinder : public Binder {
+        public:
+            const char* expected() const override { return binder().expected(); }
+
+            bool readNull(void* object) const override {
+                get(object).reset();
+                return true;
+            }
+
+            bool readBool(void* object, bool value) const override { return binder().readBool(emplace(object), value); }
+
+            bool readInt(void* object, LargestInt value) const override { return binder().readInt(emplace(object), value); }
+
+            bool readUInt(void* object, LargestUInt value) const override { return binder().readUInt(emplace(object), value); }
+
+            bool readDouble(void* object, double value) const override { return binder().readDouble(emplace(object), value); }
+
+            bool readString(void* object, std::string_view value) const override { return binder().readString(emplace(object), value); }
+
+            BoundValue startArray(void* object) const override { return binder().startArray(emplace(object)); }
+
+            BoundValue startObject(void* object) const override { return binder().startObject(emplace(object)); }
+
+            bool isAbsent(const void* object) const override { return !static_cast<const Optional*>(object)->has_value(); }
+
+            void write(const void* object, std::string& document) const override {
+                const Optional& optional = *static_cast<const Optional*>(object);
+                if (optional.has_value())
+                    binder().write(&*optional, document);
+                else
+                    document += "null";
+            }
+
+        private:
+            static const Binder& binder() { return binderOf<typename Optional::value_type>(); }
+
+            static Optional& get(void* object) { return *static_cast<Optional*>(object); }
+
+            static void* emplace(void* object) {
+                Optional& optional = get(object);
+                if (!optional.has_value())
+                    optional.emplace();
+                return &*optional;
+            }
+        };
+
+        const Binder& JSONCPP_API boolBinder();
+        const Binder& JSONCPP_API stringBinder();
+
+    } // namespace Bindings
+    /// \endcond
+
+    /** \brief Binder of the objects of type T.
+     *
+     * Bound types are bool, the arithmetic types, std::string, std::optional, std::vector
+     * and std::map with std::string keys of bound types, and the structs declared by
+     * a Binding specialization.
+     */
+    template <typename T>
+    const Binder& binderOf() {
+        if constexpr (std::is_same_v<T, bool>) {
+            return Bindings::boolBinder();
+        } else if constexpr (std::is_integral_v<T>) {
+            static const Bindings::IntegerBinder<T> binder;
+            return binder;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            static const Bindings::RealBinder<T> binder;
+            return binder;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return Bindings::stringBinder();
+        } else if constexpr (Bindings::isOptional<T>) {
+            static const Bindings::OptionalBinder<T> binder;
+            return binder;
+        } else if constexpr (Bindings::isVector<T>) {
+            static const Bindings::VectorBinder<T> binder;
+            return binder;
+        } else if constexpr (Bindings::isStringMap<T>) {
+            static const Bindings::MapBinder<T> binder;
+            return binder;
+        } else {
+            static_assert(requires { Binding<T>::fields(); }, "The fields of the struct must be declared by a specialization of Json::Binding.");
+            static const StructBinder binder(Binding<T>::fields());
+            return binder;
+        }
+    }
+
+    /** \brief Field of a struct, bound to the JSON member named name.
+     *
+     * member is a pointer to a data member of the struct, such as &Person::name.
+     * std::optional fields are never required.
+     * \sa Binding, JSONCPP_FIELD
+     */
+    template <auto member>
+    Field field(std::string name, FieldPresence presence = fieldRequired) {
+        typedef Bindings::MemberPointer<decltype(member)> Pointer;
+        typedef typename Pointer::ClassType Class;
+        typedef typename Pointer::MemberType Member;
+        Field result;
+        result.name_ = std::move(name);
+        result.binder_ = &binderOf<Member>;
+        result.member_ = [](void* object) -> void* { return &(static_cast<Class*>(object)->*member); };
+        result.required_ = presence == fieldRequired && !Bindings::isOptional<Member>;
+        return result;
+    }
+
+/// Field of a struct bound to the JSON member of the same name. \sa Json::field()
+#define JSONCPP_FIELD(Type, member) ::Json::field<&Type::member>(#member)
+
+    /** \brief Reads a <a HREF="http://www.json.org">JSON</a> document directly into a C++ object, without building a Value.
+     *
+     * The document is tokenized by a Reader, whose events are stored in the object
+     * by its Binder: see binderOf() for the bound types. The reader
+     * stops at the first type mismatch or missing required member, whose location
+     * is reported by getFormattedErrorMessages() along with its JSON Pointer:
+     * \code
+     * Json::BindingReader reader;
+     * Person person;
+     * if ( !reader.parse( text, person ) )
+     *    std::cerr << reader.getFormattedErrorMessages(); // "Expected an integer in the range of the field at /addresses/0/zip"
+     * \endcode
+     *
+     * Arrays and objects are cleared before their elements are read; fields of structs
+     * whose members are absent keep their value. A BindingReader parses each document
+     * without allocating anything of its own once it has parsed a few documents.
+     */
+    class JSONCPP_API BindingReader {
+    public:
+        explicit BindingReader(const Features& features = Features::all());
+
+        /** \brief Read object from the <a HREF="http://www.json.org">JSON</a> document [beginDoc, endDoc).
+         *
+         * The document is not copied. The errors remain available after it has been destroyed.
+         * \return \c true if the document was read into object, \c false if an error occurred.
+         *         object may then be partially read.
+         */
+        template <typename T>
+        bool parse(const char* beginDoc, const char* endDoc, T& object) {
+            return parse(beginDoc, endDoc, BoundValue(&object, &binderOf<T>()));
+        }
+
+        /// \brief Read object from document.
+        /// \see parse(const char*, const char*, T&)
+        template <typename T>
+        bool parse(const std::string& document, T& object) {
+            return parse(document.data(), document.data() + document.size(), object);
+        }
+
+        /** \brief Returns a user friendly string that list errors in the parsed document.
+         * \return An empty string if no error occurred during parsing.
+         */
+        std::string getFormattedErrorMessages() const;
+
+        /// \brief Returns the errors of the parsed document, with their locations.
+        /// \see Reader::getStructuredErrors()
+        std::vector<StructuredError> getStructuredErrors() const;
+
+    private:
+        class Filler;
+        friend class Filler;
+
+        class Frame {
+        public:
+            BoundValue container_;
+            // Name of the member being read, for objects.
+            std::string key_;
+            // Number of elements read, for arrays; field following the last member read, for objects.
+            size_t count_;
+            // Position of the flags of the fields of the object in seen_.
+            size_t seen_;
+            bool isArray_;
+
+            Frame() : container_{}, key_{}, count_{ 0 }, seen_{ 0 }, isArray_{ false } {}
+        };
+
+        bool parse(const char* beginDoc, const char* endDoc, BoundValue root);
+
+        Reader reader_;
+        // Containers being read, outermost first: only the first depth_ are used, so
+        // that their keys keep their capacity.
+        std::vector<Frame> frames_;
+        size_t depth_;
+        std::vector<unsigned char> seen_;
+        // Type mismatch or missing member that stopped the last parse.
+        std::string error_;
+    };
+
+    /** \brief Writes C++ objects in <a HREF="http://www.json.org">JSON</a> format, without building a Value.
+     *
+     * The document is formatted like by FastWriter. Struct fields are written in the
+     * order of their declaration in Binding, except empty std::optional fields.
+     * \sa binderOf()
+     */
+    class JSONCPP_API BindingWriter {
+    public:
+        BindingWriter() : document_{} {}
+
+        template <typename T>
+        std::string write(const T& object) {
+            document_.clear();
+            write(object, document_);
+            return document_;
+        }
+
+        /// \brief Append the document representing object to document.
+        /// \see FastWriter::write(const Value&, std::string&)
+        template <typename T>
+        void write(const T& object, std::string& document) {
+            binderOf<T>().write(&object, document);
+            document += '\n';
+        }
+
+    private:
+        std::string document_;
+    };
+
+} // namespace Json
+
+#endif // JSONCPP_BINDING_H_INCLUDED
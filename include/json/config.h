@@ -27,6 +27,11 @@
 /// Remarks: defining this macro enables the functionality of: JSONCPP_ASSERT_UNREACHABLE, JSONCPP_ASSERT, JSONCPP_FAIL_MESSAGE, and JSONCPP_ASSERT_MESSAGE
 // # define JSONCPP_ENABLE_ASSERTS 1
 
+/// If defined, Reader and the writers collect Statistics on each parse and write,
+/// and report them to the listener registered with setStatisticsListener().
+/// Else, statistics are compiled out and stay 0.
+// # define JSONCPP_ENABLE_STATISTICS 1
+
 #if defined(JSONCPP_DLL_BUILD)
 #define JSONCPP_API __declspec(dllexport)
 #elif defined(JSONCPP_DLL)
@@ -0,0 +1,95 @@
+#pragma once
+
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef JSONCPP_DOCUMENT_H_INCLUDED
+#define JSONCPP_DOCUMENT_H_INCLUDED
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include "value.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <memory_resource>
+#include <string_view>
+#include <cstddef>
+
+namespace Json {
+
+    /** \brief Monotonic memory pool used to build short-lived Value trees.
+     *
+     * Memory is carved out of large blocks and is never returned piecemeal:
+     * everything allocated from the arena is reclaimed at once by release() or
+     * by the destructor, without running any destructor on the objects it holds.
+     *
+     * \sa Value::Value(ValueType, Arena&), Document
+     */
+    class JSONCPP_API Arena {
+    public:
+        /// \param initialSize Size in bytes of the first block requested from the heap.
+        explicit Arena(std::size_t initialSize = 4096);
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /// Allocate size bytes aligned on alignment.
+        void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+        /// Copy str into the arena and zero-terminate it.
+        char* duplicate(std::string_view str);
+
+        /// Reclaim all the memory allocated from the arena.
+        /// \warning Every Value built in the arena becomes dangling.
+        void release();
+
+        /// Memory resource used by the containers of Value built in this arena.
+        std::pmr::memory_resource* resource();
+
+    private:
+        std::pmr::monotonic_buffer_resource resource_;
+    };
+
+    /** \brief A Value tree whose nodes, member names and strings are allocated in an Arena.
+     *
+     * The tree is destroyed in one shot when the Document is destroyed or cleared:
+     * no per-node destructor walk is performed.
+     *
+     * Example of usage:
+     * \code
+     * Json::Document doc;
+     * Json::Reader reader;
+     * if ( reader.parse( text, doc ) )
+     *    std::cout << doc.root()["name"].asString();
+     * \endcode
+     *
+     * Values reachable from root() must not outlive the Document: copy them to
+     * detach them from the arena. Values that own heap memory (strings, arrays or
+     * objects not created with the Document arena) which are stored in the tree
+     * are not destroyed when the Document is released.
+     */
+    class JSONCPP_API Document {
+    public:
+        explicit Document(std::size_t initialSize = 4096);
+        ~Document();
+
+        Document(const Document&) = delete;
+        Document& operator=(const Document&) = delete;
+
+        Value& root();
+        const Value& root() const;
+
+        Arena& arena();
+
+        /// Reset root() to null and release the arena.
+        void clear();
+
+    private:
+        Arena arena_;
+        Value root_;
+    };
+
+} // namespace Json
+
+#endif // JSONCPP_DOCUMENT_H_INCLUDED
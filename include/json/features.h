@@ -43,6 +43,25 @@ namespace Json {
 
         /// \c true if root must be either an array or an object value. Default: \c false.
         bool strictRoot_;
+
+        /// \c true if the Reader interns member names in a KeyTable shared by all the
+        /// documents it parses, so that each distinct name is allocated once.
+        /// Ignored when parsing into a Document. Default: \c false.
+        bool internKeys_;
+
+        /// \c true if the Reader stops at the first error. Otherwise it skips the rest of
+        /// each enclosing array and object, which costs a scan of the remaining document.
+        /// The reported errors are the same either way. Default: \c false.
+        bool failFast_;
+
+        /// \c true if the Reader rejects the strings that are not valid UTF-8 (RFC 3629),
+        /// and the \\u escapes of unpaired surrogates. The strings are validated while
+        /// they are tokenized. Default: \c false.
+        bool strictUtf8_;
+
+        /// Maximum nesting of arrays and objects in a document read by a Reader.
+        /// Deeper documents are rejected. Default: 1000.
+        unsigned int maxDepth_;
     };
 
 } // namespace Json
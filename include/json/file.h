@@ -0,0 +1,68 @@
+#pragma once
+
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef JSONCPP_FILE_H_INCLUDED
+#define JSONCPP_FILE_H_INCLUDED
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include "config.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <string>
+#include <cstddef>
+
+namespace Json {
+
+    /** \brief Read-only content of a file, memory-mapped when possible.
+     *
+     * On POSIX systems and on Windows, regular files are mapped in memory: their content
+     * is read from the page cache when it is accessed, and is never copied. Other files
+     * (pipes, devices), and all files on other systems, are read into a buffer.
+     *
+     * Example of usage:
+     * \code
+     * Json::MappedFile file;
+     * Json::LazyDocument doc;
+     * if ( file.open( "snapshot.json" )  &&  doc.parse( file.begin(), file.end() ) )
+     *    ...
+     * \endcode
+     */
+    class JSONCPP_API MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// \brief Read the file at path, releasing the previous one.
+        /// \return \c false if the file cannot be read.
+        bool open(const std::string& path);
+
+        /// Release the content of the file.
+        void close();
+
+        const char* begin() const { return data_; }
+        const char* end() const { return data_ + size_; }
+        size_t size() const { return size_; }
+
+        /// \c true if the content is mapped, \c false if it was read into a buffer.
+        bool isMapped() const { return mapped_; }
+
+    private:
+        bool map(const std::string& path);
+        bool read(const std::string& path);
+
+        const char* data_;
+        size_t size_;
+        // Content of the files that cannot be mapped.
+        std::string buffer_;
+        bool mapped_;
+    };
+
+} // namespace Json
+
+#endif // JSONCPP_FILE_H_INCLUDED
@@ -15,21 +15,64 @@
 namespace Json {
 
     // writer.h
+    class OutputSink;
     class FastWriter;
+    class BinaryWriter;
     class StyledWriter;
 
     // reader.h
+    class Handler;
+    class FeaturesPolicy;
+    class StrictPolicy;
+    template <typename Policy>
+    class BasicReader;
     class Reader;
+    class StructuredError;
+    typedef BasicReader<StrictPolicy> StrictReader;
+    class BinaryReader;
 
     // features.h
     class Features;
 
+    // statistics.h
+    class Statistics;
+    class StatisticsListener;
+
+    // document.h
+    class Arena;
+    class Document;
+
+    // file.h
+    class MappedFile;
+
+    // lazy.h
+    class LazyDocument;
+    class LazyValue;
+
+    // binding.h
+    class BoundValue;
+    class Binder;
+    template <typename T>
+    class Binding;
+    class Field;
+    class StructBinder;
+    class BindingReader;
+    class BindingWriter;
+
+    // patch.h
+    class Patch;
+
+    // reclaimer.h
+    class Reclaimer;
+
     // value.h
     typedef unsigned int ArrayIndex;
     class StaticString;
     class Path;
     class PathArgument;
+    class PathSet;
     class Value;
+    class KeyTable;
     class ValueIteratorBase;
     class ValueIterator;
     class ValueConstIterator;
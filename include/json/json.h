@@ -10,8 +10,15 @@
 
 #include "config.h"
 #include "value.h"
+#include "document.h"
+#include "file.h"
 #include "reader.h"
 #include "writer.h"
+#include "lazy.h"
+#include "binding.h"
+#include "patch.h"
+#include "reclaimer.h"
 #include "features.h"
+#include "statistics.h"
 
 #endif // JSONCPP_JSON_H_INCLUDED
@@ -0,0 +1,242 @@
+#pragma once
+
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef JSONCPP_LAZY_H_INCLUDED
+#define JSONCPP_LAZY_H_INCLUDED
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include "value.h"
+#include "reader.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace Json {
+
+    class LazyDocument;
+
+    /** \brief A value of a LazyDocument, decoded only when it is accessed.
+     *
+     * A LazyValue is a light handle on the text of the value: looking up a member
+     * or an element only scans the enclosing container, skipping nested arrays and
+     * objects without reading them, and the conversion functions decode the text
+     * of the value itself. A LazyValue that does not reference any value (a missing
+     * member, an out of range index) converts to \c false and behaves like null.
+     *
+     * A LazyValue must not outlive its LazyDocument.
+     */
+    class JSONCPP_API LazyValue {
+    public:
+        class const_iterator;
+
+        /// A value that references nothing.
+        LazyValue();
+
+        /// \c true if the value references a value of the document.
+        explicit operator bool() const { return document_ != nullptr; }
+
+        /// Type of the value, read from its first characters; nullValue if it references nothing.
+        ValueType type() const;
+
+        bool isNull() const { return type() == nullValue; }
+        bool isObject() const { return type() == objectValue; }
+        bool isArray() const { return type() == arrayValue; }
+        bool isString() const { return type() == stringValue; }
+
+        /// Number of members or elements; 0 if the value is not an object or an array.
+        ArrayIndex size() const;
+
+        /// \brief Member named key.
+        /// \return A value that references nothing if the value is not an object or has no such member.
+        ///         If several members have this name, the first one is returned.
+        LazyValue operator[](std::string_view key) const;
+
+        /// \brief Element at index.
+        /// \return A value that references nothing if the value is not an array or is too short.
+        LazyValue operator[](ArrayIndex index) const;
+
+        LazyValue get(std::string_view key) const { return (*this)[key]; }
+        LazyValue get(ArrayIndex index) const { return (*this)[index]; }
+
+        /// \brief Look up the member named key.
+        /// \return \c false if there is no such member.
+        bool tryGet(std::string_view key, LazyValue& value) const;
+        /// \brief Look up the element at index.
+        /// \return \c false if there is no such element.
+        bool tryGet(ArrayIndex index, LazyValue& value) const;
+
+        bool isMember(std::string_view key) const { return bool((*this)[key]); }
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        /// Text of the value in the document, exactly as written.
+        std::string_view text() const;
+
+        /** \brief Parse the value and all its descendants into value.
+         * \return \c false if the value references nothing or its text is not valid JSON;
+         *         the errors are then available from LazyDocument::getFormattedErrorMessages().
+         */
+        bool toValue(Value& value) const;
+
+        /// Decode the value into a Value; null if the value is invalid or references nothing.
+        Value toValue() const;
+
+        /// \name Conversions
+        /// Decode the value and convert it like the corresponding members of Value.
+        /// defaultValue is returned if the value references nothing or is null.
+        /// @{
+        std::string asString(const std::string& defaultValue = "") const;
+        LargestInt asLargestInt(LargestInt defaultValue = 0) const;
+        LargestUInt asLargestUInt(LargestUInt defaultValue = 0) const;
+        double asDouble(double defaultValue = 0.0) const;
+        bool asBool(bool defaultValue = false) const;
+        /// @}
+
+    private:
+        friend class LazyDocument;
+
+        static const size_t noNode = size_t(-1);
+
+        LazyValue(const LazyDocument* document, const char* begin, size_t node);
+
+        const char* findEnd() const;
+
+        const LazyDocument* document_;
+        const char* begin_;
+        // Position of the array or object in LazyDocument::nodes_; noNode for other values.
+        size_t node_;
+    };
+
+    /// Forward iterator on the members of an object or the elements of an array.
+    class JSONCPP_API LazyValue::const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef LazyValue value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const LazyValue* pointer;
+        typedef const LazyValue& reference;
+
+        const_iterator();
+
+        reference operator*() const { return value_; }
+        pointer operator->() const { return &value_; }
+
+        const_iterator& operator++();
+        const_iterator operator++(int);
+
+        bool operator==(const const_iterator& other) const { return value_.begin_ == other.value_.begin_; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+        /// Unescaped name of the current member; empty when iterating an array.
+        std::string key() const;
+
+        /// Zero based position of the current member or element.
+        ArrayIndex index() const { return index_; }
+
+    private:
+        friend class LazyValue;
+
+        const_iterator(const LazyValue& container);
+
+        void readElement(const char* current);
+        bool keyEquals(std::string_view key) const;
+
+        LazyValue value_;
+        // Characters of the member name, without quotes.
+        const char* keyBegin_;
+        const char* keyEnd_;
+        // Container of the element following value_.
+        size_t nextNode_;
+        ArrayIndex index_;
+        bool isObject_;
+    };
+
+    /** \brief A <a HREF="http://www.json.org">JSON</a> document whose values are decoded on demand.
+     *
+     * parse() only records the extent of each array and object, by matching brackets,
+     * so that nested containers can be skipped without being read. Strings, numbers
+     * and subtrees are decoded only when they are reached through root().
+     * This is much cheaper than building a Value tree when only a few members of a
+     * large document are used.
+     *
+     * Example of usage:
+     * \code
+     * Json::LazyDocument doc;
+     * if ( doc.parse( text.data(), text.data() + text.size() ) )
+     *    std::cout << doc.root()["user"]["name"].asString();
+     * \endcode
+     *
+     * Only strict JSON is accepted: comments are not allowed. parse() detects unbalanced
+     * brackets and trailing characters; other syntax errors are only reported when the
+     * value that contains them is decoded.
+     *
+     * A LazyDocument must not be used by several threads at the same time.
+     */
+    class JSONCPP_API LazyDocument {
+    public:
+        LazyDocument();
+
+        LazyDocument(const LazyDocument&) = delete;
+        LazyDocument& operator=(const LazyDocument&) = delete;
+
+        /** \brief Index the document [beginDoc, endDoc), which is not copied.
+         *
+         * The document must outlive the LazyDocument, or the next call to parse().
+         * \return \c false if the structure of the document is invalid.
+         */
+        bool parse(const char* beginDoc, const char* endDoc);
+
+        /// \brief Copy and index document.
+        /// \see parse(const char*, const char*)
+        bool parse(const std::string& document);
+
+        /// Root value of the document; references nothing if the last parse() failed.
+        LazyValue root() const;
+
+        /** \brief Returns a user friendly string that list errors in the document.
+         * Contains the errors of parse(), or of the last LazyValue that failed to be decoded.
+         * The locations of decoding errors are relative to the beginning of the decoded value.
+         * An empty string is returned if no error occurred.
+         */
+        std::string getFormattedErrorMessages() const;
+
+    private:
+        friend class LazyValue;
+
+        class Node {
+        public:
+            // Offset just after the closing bracket.
+            size_t end_;
+            // Position in nodes_ of the first container following this one and its descendants.
+            size_t next_;
+
+            Node() : end_{ 0 }, next_{ 0 } {}
+        };
+
+        typedef std::vector<Node> Nodes;
+
+        bool index();
+        bool fail(const char* location, const char* message);
+        bool decode(const char* begin, const char* end, Value& value) const;
+
+        Nodes nodes_;
+        std::vector<size_t> openNodes_;
+        std::string document_;
+        mutable std::string errors_;
+        mutable Reader reader_;
+        const char* begin_;
+        const char* end_;
+        const char* root_;
+    };
+
+} // namespace Json
+
+#endif // JSONCPP_LAZY_H_INCLUDED
@@ -0,0 +1,87 @@
+#pragma once
+
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef JSONCPP_PATCH_H_INCLUDED
+#define JSONCPP_PATCH_H_INCLUDED
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include "value.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <string>
+#include <vector>
+
+namespace Json {
+
+    /** \brief Differences between Value trees, as patch documents that transform one into the other.
+     *
+     * A <a HREF="https://www.rfc-editor.org/rfc/rfc6902">JSON Patch</a> is an array of
+     * operations ("add", "remove", "replace", "move", "copy" and "test") on the values
+     * addressed by <a HREF="https://www.rfc-editor.org/rfc/rfc6901">JSON Pointers</a>.
+     * A <a HREF="https://www.rfc-editor.org/rfc/rfc7396">JSON Merge Patch</a> is shaped
+     * like the document: its members replace those of the document, and its null
+     * members remove them.
+     *
+     * Arrays and objects shared by the two trees (copies of the same Value) are skipped
+     * without being compared, and the cached hashes of the others (see Value::hash())
+     * tell apart most of those that differ.
+     *
+     * Example of usage:
+     * \code
+     * Json::Value delta = Json::Patch::diff( previous, current );
+     * ...
+     * std::string error;
+     * if ( !Json::Patch::apply( replica, delta, &error ) )
+     *    ...
+     * \endcode
+     */
+    class JSONCPP_API Patch {
+    public:
+        /** \brief JSON Patch transforming from into to.
+         *
+         * Only "add", "remove" and "replace" operations are produced. Elements inserted
+         * or removed at a single position of an array are found by skipping the equal
+         * elements at both ends, other changes replace the elements one by one.
+         * Numbers are compared by value: replacing 1 with 1.0 is not a change.
+         */
+        static Value diff(const Value& from, const Value& to);
+
+        /** \brief JSON Merge Patch transforming from into to.
+         *
+         * Merge patches cannot set a member to null: null members of the objects of to
+         * are missing from the result of applyMerge().
+         */
+        static Value mergeDiff(const Value& from, const Value& to);
+
+        /** \brief Apply the operations of the JSON Patch patch to root, in place.
+         *
+         * The operations are applied in order. If one fails, the previous ones are
+         * undone: root is unchanged. As required by RFC 6902, "test" compares numbers by
+         * value: 1, 1u and 1.0 are equal.
+         * \param error If not null, receives the description of the failed operation.
+         * \return \c false if patch is not a valid JSON Patch or an operation fails.
+         */
+        static bool apply(Value& root, const Value& patch, std::string* error = nullptr);
+
+        /// \brief Apply the JSON Merge Patch patch to root, in place.
+        static void applyMerge(Value& root, const Value& patch);
+
+    private:
+        class Applier;
+
+        static bool equals(const Value& a, const Value& b);
+        static bool equalNumbers(const Value& a, const Value& b);
+        static void diff(const Value& from, const Value& to, std::string& pointer, Value& operations);
+        static void diffObjects(const Value& from, const Value& to, std::string& pointer, Value& operations);
+        static void diffArrays(const Value& from, const Value& to, std::string& pointer, Value& operations);
+        static void addOperation(Value& operations, const char* op, const std::string& pointer, const Value* value);
+        static void insertElement(Value& array, ArrayIndex index, Value&& element);
+        static Value eraseElement(Value& array, ArrayIndex index);
+    };
+
+} // namespace Json
+
+#endif // JSONCPP_PATCH_H_INCLUDED
@@ -10,20 +10,124 @@
 
 #if !defined(JSONCPP_IS_AMALGAMATION)
 #include "features.h"
+#include "statistics.h"
 #include "value.h"
+#include "document.h"
+#include "file.h"
 #endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <condition_variable>
 #include <deque>
-#include <stack>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include <string>
 #include <iostream>
 #include <utility>
+#include <vector>
+#include <string_view>
+#include <cstddef>
 
 namespace Json {
 
+    /** \brief Receives the events of a <a HREF="http://www.json.org">JSON</a> document parsed by
+     * Reader::parse(const char*, const char*, Handler&).
+     *
+     * Events are reported in document order; no Value tree is built. Each callback
+     * returns \c true to continue parsing, or \c false to abort it, in which case
+     * Reader::parse() returns \c false. The default implementations ignore the event.
+     *
+     * Strings and member names are passed unescaped. They reference the document when
+     * they contain no escape sequence, and an internal buffer of the Reader otherwise:
+     * in both cases they are only valid until the callback returns.
+     *
+     * Example of usage:
+     * \code
+     * struct MemberCounter : Json::Handler {
+     *    int count = 0;
+     *    bool key( std::string_view ) override { ++count; return true; }
+     * };
+     * MemberCounter counter;
+     * Json::Reader reader;
+     * reader.parse( text.data(), text.data() + text.size(), counter );
+     * \endcode
+     */
+    class JSONCPP_API Handler {
+    public:
+        virtual ~Handler();
+
+        virtual bool startObject();
+        /// Name of the next member of the current object.
+        virtual bool key(std::string_view name);
+        virtual bool endObject();
+        virtual bool startArray();
+        virtual bool endArray();
+        virtual bool value(std::nullptr_t value);
+        virtual bool value(bool value);
+        /// Integers that fit in a LargestInt.
+        virtual bool value(LargestInt value);
+        /// Positive integers greater than LargestInt max.
+        virtual bool value(LargestUInt value);
+        virtual bool value(double value);
+        virtual bool value(std::string_view value);
+    };
+
+    /** \brief Policy of a Reader configured at run time, by its Features.
+     * \sa BasicReader
+     */
+    class JSONCPP_API FeaturesPolicy {
+    public:
+        static Features defaultFeatures() { return Features::all(); }
+        static bool allowComments(const Features& features) { return features.allowComments_; }
+        static bool strictRoot(const Features& features) { return features.strictRoot_; }
+    };
+
+    /** \brief Policy of a Reader that only accepts documents strictly compatible with the
+     * JSON specification, whatever its Features: comments are forbidden, and the root must
+     * be an array or an object.
+     * \sa BasicReader
+     */
+    class JSONCPP_API StrictPolicy {
+    public:
+        static Features defaultFeatures() { return Features::strictMode(); }
+        static bool allowComments([[maybe_unused]] const Features& features) { return false; }
+        static bool strictRoot([[maybe_unused]] const Features& features) { return true; }
+    };
+
+    /** \brief An error found in a document by a Reader.
+     * \sa BasicReader::getStructuredErrors()
+     */
+    class JSONCPP_API StructuredError {
+    public:
+        /// Byte offset of the beginning of the faulty text in the document.
+        size_t offsetStart_;
+        /// Byte offset just after the faulty text.
+        size_t offsetLimit_;
+        /// Line of offsetStart_, from 1.
+        int line_;
+        /// Column of offsetStart_ in its line, from 1.
+        int column_;
+        std::string message_;
+
+        StructuredError() : offsetStart_{ 0 }, offsetLimit_{ 0 }, line_{ 0 }, column_{ 0 }, message_{} {}
+    };
+
     /** \brief Unserialize a <a HREF="http://www.json.org">JSON</a> document into a Value.
      *
+     * Policy decides which syntax is accepted: its allowComments() and strictRoot()
+     * functions receive the Features of the reader. A policy whose functions return
+     * constants specializes the tokenizer and the value loop at compile time: no comment
+     * is ever tracked by BasicReader<StrictPolicy>. Other features, such as
+     * Features::internKeys_ and Features::maxDepth_, are always read at run time.
+     *
+     * Nested arrays and objects are read with an explicit stack rather than by recursion,
+     * so the depth of the document does not affect the call stack. The buffers of the
+     * reader keep their capacity from one parse to the next: a long-lived reader parses
+     * small documents without allocating, apart from the Value tree itself.
+     *
+     * BasicReader is instantiated for FeaturesPolicy, as Reader, and for StrictPolicy, as StrictReader.
      */
-    class JSONCPP_API Reader {
+    template <typename Policy>
+    class BasicReader {
     public:
         typedef char Char;
         typedef const Char* Location;
@@ -31,9 +135,12 @@ namespace Json {
         /** \brief Constructs a Reader allowing the specified feature set
          * for parsing.
          */
-        Reader(const Features& features = Features::all());
+        BasicReader(const Features& features = Policy::defaultFeatures());
 
         /** \brief Read a Value from a <a HREF="http://www.json.org">JSON</a> document.
+         *
+         * The document is read in place and is never copied; the errors remain available
+         * after it has been destroyed.
          * \param document UTF-8 encoded string containing the document to read.
          * \param root [out] Contains the root value of the document if it was
          *             successfully parsed.
@@ -46,6 +153,9 @@ namespace Json {
         bool parse(const std::string& document, Value& root, bool collectComments = true);
 
         /** \brief Read a Value from a <a HREF="http://www.json.org">JSON</a> document.
+         *
+         * The document is read in place and is never copied. The errors are located
+         * before parse() returns: the document may be destroyed before they are read.
          * \param beginDoc Pointer on the beginning of the UTF-8 encoded string of the document to read.
          * \param endDoc Pointer on the end of the UTF-8 encoded string of the document to read.
          \               Must be >= beginDoc.
@@ -59,7 +169,58 @@ namespace Json {
          */
         bool parse(const char* beginDoc, const char* endDoc, Value& root, bool collectComments = true);
 
+        /** \brief Read a Value from a mutable <a HREF="http://www.json.org">JSON</a> document, without copying it.
+         *
+         * Like parse(const char*, const char*, Value&, bool), but string values that contain
+         * no escape sequence are not duplicated: the Value references the document (as with
+         * StaticString), and the closing quote of the string is overwritten by a '\\0'.
+         * The document must outlive root, and every Value referencing it.
+         * Copies of such a Value duplicate the string.
+         */
+        bool parseInSitu(char* beginDoc, char* endDoc, Value& root, bool collectComments = true);
+
+        /** \brief Read a Value from a <a HREF="http://www.json.org">JSON</a> document into doc.
+         *
+         * doc is cleared first. All the arrays, objects, member names and strings of
+         * the resulting tree are allocated in the arena of doc.
+         * \param document UTF-8 encoded string containing the document to read.
+         * \param doc [out] Contains the root value of the document if it was
+         *            successfully parsed.
+         * \param collectComments See parse(const std::string&, Value&, bool).
+         * \return \c true if the document was successfully parsed, \c false if an error occurred.
+         */
+        bool parse(const std::string& document, Document& doc, bool collectComments = true);
+
+        /// \brief Read a Value from [beginDoc, endDoc) into the arena of doc.
+        /// \see parse(const std::string&, Document&, bool)
+        bool parse(const char* beginDoc, const char* endDoc, Document& doc, bool collectComments = true);
+
+        /** \brief Read a <a HREF="http://www.json.org">JSON</a> document, reporting its content to handler.
+         *
+         * The document is read in place and is never copied; comments are skipped.
+         * \param beginDoc Pointer on the beginning of the UTF-8 encoded string of the document to read.
+         * \param endDoc Pointer on the end of the UTF-8 encoded string of the document to read.
+         * \param handler Receives the values of the document in order.
+         * \return \c true if the document was successfully parsed, \c false if an error occurred
+         *         or if handler aborted the parse.
+         */
+        bool parse(const char* beginDoc, const char* endDoc, Handler& handler);
+
+        /** \brief Read a Value from the <a HREF="http://www.json.org">JSON</a> file at path.
+         *
+         * The file is memory-mapped (see MappedFile) and parsed in place, so that its content
+         * is never copied. It is unmapped before parseFile() returns: the Values hold copies
+         * of their strings, and the errors are located while it is mapped.
+         * \return \c false if the file cannot be read, or if an error occurred while parsing it.
+         */
+        bool parseFile(const std::string& path, Value& root, bool collectComments = true);
+
+        /// \brief Read a Value from the file at path into the arena of doc.
+        /// \see parseFile(const std::string&, Value&, bool), parse(const std::string&, Document&, bool)
+        bool parseFile(const std::string& path, Document& doc, bool collectComments = true);
+
         /// \brief Parse from input stream.
+        /// The stream is read to the end into an internal buffer, which is then parsed in place.
         /// \see Json::operator>>(std::istream&, Json::Value&).
         bool parse(std::istream& is, Value& root, bool collectComments = true);
 
@@ -79,6 +240,17 @@ namespace Json {
          */
         std::string getFormattedErrorMessages() const;
 
+        /** \brief Returns the errors of the parsed document, with their byte offsets.
+         * The lines and columns of all the errors are computed by a single scan of the document,
+         * when the parse fails: the document need not be available any more.
+         * \return An empty vector if no error occurred during parsing.
+         */
+        std::vector<StructuredError> getStructuredErrors() const;
+
+        /// \brief Statistics of the last parse.
+        /// All 0 unless the library is built with JSONCPP_ENABLE_STATISTICS.
+        const Statistics& getStatistics() const;
+
     private:
         enum TokenType {
             tokenEndOfStream = 0,
@@ -102,9 +274,11 @@ namespace Json {
             TokenType type_;
             Location start_;
             Location end_;
+            // tokenString only: true if the string contains an escape sequence.
+            bool escaped_;
 
-            Token() : type_{}, start_{ nullptr }, end_{ nullptr } {}
-            Token(TokenType type, Location start, Location end) : type_{ type }, start_{ start }, end_{ end } {}
+            Token() : type_{}, start_{ nullptr }, end_{ nullptr }, escaped_{ false } {}
+            Token(TokenType type, Location start, Location end) : type_{ type }, start_{ start }, end_{ end }, escaped_{ false } {}
         };
 
         class ErrorInfo {
@@ -112,14 +286,39 @@ namespace Json {
             Token token_;
             std::string message_;
             Location extra_;
+            // Set by locateErrors(), which is called before the document may be released.
+            size_t offsetStart_;
+            size_t offsetLimit_;
+            std::pair<int, int> lineColumn_;
+            std::pair<int, int> extraLineColumn_;
 
-            ErrorInfo() : token_{}, message_{}, extra_{ nullptr } {}
-            ErrorInfo(Token token, std::string&& message, Location extra) : token_{ token }, message_{ std::move(message) }, extra_{ extra } {}
-            ErrorInfo(Token token, const std::string& message, Location extra) : token_{ token }, message_{ message }, extra_{ extra } {}
+            ErrorInfo() : token_{}, message_{}, extra_{ nullptr }, offsetStart_{ 0 }, offsetLimit_{ 0 }, lineColumn_{}, extraLineColumn_{} {}
+            ErrorInfo(Token token, std::string&& message, Location extra) :
+                token_{ token }, message_{ std::move(message) }, extra_{ extra }, offsetStart_{ 0 }, offsetLimit_{ 0 }, lineColumn_{}, extraLineColumn_{} {}
+            ErrorInfo(Token token, const std::string& message, Location extra) :
+                token_{ token }, message_{ message }, extra_{ extra }, offsetStart_{ 0 }, offsetLimit_{ 0 }, lineColumn_{}, extraLineColumn_{} {}
         };
 
-        typedef std::deque<ErrorInfo> Errors;
+        typedef std::vector<ErrorInfo> Errors;
 
+        // State in which a suspended parse expects its next token.
+        enum ResumeState {
+            resumeValue = 0,   // a value
+            resumeFirstMember, // a member name or '}', after '{'
+            resumeMember,      // a member name, after ','
+            resumeColon,       // ':', after pendingName_
+            resumeFirstItem,   // a value or ']', after '['
+            resumeSeparator    // ',' or the closing token of the container, after a value
+        };
+
+        class ValueBuilder;
+        friend class ValueBuilder;
+        // Parses its documents as their chunks arrive, with startDocument() and resumeDocument().
+        friend class IncrementalReader;
+
+        bool openFile(MappedFile& file, const std::string& path);
+        bool readDocument(const char* beginDoc, const char* endDoc, Value& root, bool collectComments);
+        bool readDocument(const char* beginDoc, const char* endDoc, Handler& handler);
         bool expectToken(TokenType type, Token& token, const char* message);
         bool readToken(Token& token);
         void skipSpaces();
@@ -127,29 +326,43 @@ namespace Json {
         bool readComment();
         bool readCStyleComment();
         bool readCppStyleComment();
-        bool readString();
+        bool readString(bool& escaped);
+        bool readUtf8String(bool& escaped);
         void readNumber();
-        bool readValue();
-        bool readObject(Token& token);
-        bool readArray(Token& token);
+        bool readValue(Token& token, bool complete = false);
+        bool readMember(Token& token);
+        bool readMemberValue(std::string_view name, Token& token);
+        bool enterContainer(Token& token, TokenType closingType);
+        bool leaveContainer(Token& token);
+        bool unwind();
         bool decodeNumber(Token& token);
-        bool decodeString(Token& token);
+        bool decodeString(Token& token, std::string_view& decoded);
         bool decodeString(Token& token, std::string& decoded);
         bool decodeDouble(Token& token);
         bool decodeUnicodeCodePoint(Token& token, Location& current, Location end, unsigned int& unicode);
         bool decodeUnicodeEscapeSequence(Token& token, Location& current, Location end, unsigned int& unicode);
         bool addError(const std::string& message, Token& token, Location extra = 0);
         bool recoverFromError(TokenType skipUntilToken);
-        bool addErrorAndRecover(const std::string& message, Token& token, TokenType skipUntilToken);
-        Value& currentValue();
+        bool checkHandler(bool accepted, Token& token);
+        bool collectingComments() const { return Policy::allowComments(features_) && collectComments_; }
         Char getNextChar();
-        void getLocationLineAndColumn(Location location, int& line, int& column) const;
-        std::string getLocationLineAndColumn(Location location) const;
+        void locateErrors();
         void addComment(Location begin, Location end, CommentPlacement placement);
         void skipCommentTokens(Token& token);
+        bool nextToken(Token& token, ResumeState state);
+        bool truncated(const Token& token) const;
+        bool suspend(Location location, ResumeState state);
+        bool resume();
+        void startDocument();
+        bool resumeDocument(Location beginDoc, Location current, Location endDoc, Value& root, bool last);
 
-        typedef std::stack<Value*> Nodes;
+        typedef std::vector<Value*> Nodes;
+        // Arrays and objects being filled by ValueBuilder.
         Nodes nodes_;
+        // Member of nodes_.back() receiving the next value, if it is an object.
+        Value* member_;
+        // Closing token of each array and object being read, innermost last.
+        std::vector<TokenType> containers_;
         Errors errors_;
         std::string document_;
         Location begin_;
@@ -159,7 +372,293 @@ namespace Json {
         Value* lastValue_;
         std::string commentsBefore_;
         Features features_;
+        // Member names interned if features_.internKeys_.
+        KeyTable keys_;
+        // Non null while parsing into a Document.
+        Arena* arena_;
+        Handler* handler_;
+        // Unescaped string passed to handler_.
+        std::string stringBuffer_;
+        // Opening quote of the last string that is not valid UTF-8, if features_.strictUtf8_.
+        Location invalidString_;
+        Statistics statistics_;
         bool collectComments_;
+        // Strings may reference the (mutable) document.
+        bool inSitu_;
+        // Member name read before a parse suspended in resumeColon.
+        std::string pendingName_;
+        ResumeState resumeState_;
+        // The document may continue past end_: a token reaching it suspends the parse.
+        bool streaming_;
+        // The last parse was suspended rather than failed.
+        bool suspended_;
+    };
+
+    extern template class BasicReader<FeaturesPolicy>;
+    extern template class BasicReader<StrictPolicy>;
+
+    /** \brief Unserialize a <a HREF="http://www.json.org">JSON</a> document into a Value,
+     * accepting the syntax allowed by its Features.
+     */
+    class JSONCPP_API Reader : public BasicReader<FeaturesPolicy> {
+    public:
+        Reader(const Features& features = Features::all()) : BasicReader{ features } {}
+    };
+
+    /// Reader of strict JSON documents, specialized at compile time. \sa StrictPolicy
+    typedef BasicReader<StrictPolicy> StrictReader;
+
+    /** \brief Push-style reader for documents received in arbitrary chunks.
+     *
+     * Bytes are fed as they arrive, for example from a socket. A document may be
+     * split anywhere, including in the middle of a string or a number. Each chunk
+     * is parsed as soon as it is fed: the value loop of Reader is suspended at the
+     * end of the input, with its nesting and the Value tree built so far, and
+     * resumed on the next chunk. A complete top-level value can be retrieved with
+     * next(). Only the token that straddles the end of the input is buffered, so a
+     * single large document, as well as a stream of concatenated or newline-delimited
+     * documents, is read with bounded memory besides its Value tree. A document nested
+     * deeper than Features::maxDepth_ is rejected as soon as its opening brackets
+     * exceed the limit.
+     *
+     * Example of usage:
+     * \code
+     * Json::IncrementalReader reader;
+     * char buffer[4096];
+     * while ( size_t n = fread( buffer, 1, sizeof(buffer), file ) ) {
+     *    if ( !reader.feed( buffer, n ) )
+     *       break;
+     *    Json::Value record;
+     *    while ( reader.next( record ) )
+     *       handle( record );
+     * }
+     * reader.finish();
+     * \endcode
+     *
+     * A token split across chunks is scanned for its end as its bytes arrive, and
+     * only read by Reader once complete, so that each byte is read a bounded number
+     * of times however the input is split. The documents are validated as by
+     * Reader::parse(), and their errors located from their beginning.
+     *
+     * Comments found between two top-level values are discarded. Reading stops at
+     * the first invalid document: feed() and finish() return \c false until reset().
+     */
+    class JSONCPP_API IncrementalReader {
+    public:
+        IncrementalReader(const Features& features = Features::all());
+
+        /// \brief Append length bytes of input, and parse them.
+        /// \return \c false if a document was invalid.
+        bool feed(const char* data, size_t length);
+
+        /// \brief Signal the end of the input.
+        /// A top-level number or literal still pending (not followed by a space) is parsed.
+        /// \return \c false if a document was invalid or is incomplete.
+        bool finish();
+
+        /// \brief Pop the next complete document, in input order.
+        /// \return \c false if no complete document is available.
+        bool next(Value& root);
+
+        /// Discard all the state, buffered input and pending documents.
+        void reset();
+
+        /** \brief Returns a user friendly string describing the error that stopped the reader.
+         * Locations are relative to the beginning of the invalid document.
+         * An empty string is returned if no error occurred.
+         */
+        std::string getFormattedErrorMessages() const;
+
+    private:
+        enum ScanState {
+            scanSpace = 0,
+            scanString,
+            scanStringEscape,
+            scanToken,
+            scanCommentStart,
+            scanCStyleComment,
+            scanCStyleCommentEnd,
+            scanCppStyleComment,
+            scanResume
+        };
+
+        typedef std::deque<Value> Values;
+
+        bool scan();
+        bool startDocument(size_t begin);
+        bool parse(bool last);
+        bool fail(const std::string& message);
+
+        Reader reader_;
+        Values values_;
+        // Document being received, filled by reader_.
+        Value root_;
+        std::string buffer_;
+        std::string errors_;
+        size_t scanned_;
+        // Offset of the document being received, or of the input following the last one.
+        size_t documentBegin_;
+        // Offset of the token on which reader_ is suspended.
+        size_t parsed_;
+        // Length of buffer_ when reader_ was last resumed.
+        size_t resumed_;
+        // Lines, and columns of the last line, of the beginning of the document that was dropped from buffer_.
+        int discardedLines_;
+        int discardedColumns_;
+        ScanState state_;
+        bool allowComments_;
+        bool inDocument_;
+        bool failed_;
+    };
+
+    /** \brief Parses batches of newline-delimited documents (NDJSON) on several threads.
+     *
+     * Each line of the input is a document; blank lines are skipped. The input is
+     * split at line boundaries into one range per worker thread, and each worker
+     * parses its lines with its own Reader. The records are returned in input
+     * order, whether they were parsed successfully or not.
+     *
+     * The worker threads are started by the first batch that needs them, then wait
+     * for the next batches until the BatchReader is destroyed.
+     *
+     * Example of usage:
+     * \code
+     * Json::BatchReader reader;
+     * Json::BatchReader::Records records;
+     * reader.parse( text.data(), text.data() + text.size(), records );
+     * for ( const auto &record : records )
+     *    if ( record.errors_.empty() )
+     *       process( record.root_ );
+     * \endcode
+     *
+     * A BatchReader must not be used by several threads at the same time.
+     */
+    class JSONCPP_API BatchReader {
+    public:
+        /// A document of the batch.
+        class Record {
+        public:
+            /// Parsed document; null if it is invalid.
+            Value root_;
+            /// Formatted errors, relative to the beginning of the line; empty if the document is valid.
+            std::string errors_;
+            /// Offset of the line in the batch.
+            size_t offset_;
+
+            Record() : root_{}, errors_{}, offset_{ 0 } {}
+        };
+
+        typedef std::vector<Record> Records;
+
+        /** \param features Features of the Reader of each worker.
+         * \param threadCount Maximum number of threads parsing a batch, including the
+         *        calling thread. 0 to use one thread per hardware thread.
+         */
+        BatchReader(const Features& features = Features::all(), unsigned int threadCount = 0);
+
+        /// Stops the worker threads.
+        ~BatchReader();
+
+        BatchReader(const BatchReader&) = delete;
+        BatchReader& operator=(const BatchReader&) = delete;
+
+        /** \brief Parse the lines of [beginDoc, endDoc) into records.
+         *
+         * records is cleared first. Batches smaller than a few tens of kilobytes per
+         * thread use fewer threads.
+         * \return \c true if all the documents are valid.
+         */
+        bool parse(const char* beginDoc, const char* endDoc, Records& records);
+
+        /// \brief Parse the lines of document into records.
+        /// \see parse(const char*, const char*, Records&)
+        bool parse(const std::string& document, Records& records);
+
+    private:
+        typedef std::vector<Reader> Readers;
+
+        void parseRange(size_t index);
+        void work(size_t index, size_t generation);
+        static void parseLines(Reader& reader, const char* batchBegin, const char* begin, const char* end, Records& records);
+
+        Readers readers_;
+        // Range index of the batch is [bounds_[index], bounds_[index + 1]), parsed by
+        // readers_[index] into ranges_[index]: by the calling thread for range 0, and
+        // by workers_[index - 1] for the others.
+        const char* batchBegin_;
+        std::vector<const char*> bounds_;
+        std::vector<Records> ranges_;
+        std::vector<std::exception_ptr> exceptions_;
+        std::vector<std::thread> workers_;
+        // Incremented by each batch parsed on several threads, with its rangeCount_.
+        size_t generation_;
+        size_t rangeCount_;
+        // Ranges of the batch that the workers have not parsed yet.
+        size_t pending_;
+        bool stopping_;
+        std::mutex mutex_;
+        std::condition_variable start_;
+        std::condition_variable done_;
+    };
+
+    /** \brief Unserialize a <a HREF="https://www.rfc-editor.org/rfc/rfc8949">CBOR</a> document into a Value.
+     *
+     * Reads the documents produced by BinaryWriter, and the CBOR data items that
+     * map to the JSON data model:
+     * - integers are read as intValue or uintValue like Reader does, and negative
+     *   integers below the LargestInt range as realValue,
+     * - half, single and double precision floats are read as realValue,
+     * - text and byte strings, of definite or indefinite length, are read as stringValue,
+     * - arrays and maps, of definite or indefinite length, are read as arrayValue and
+     *   objectValue; map keys must be text strings,
+     * - tags are ignored and undefined is read as null.
+     *
+     * Documents that nest arrays and maps deeper than the maximum depth are rejected.
+     *
+     * \sa BinaryWriter
+     */
+    class JSONCPP_API BinaryReader {
+    public:
+        /// \param maxDepth Maximum nesting of arrays and maps, like Features::maxDepth_.
+        explicit BinaryReader(unsigned int maxDepth = 1000);
+
+        /** \brief Read a Value from the CBOR document [beginDoc, endDoc).
+         * \param root [out] Contains the root value of the document if it was
+         *             successfully parsed.
+         * \return \c true if the document was successfully parsed, \c false if an error occurred.
+         */
+        bool parse(const char* beginDoc, const char* endDoc, Value& root);
+
+        /// \brief Read a Value from the CBOR document held in document.
+        /// \see parse(const char*, const char*, Value&)
+        bool parse(const std::string& document, Value& root);
+
+        /** \brief Returns a user friendly string describing the error met in the parsed document.
+         * \return The error message with the offset of the invalid byte, or an empty string
+         *         if no error occurred during parsing.
+         */
+        std::string getFormattedErrorMessages() const;
+
+    private:
+        typedef const unsigned char* Location;
+
+        bool readValue(Value& value);
+        bool readHead(unsigned int& major, unsigned int& info, UInt64& argument);
+        bool readString(unsigned int major, unsigned int info, UInt64 length, std::string_view& str);
+        bool readArray(unsigned int info, UInt64 size, Value& value);
+        bool readObject(unsigned int info, UInt64 size, Value& value);
+        bool readBreak();
+        bool addError(const std::string& message, Location location);
+
+        std::string errors_;
+        // Chunks of an indefinite-length string or member name.
+        std::string stringBuffer_;
+        Location begin_;
+        Location end_;
+        Location current_;
+        // Arrays and maps being read.
+        unsigned int depth_;
+        unsigned int maxDepth_;
     };
 
     /** \brief Read from 'sin' into 'root'.
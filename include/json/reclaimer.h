@@ -0,0 +1,99 @@
+#pragma once
+
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef JSONCPP_RECLAIMER_H_INCLUDED
+#define JSONCPP_RECLAIMER_H_INCLUDED
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include "document.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Json {
+
+    /** \brief Destroys Value trees and Documents on a background thread.
+     *
+     * Destroying a large tree frees each of its nodes, strings and member names.
+     * reclaim() moves the tree to a bounded backlog instead, emptied by the thread of
+     * the Reclaimer, and returns at once. When the backlog is full, the tree is destroyed
+     * by the calling thread: trees are never reclaimed slower than they are discarded.
+     *
+     * Values that do not own a tree are destroyed at once, as it costs less than a
+     * thread switch: scalars, strings, arrays and objects shared with other Values (only
+     * a reference is released), and trees built in an Arena, which are released with it.
+     * A Document is released in bulk by the thread, like its destructor does.
+     *
+     * A Reclaimer can be used by several threads at the same time.
+     *
+     * Example of usage:
+     * \code
+     * static Json::Reclaimer reclaimer;
+     * ...
+     * send( writer.write( response ) );
+     * reclaimer.reclaim( std::move( response ) );
+     * \endcode
+     */
+    class JSONCPP_API Reclaimer {
+    public:
+        /// \param capacity Maximum number of trees waiting to be destroyed. With 0, no
+        ///        thread is started and all the trees are destroyed by reclaim().
+        explicit Reclaimer(size_t capacity = 64);
+
+        /// Destroys the trees that are waiting, then stops the thread.
+        ~Reclaimer();
+
+        Reclaimer(const Reclaimer&) = delete;
+        Reclaimer& operator=(const Reclaimer&) = delete;
+
+        /** \brief Destroy value, in the background if it owns a tree. value is left null.
+         * \return \c true if the destruction is deferred, \c false if value was destroyed
+         *         by the calling thread.
+         */
+        bool reclaim(Value&& value);
+
+        /** \brief Destroy document, and release its arena, in the background.
+         * \return \c true if the destruction is deferred, \c false if document was
+         *         destroyed by the calling thread.
+         */
+        bool reclaim(std::unique_ptr<Document> document);
+
+        /// Wait until the trees reclaimed so far are destroyed.
+        void flush();
+
+    private:
+        class Garbage {
+        public:
+            Value value_;
+            std::unique_ptr<Document> document_;
+
+            Garbage() : value_{}, document_{} {}
+        };
+
+        bool defer(Value& value, std::unique_ptr<Document>& document);
+        void run();
+
+        // Ring of capacity slots: the count_ slots from head_ are waiting.
+        std::vector<Garbage> backlog_;
+        size_t head_;
+        size_t count_;
+        // True while the thread destroys a tree taken from the backlog.
+        bool busy_;
+        bool stopping_;
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::condition_variable idle_;
+        std::thread thread_;
+    };
+
+} // namespace Json
+
+#endif // JSONCPP_RECLAIMER_H_INCLUDED
@@ -0,0 +1,88 @@
+#pragma once
+
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef JSONCPP_STATISTICS_H_INCLUDED
+#define JSONCPP_STATISTICS_H_INCLUDED
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include "config.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <cstddef>
+
+namespace Json {
+
+    /** \brief Measures of a single parse or write.
+     *
+     * Statistics are only collected if the library is built with JSONCPP_ENABLE_STATISTICS
+     * defined (see config.h). Otherwise all the members stay 0 and collecting them costs nothing.
+     *
+     * \sa Reader::getStatistics(), Writer::getStatistics(), setStatisticsListener()
+     */
+    class JSONCPP_API Statistics {
+    public:
+        enum Phase {
+            phaseParse = 0, ///< Measured by Reader
+            phaseWrite      ///< Measured by a writer
+        };
+
+        Statistics();
+
+        /// Reset all the measures for a new operation of the given phase.
+        void reset(Phase phase);
+
+        /// \name Nesting tracking, used while the operation runs.
+        /// @{
+        void enterContainer() {
+            if (++depth_ > maxDepth_)
+                maxDepth_ = depth_;
+        }
+        void leaveContainer() { --depth_; }
+        /// @}
+
+        Phase phase_;
+        /// Bytes of the document read, or written.
+        size_t bytes_;
+        /// Tokens read, including comments. Only counted by Reader.
+        size_t tokens_;
+        /// Values read or written, including arrays and objects.
+        size_t nodes_;
+        /// Deepest nesting of arrays and objects.
+        unsigned int maxDepth_;
+        /// Bytes of the unescaped strings and member names.
+        size_t stringBytes_;
+        /// Heap blocks allocated for Value trees (strings, arrays, objects and their
+        /// elements) by the thread during the operation.
+        size_t allocations_;
+        /// Duration of the operation.
+        UInt64 nanoseconds_;
+
+    private:
+        unsigned int depth_;
+    };
+
+    /** \brief Receives the Statistics of every parse and write.
+     * \sa setStatisticsListener()
+     */
+    class JSONCPP_API StatisticsListener {
+    public:
+        virtual ~StatisticsListener();
+
+        /// Called on the thread that performed the operation, once it is complete.
+        virtual void record(const Statistics& statistics) = 0;
+    };
+
+    /** \brief Registers the listener that receives the Statistics of all Reader and writer operations.
+     *
+     * The listener is not owned, and may be called concurrently by several threads.
+     * Pass nullptr to unregister it. Statistics are only reported if the library is
+     * built with JSONCPP_ENABLE_STATISTICS defined.
+     */
+    void JSONCPP_API setStatisticsListener(StatisticsListener* listener);
+
+} // namespace Json
+
+#endif // JSONCPP_STATISTICS_H_INCLUDED
@@ -14,10 +14,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <memory_resource>
 #include <limits>
 #include <cstdint>
 #include <string_view>
 #include <utility>
+#include <cstring>
+#include <functional>
 
 #ifdef JSONCPP_ENABLE_ASSERTS
 #define JSONCPP_ASSERT_UNREACHABLE assert(false)
@@ -73,7 +77,10 @@ namespace Json {
      */
     class JSONCPP_API StaticString {
     public:
-        explicit StaticString(const char* czstring) : str_(czstring) {}
+        explicit StaticString(const char* czstring) : str_(czstring), length_(strlen(czstring)) {}
+        /// \param length Number of characters of str, which may contain '\\0'.
+        /// \pre str[length] is '\\0'.
+        StaticString(const char* str, size_t length) : str_(str), length_(length) {}
 
         operator const char*() const {
             return str_;
@@ -83,8 +90,13 @@ namespace Json {
             return str_;
         }
 
+        size_t length() const {
+            return length_;
+        }
+
     private:
         const char* str_;
+        size_t length_;
     };
 
     /** \brief Represents a <a HREF="http://www.json.org">JSON</a> value.
@@ -113,9 +125,25 @@ namespace Json {
      *
      * It is possible to iterate over the list of a #objectValue values using
      * the getMemberNames() method.
+     *
+     * Copying a Value takes constant time: the copy shares the strings, arrays and
+     * objects of the original, which are reference counted. A shared array or object
+     * is copied, one level at a time, when it is first accessed through a non const
+     * method (operator[](), append(), removeMember(), resize(), non const iterators...).
+     * Values that share data can be used by different threads at the same time.
+     * Once references or iterators to its elements were obtained through non const
+     * methods, an array or object is copied by each copy of its Value instead of being
+     * shared, so that writing through them only modifies the original. seal() lets
+     * the copies share it again, once the tree is built.
      */
     class JSONCPP_API Value {
         friend class ValueIteratorBase;
+        friend class KeyTable;
+        friend class Patch;
+        friend class Reclaimer;
+        template <typename Policy>
+        friend class BasicReader;
+        friend class BinaryReader;
 #ifdef JSONCPP_VALUE_USE_INTERNAL_MAP
         friend class ValueInternalLink;
         friend class ValueInternalMap;
@@ -162,11 +190,13 @@ namespace Json {
         public:
             enum DuplicationPolicy {
                 noDuplication = 0,
-                duplicate,
-                duplicateOnCopy
+                duplicate,       // reference counted copy, shared by the copies of the name
+                duplicateOnCopy, // duplicated by the first copy of the name
+                interned         // reference counted string of a KeyTable
             };
             CZString(ArrayIndex index);
             CZString(const char* cstr, DuplicationPolicy allocate);
+            CZString(const char* cstr, size_t length, DuplicationPolicy allocate);
             CZString(const CZString& other);
             explicit CZString(std::string_view str);
             ~CZString();
@@ -180,8 +210,11 @@ namespace Json {
 
         private:
             void swap(CZString& other);
+            std::string_view view() const;
             const char* cstr_;
             ArrayIndex index_;
+            // Fits in the padding after index_: sizeof(CZString) is unchanged.
+            unsigned int length_;
         };
 
         struct CZStringCompare {
@@ -192,11 +225,11 @@ namespace Json {
             }
 
             bool operator()(const char* lhs, const CZString& rhs) const {
-                return rhs.c_str() ? strcmp(lhs, rhs.c_str()) < 0 : false;
+                return rhs.c_str() ? std::string_view{ lhs } < std::string_view{ rhs.c_str(), rhs.length() } : false;
             }
 
             bool operator()(const CZString& lhs, const char* rhs) const {
-                return lhs.c_str() ? strcmp(lhs.c_str(), rhs) < 0 : false;
+                return lhs.c_str() ? std::string_view{ lhs.c_str(), lhs.length() } < std::string_view{ rhs } : false;
             }
 
             bool operator()(const std::string_view lhs, const CZString& rhs) const {
@@ -209,7 +242,12 @@ namespace Json {
         };
 
     public:
-        typedef std::map<CZString, Value, CZStringCompare> ObjectValues;
+        // Containers use a polymorphic allocator so that a Value tree can be
+        // built inside an Arena. Values not built in an Arena use the default
+        // memory resource (new/delete). The members of large objects are also
+        // indexed by the hash of their names, beside the map.
+        typedef std::pmr::map<CZString, Value, CZStringCompare> ObjectValues;
+        typedef std::pmr::vector<Value> ArrayValues;
 #endif // ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
 
     public:
@@ -251,6 +289,22 @@ namespace Json {
         Value(std::string_view value);
         Value(const std::string& value);
         Value(bool value);
+        /** \brief Create an empty array or object whose storage is allocated in arena.
+         *
+         * Members and elements subsequently inserted in the container, and the
+         * member names, are also allocated in the arena. The container is not
+         * destroyed with the Value: its memory is reclaimed when the arena is
+         * released, so the Value must not outlive the arena.
+         * For other types, equivalent to Value(type).
+         * \sa Document
+         */
+        Value(ValueType type, Arena& arena);
+        /** \brief Create a string value whose characters are copied into arena.
+         *
+         * The Value must not outlive the arena. Copying the Value duplicates
+         * the string on the heap.
+         */
+        Value(std::string_view value, Arena& arena);
         Value(const Value& other);
         Value(Value&& other) noexcept;
 
@@ -267,6 +321,17 @@ namespace Json {
         /// both logic and efficiency.
         void swap(Value& other);
 
+        /** \brief Let the copies of this value share its arrays and objects again.
+         *
+         * The non const methods that return references or iterators to elements
+         * (operator[](), append(), tryGet(), non const iterators, Path::find()...) pin
+         * the arrays and objects they go through: copies of the Value copy them instead
+         * of sharing them, and their hashes are not cached. Call seal() once the tree is
+         * built, or modified: the references and iterators obtained before must then no
+         * longer be used to modify it. Trees read by a Reader are already sealed.
+         */
+        void seal();
+
         ValueType type() const;
 
         bool operator<(const Value& other) const;
@@ -279,7 +344,27 @@ namespace Json {
 
         int compare(const Value& other) const;
 
+        /** \brief Structural hash: equal values have equal hashes.
+         *
+         * Numbers that are equal have equal hashes whatever their type: 1, 1u and 1.0
+         * hash alike, as Patch compares numbers by value.
+         * The hash of an array or object is computed once, then cached in the container
+         * until the container is modified. operator==() tells apart the containers whose
+         * cached hashes differ without comparing their elements.
+         * It is not cached once references to its elements, or to the elements of its
+         * descendants, were obtained through non const methods, until seal() is called.
+         */
+        size_t hash() const;
+
+        /// \c true if hash() returns without visiting the elements: the value is not an
+        /// array or an object, or its hash is cached.
+        bool hasCachedHash() const;
+
         const char* asCString() const;
+        /** \brief Get the characters of a string value, which may contain '\\0'.
+         * \return \c false if the value is not a string.
+         */
+        bool getString(const char** begin, const char** end) const;
         std::string asString(const std::string& defaultValue = "") const;
         Int asInt(Value::Int defaultValue = 0) const;
         UInt asUInt(Value::UInt defaultValue = 0) const;
@@ -326,12 +411,31 @@ namespace Json {
         /// \post type() is arrayValue
         void resize(ArrayIndex size);
 
+        /// Reserve storage for at least size array elements.
+        /// Does not change size(). Members of objects are allocated one by one,
+        /// so this does nothing for an objectValue.
+        /// \pre type() is arrayValue, objectValue or nullValue
+        /// \post type() is arrayValue or objectValue
+        void reserve(ArrayIndex size);
+
         /// Return true if index < size().
         bool isValidIndex(ArrayIndex index) const;
         /// \brief Append value to array at the end.
         ///
         /// Equivalent to jsonvalue[jsonvalue.size()] = value;
+        /// Amortized constant time.
         Value& append(const Value& value);
+        /// \brief Move value to the end of the array, without copying it.
+        Value& append(Value&& value);
+
+        /// \brief Construct a Value from args at the end of the array.
+        /// \pre type() is arrayValue or nullValue
+        template <typename... Args>
+        Value& emplace_back(Args&&... args) {
+            Value& element = arrayValues().emplace_back(std::forward<Args>(args)...);
+            pin();
+            return element;
+        }
 
         Value& get(ArrayIndex index);
         const Value& get(ArrayIndex index) const;
@@ -369,6 +473,18 @@ namespace Json {
         /// \post type() is unchanged
         Value removeMember(std::string_view key);
 
+        /// \brief Remove the named member, and move it to *removed if removed is not null.
+        /// \return \c true if the member existed.
+        /// \pre type() is objectValue or nullValue
+        bool removeMember(std::string_view key, Value* removed);
+
+        /// \brief Set the member named key to value, creating it if needed.
+        /// \return The member.
+        /// \pre type() is objectValue or nullValue
+        Value& insert(std::string_view key, const Value& value);
+        /// \brief Move value to the member named key, creating it if needed.
+        Value& insert(std::string_view key, Value&& value);
+
         /// Return true if the object has a member named key.
         bool isMember(std::string_view key) const;
         bool isMember(const CZString& key) const;
@@ -393,6 +509,9 @@ namespace Json {
 
     private:
         Value& resolveReference(const char* key, bool isStatic);
+        // Array storage, after converting a null value to an empty array.
+        ArrayValues& arrayValues();
+        std::pmr::memory_resource* arenaResource() const;
 
         // struct MemberNamesTransform
         //{
@@ -403,25 +522,105 @@ namespace Json {
         //    }
         // };
 
+        std::string_view stringView() const;
+        void initString(const char* value, size_t length);
+        // Copy the array or object if it is shared, and forget its cached hash,
+        // before it is modified.
+        void detach();
+        // detach(), and pin the array or object before references to its elements are
+        // handed out: copies of the Value copy it, and its hash is not cached.
+        void pin();
+        // For readers, once they built the container: they keep no reference to it.
+        void unpin();
+        // Hash cached in the array or object, or 0 if it is not computed.
+        size_t cachedHash() const;
+        // True if the array or object is shared with other: the values are equal.
+        bool sharesContainer(const Value& other) const;
+        // True if the array or object is allocated on the heap and referenced by this
+        // Value only: destroying the Value frees the tree.
+        bool ownsContainer() const;
+
+        enum {
+            /// Strings up to this length are stored in the Value itself.
+            shortStringCapacity = 11,
+            /// Value of shortLength_ for strings not stored in the Value.
+            notShortString = 0xFF
+        };
+
+        // Packed so that string_ is 12 bytes: value_, type_, allocated_ and
+        // shortLength_ fit in 16 bytes, the size of Value without SSO.
+#pragma pack(push, 4)
         union ValueHolder {
             LargestInt int_;
             LargestUInt uint_;
             double real_;
             bool bool_;
-            char* string_;
+            struct {
+                char* data_;
+                unsigned int length_;
+            } string_;
+            char shortString_[shortStringCapacity + 1]; // zero-terminated
+            ArrayValues* array_;
             ObjectValues* map_;
-        } value_;
+        };
+#pragma pack(pop)
+
+        alignas(8) ValueHolder value_;
         ValueType type_;
+        // For strings and containers: the payload is owned by this Value and
+        // must be released by its destructor.
         bool allocated_; // Notes: if declared as bool, bitfield is useless.
+        // For strings: length of value_.shortString_, or notShortString.
+        unsigned char shortLength_;
+    };
+
+    /** \brief Set of interned member names, shared by the objects that use them.
+     *
+     * Each distinct name is stored once, in a reference counted string: members
+     * created through the table do not allocate their name, and copying such a
+     * member only increments the count. Names remain valid for as long as an
+     * object uses them, even after the table is cleared or destroyed.
+     *
+     * A KeyTable must not be used by several threads at the same time. The
+     * Values created through it may be used independently by different threads.
+     * \sa Features::internKeys_
+     */
+    class JSONCPP_API KeyTable {
+    public:
+        KeyTable();
+        /// The copy shares the interned names of other.
+        KeyTable(const KeyTable& other);
+        ~KeyTable();
+
+        KeyTable& operator=(const KeyTable& other);
+
+        /// \brief Access the member named name of object, creating it with an interned name if needed.
+        /// \pre object.type() is objectValue or nullValue.
+        Value& resolve(Value& object, std::string_view name);
+
+        /// Number of distinct names in the table.
+        size_t size() const;
+
+        /// Forget all the names. Members that use them are not affected.
+        void clear();
+
+    private:
+        const char* intern(std::string_view name);
+        void swap(KeyTable& other);
+
+        // Keys view the interned strings.
+        typedef std::unordered_map<std::string_view, const char*> Names;
+        Names names_;
     };
 
-    /** \brief Experimental and untested: represents an element of the "path" to access a node.
+    /** \brief Represents an element of the "path" to access a node.
      */
-    class PathArgument {
+    class JSONCPP_API PathArgument {
         enum Kind {
             kindNone = 0,
             kindIndex,
-            kindKey
+            kindKey,
+            kindToken // JSON Pointer reference token: an array index or a member name
         };
         std::string key_;
         ArrayIndex index_;
@@ -436,7 +635,11 @@ namespace Json {
         PathArgument(const std::string& key) : key_{ key }, index_{ 0 }, kind_{ kindKey } {}
     };
 
-    /** \brief Experimental and untested: represents a "path" to access a node.
+    /** \brief A compiled "path" to access a node.
+     *
+     * The path is parsed once, by the constructor; evaluating it with find() or
+     * resolve() does not allocate memory. Paths are meant to be built once and
+     * evaluated against many values. Use PathSet to evaluate several paths at once.
      *
      * Syntax:
      * - "." => root node
@@ -446,8 +649,16 @@ namespace Json {
      * - ".[0][1][2].name1[3]"
      * - ".%" => member name is provided as parameter
      * - ".[%]" => index is provied as parameter
+     *
+     * A path that starts with '/' is a <a HREF="https://www.rfc-editor.org/rfc/rfc6901">JSON Pointer</a>:
+     * - "/name1/0" => element 0 of member 'name1' of the root node if it is an array,
+     *   or its member named '0' if it is an object
+     * - "/a~1b/m~0n" => member 'm~n' of member 'a/b' of the root node
+     * - "/list/-" => with make(), a new element appended to member 'list'
+     *
+     * The empty pointer "" refers to the root node, like ".".
      */
-    class Path {
+    class JSONCPP_API Path {
     public:
         Path(
             const std::string& path,
@@ -458,20 +669,120 @@ namespace Json {
             const PathArgument& a5 = PathArgument()
         );
 
+        /// \c false if the path is malformed, or a parameter is missing or has the wrong type.
+        /// The well-formed part of the path is kept.
+        bool isValid() const { return valid_; }
+
+        /// Number of members and elements to go through.
+        size_t size() const { return steps_.size(); }
+
+        /// \brief Find the node addressed by the path.
+        /// The non const overload pins the arrays and objects on the path, like
+        /// Value::tryGet() does: see Value::seal().
+        /// \return nullptr if the node does not exist.
+        const Value* find(const Value& root) const;
+        Value* find(Value& root) const;
+
+        /// Node addressed by the path, or Value::null if it does not exist.
         const Value& resolve(const Value& root) const;
         Value resolve(const Value& root, const Value& defaultValue) const;
         /// Creates the "path" to access the specified node and returns a reference on the node.
         Value& make(Value& root) const;
 
     private:
+        friend class PathSet;
+
         typedef std::vector<const PathArgument*> InArgs;
-        typedef std::vector<PathArgument> Args;
+
+        // A member or element to go through. Names are stored in keys_.
+        class Step {
+        public:
+            PathArgument::Kind kind_;
+            // For kindToken: notAnIndex if the token is not an array index.
+            ArrayIndex index_;
+            unsigned int keyBegin_;
+            unsigned int keyLength_;
+        };
+
+        typedef std::vector<Step> Steps;
+
+        static constexpr ArrayIndex notAnIndex = ArrayIndex(-1);
 
         void makePath(const std::string& path, const InArgs& in);
+        void makePointer(const std::string& pointer);
         void addPathInArg(const std::string& path, const InArgs& in, InArgs::const_iterator& itInArg, PathArgument::Kind kind);
+        void addStep(PathArgument::Kind kind, ArrayIndex index, std::string_view key);
         void invalidPath(const std::string& path, int location);
 
-        Args args_;
+        std::string_view key(const Step& step) const { return std::string_view(keys_).substr(step.keyBegin_, step.keyLength_); }
+        bool sameStep(size_t position, const Path& other, size_t otherPosition) const;
+        template <typename Node>
+        Node* child(Node& node, const Step& step) const;
+
+        Steps steps_;
+        // Names of all the steps, one after another.
+        std::string keys_;
+        bool valid_;
+    };
+
+    /** \brief Evaluates several Path at once.
+     *
+     * The paths are merged on their common prefixes, so that a member or element
+     * shared by several paths is looked up only once per evaluation.
+     *
+     * Example of usage:
+     * \code
+     * Json::PathSet routes;
+     * size_t user = routes.add( Json::Path( "/request/user" ) );
+     * size_t method = routes.add( Json::Path( "/request/method" ) );
+     * std::vector<const Json::Value*> found;
+     * routes.find( request, found );
+     * if ( found[method] && found[user] )
+     *    ...
+     * \endcode
+     */
+    class JSONCPP_API PathSet {
+    public:
+        PathSet();
+
+        /// \brief Add path to the set.
+        /// \return Position of the result of path in the results of find().
+        size_t add(const Path& path);
+
+        /// Number of paths in the set.
+        size_t size() const { return paths_.size(); }
+
+        /** \brief Find the nodes addressed by all the paths, in a single traversal of root.
+         *
+         * results is resized to size(), and results[i] points to the node addressed by
+         * the i-th added path, or is nullptr if it does not exist. Reusing results for
+         * several evaluations avoids any allocation.
+         */
+        void find(const Value& root, std::vector<const Value*>& results) const;
+
+    private:
+        // A step shared by the paths that have the same prefix.
+        class Node {
+        public:
+            // Path and position of the step, in paths_.
+            size_t path_;
+            size_t step_;
+            size_t firstChild_;
+            size_t nextSibling_;
+            // First path that ends at this node, chained by nextEnd_.
+            size_t firstEnd_;
+        };
+
+        typedef std::vector<Node> Nodes;
+
+        static constexpr size_t none = size_t(-1);
+
+        void find(size_t node, const Value& value, std::vector<const Value*>& results) const;
+
+        std::vector<Path> paths_;
+        std::vector<size_t> nextEnd_;
+        // nodes_[0] is the root; its step is unused.
+        Nodes nodes_;
     };
 
     /** \brief base class for Value iterators.
@@ -485,6 +796,7 @@ namespace Json {
 
         ValueIteratorBase();
         explicit ValueIteratorBase(const Value::ObjectValues::iterator& current);
+        ValueIteratorBase(const Value::ArrayValues::iterator& current, const Value::ArrayValues::iterator& begin);
 
         bool operator==(const SelfType& other) const {
             return isEqual(other);
@@ -522,8 +834,13 @@ namespace Json {
 
     private:
         Value::ObjectValues::iterator current_;
+        Value::ArrayValues::iterator arrayCurrent_;
+        // First element of the iterated array, used to compute index().
+        Value::ArrayValues::iterator arrayBegin_;
         // Indicates that iterator is for a null value.
         bool isNull_;
+        // Indicates that iterator is for an array value.
+        bool isArray_;
     };
 
     /** \brief const iterator for object and array value.
@@ -545,6 +862,7 @@ namespace Json {
         /*! \internal Use by Value to create an iterator.
          */
         explicit ValueConstIterator(const Value::ObjectValues::iterator& current);
+        ValueConstIterator(const Value::ArrayValues::iterator& current, const Value::ArrayValues::iterator& begin);
     public:
         SelfType& operator=(const ValueIteratorBase& other);
 
@@ -595,6 +913,7 @@ namespace Json {
         /*! \internal Use by Value to create an iterator.
          */
         explicit ValueIterator(const Value::ObjectValues::iterator& current);
+        ValueIterator(const Value::ArrayValues::iterator& current, const Value::ArrayValues::iterator& begin);
     public:
         SelfType& operator=(const SelfType& other);
 
@@ -627,4 +946,10 @@ namespace Json {
 
 } // namespace Json
 
+/// Hash of Json::Value for unordered containers: Value::hash().
+template <>
+struct std::hash<Json::Value> {
+    size_t operator()(const Json::Value& value) const { return value.hash(); }
+};
+
 #endif // JSONCPP_H_INCLUDED
@@ -10,6 +10,7 @@
 
 #if !defined(JSONCPP_IS_AMALGAMATION)
 #include "value.h"
+#include "statistics.h"
 #endif // if !defined(JSONCPP_IS_AMALGAMATION)
 #include <vector>
 #include <string>
@@ -26,6 +27,25 @@ namespace Json {
         virtual ~Writer();
 
         virtual std::string write(const Value& root) = 0;
+
+        /// \brief Statistics of the last write.
+        /// All 0 unless the library is built with JSONCPP_ENABLE_STATISTICS.
+        const Statistics& getStatistics() const { return statistics_; }
+
+    protected:
+        Statistics statistics_;
+    };
+
+    /** \brief Destination of the characters produced by a writer.
+     *
+     * Writers buffer their output and call write() with blocks of characters,
+     * so that documents can be streamed without being built in memory.
+     */
+    class JSONCPP_API OutputSink {
+    public:
+        virtual ~OutputSink();
+
+        virtual void write(const char* data, size_t length) = 0;
     };
 
     /** \brief Outputs a Value in <a HREF="http://www.json.org">JSON</a> format without formatting (not human friendly).
@@ -41,14 +61,86 @@ namespace Json {
 
         void enableYAMLCompatibility();
 
+        /** \brief Serialize large documents on several threads.
+         *
+         * The elements of the root, and of the large nested arrays and objects, are split
+         * into tasks serialized by a pool of threads, then written in order: the document
+         * is identical to the one written by a single thread. Small documents are written
+         * by the calling thread alone. The Value must not be modified during the write.
+         * \param threadCount Maximum number of threads, including the calling thread.
+         *        0 to use one thread per hardware thread, 1 to write on the calling thread.
+         */
+        void enableParallelWrite(unsigned int threadCount = 0);
+
     public: // overridden from Writer
         virtual std::string write(const Value& root);
 
+    public:
+        /** \brief Append the document representing root to document.
+         *
+         * document is not cleared first: reusing the same string for several calls
+         * avoids any heap allocation once its capacity is large enough.
+         */
+        void write(const Value& root, std::string& document);
+
+        /** \brief Write the document representing root to [buffer, buffer + capacity).
+         *
+         * The document is not zero-terminated.
+         * \return Length of the whole document. If it is greater than capacity,
+         *         only the first capacity characters were written.
+         */
+        size_t write(const Value& root, char* buffer, size_t capacity);
+
+        /// \brief Write the document representing root to out, in fixed-size blocks.
+        void write(const Value& root, std::ostream& out);
+
+        /// \brief Pass the document representing root to sink, in fixed-size blocks.
+        void write(const Value& root, OutputSink& sink);
+
     private:
-        void writeValue(const Value& value);
+        class Output;
+        class ParallelWrite;
+
+        void writeValue(const Value& value, Output& out);
+        void writeKey(const char* begin, const char* end, Output& out);
 
         std::string document_;
         bool yamlCompatiblityEnabled_;
+        unsigned int threadCount_;
+    };
+
+    /** \brief Outputs a Value in <a HREF="https://www.rfc-editor.org/rfc/rfc8949">CBOR</a> binary format.
+     *
+     * Numbers are stored in binary and strings are length-prefixed, so that neither
+     * writing nor reading the document involves any text conversion or escaping.
+     * Integers use the shortest encoding that holds them, and doubles are stored in
+     * single precision when it is exact. Comments are not written.
+     *
+     * The documents can be read back with BinaryReader, or by any CBOR decoder.
+     * \sa BinaryReader, Value
+     */
+    class JSONCPP_API BinaryWriter : public Writer {
+    public:
+        BinaryWriter();
+        virtual ~BinaryWriter() {}
+
+    public: // overridden from Writer
+        /// \return The bytes of the CBOR document, which may contain '\\0'.
+        virtual std::string write(const Value& root);
+
+    public:
+        /// \brief Append the CBOR document representing root to document.
+        void write(const Value& root, std::string& document);
+
+        /// \brief Pass the CBOR document representing root to sink, in fixed-size blocks.
+        void write(const Value& root, OutputSink& sink);
+
+    private:
+        class Output;
+
+        void writeValue(const Value& value, Output& out);
+
+        std::string document_;
     };
 
     /** \brief Writes a Value in <a HREF="http://www.json.org">JSON</a> format in a human friendly way.
@@ -82,27 +174,11 @@ namespace Json {
         virtual std::string write(const Value& root);
 
     private:
-        void writeValue(const Value& value);
-        void writeArrayValue(const Value& value);
-        bool isMultineArray(const Value& value);
-        void pushValue(const std::string& value);
-        void writeIndent();
-        void writeWithIndent(const std::string& value);
-        void indent();
-        void unindent();
-        void writeCommentBeforeValue(const Value& root);
-        void writeCommentAfterValueOnSameLine(const Value& root);
-        bool hasCommentForValue(const Value& value);
-        static std::string normalizeEOL(const std::string& text);
-
-        typedef std::vector<std::string> ChildValues;
-
-        ChildValues childValues_;
+        class Output;
+
         std::string document_;
-        std::string indentString_;
         int rightMargin_;
         int indentSize_;
-        bool addChildValues_;
     };
 
     /** \brief Writes a Value in <a HREF="http://www.json.org">JSON</a> format in a human friendly way,
@@ -138,28 +214,16 @@ namespace Json {
          */
         void write(std::ostream& out, const Value& root);
 
+        /// \brief Statistics of the last write.
+        /// All 0 unless the library is built with JSONCPP_ENABLE_STATISTICS.
+        const Statistics& getStatistics() const { return statistics_; }
+
     private:
-        void writeValue(const Value& value);
-        void writeArrayValue(const Value& value);
-        bool isMultineArray(const Value& value);
-        void pushValue(const std::string& value);
-        void writeIndent();
-        void writeWithIndent(const std::string& value);
-        void indent();
-        void unindent();
-        void writeCommentBeforeValue(const Value& root);
-        void writeCommentAfterValueOnSameLine(const Value& root);
-        bool hasCommentForValue(const Value& value);
-        static std::string normalizeEOL(const std::string& text);
-
-        typedef std::vector<std::string> ChildValues;
-
-        ChildValues childValues_;
-        std::ostream* document_;
-        std::string indentString_;
+        class Output;
+
         int rightMargin_;
         std::string indentation_;
-        bool addChildValues_;
+        Statistics statistics_;
     };
 
 #if defined(JSONCPP_HAS_INT64)
@@ -168,6 +232,7 @@ namespace Json {
 #endif // if defined(JSONCPP_HAS_INT64)
     std::string JSONCPP_API valueToString(LargestInt value);
     std::string JSONCPP_API valueToString(LargestUInt value);
+    /// Shortest representation that reads back to the same double, always with a '.' or an exponent.
     std::string JSONCPP_API valueToString(double value);
     std::string JSONCPP_API valueToString(bool value);
     std::string JSONCPP_API valueToQuotedString(const char* value);
@@ -0,0 +1,546 @@
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+/* This executable measures the throughput of the parser and writer.
+ *
+ * Usage: jsoncpp_bench [iterations] [file.json...]
+ *
+ * Each operation is run on generated corpora (number-heavy, string-heavy,
+ * deeply nested and wide-object documents) and on the files given on the
+ * command line. Allocations are counted by replacing the global operator new,
+ * through which the library allocates every container, string and member name.
+ * The exit status is 1 if an operation did not produce the expected result.
+ */
+
+#include <json/json.h>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#if defined(_MSC_VER)  &&  _MSC_VER >= 1310
+# pragma warning( disable: 4996 )     // disable sscanf deprecation warning
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+static size_t allocationCount = 0;
+
+void *operator new( size_t size )
+{
+   ++allocationCount;
+   if ( void *memory = malloc( size ? size : 1 ) )
+      return memory;
+   throw std::bad_alloc();
+}
+
+void *operator new( size_t size, std::align_val_t alignment )
+{
+   ++allocationCount;
+   size_t align = size_t(alignment);
+   if ( void *memory = aligned_alloc( align, (size + align - 1) / align * align ) )
+      return memory;
+   throw std::bad_alloc();
+}
+
+void operator delete( void *memory ) noexcept
+{
+   free( memory );
+}
+
+void operator delete( void *memory, size_t ) noexcept
+{
+   free( memory );
+}
+
+void operator delete( void *memory, std::align_val_t ) noexcept
+{
+   free( memory );
+}
+
+void operator delete( void *memory, size_t, std::align_val_t ) noexcept
+{
+   free( memory );
+}
+
+static double
+elapsedSeconds( Clock::time_point start )
+{
+   return std::chrono::duration<double>( Clock::now() - start ).count();
+}
+
+
+/// Number tokens with a mix of magnitudes, precisions and exponents.
+static std::vector<std::string>
+makeNumberTokens( size_t count )
+{
+   std::mt19937_64 random( 42 );
+   std::uniform_real_distribution<double> mantissa( -1.0, 1.0 );
+   std::uniform_int_distribution<int> exponent( -30, 30 );
+   std::uniform_int_distribution<int> precision( 1, 17 );
+   std::vector<std::string> tokens;
+   tokens.reserve( count );
+   char buffer[64];
+   for ( size_t index = 0; index < count; ++index )
+   {
+      snprintf( buffer, sizeof(buffer), "%.*g", precision( random ),
+                mantissa( random ) * pow( 10.0, exponent( random ) ) );
+      tokens.push_back( buffer );
+   }
+   return tokens;
+}
+
+
+/// Reference implementation: the sscanf based Reader::decodeDouble of jsoncpp 0.6.0.
+static double
+decodeDoubleSscanf( const char *begin, const char *end )
+{
+   double value = 0;
+   const int bufferSize = 32;
+   int length = int(end - begin);
+   if ( length <= bufferSize )
+   {
+      char buffer[bufferSize+1];
+      memcpy( buffer, begin, length );
+      buffer[length] = 0;
+      sscanf( buffer, "%lf", &value );
+   }
+   else
+   {
+      std::string buffer( begin, end );
+      sscanf( buffer.c_str(), "%lf", &value );
+   }
+   return value;
+}
+
+
+static double
+decodeDoubleFromChars( const char *begin, const char *end )
+{
+   double value = 0;
+   std::from_chars( begin, end, value );
+   return value;
+}
+
+
+template<typename Decoder>
+static double
+benchmarkDecoder( const char *name, const std::vector<std::string> &tokens, int iterations, Decoder decode )
+{
+   double checksum = 0;
+   size_t bytes = 0;
+   Clock::time_point start = Clock::now();
+   for ( int iteration = 0; iteration < iterations; ++iteration )
+   {
+      for ( const std::string &token : tokens )
+      {
+         checksum += decode( token.data(), token.data() + token.size() );
+         bytes += token.size();
+      }
+   }
+   double seconds = elapsedSeconds( start );
+   printf( "%-28s %8.1f ns/number %8.1f MB/s   (checksum %g)\n",
+           name,
+           seconds * 1e9 / double(tokens.size() * iterations),
+           double(bytes) / seconds / 1e6,
+           checksum );
+   return checksum;
+}
+
+
+
+
+// Corpora
+// //////////////////////////////////////////////////////////////////
+
+struct Corpus
+{
+   std::string name_;
+   std::string text_;
+   Json::Value root_;
+};
+
+
+/// Array of numbers with a mix of magnitudes, precisions and exponents.
+static std::string
+makeNumberDocument( const std::vector<std::string> &tokens )
+{
+   std::string document = "[";
+   for ( const std::string &token : tokens )
+   {
+      document += token;
+      document += ',';
+   }
+   document.back() = ']';
+   return document;
+}
+
+
+/// Array of records made of strings, some with escape sequences and non ASCII characters.
+static std::string
+makeStringDocument( size_t count )
+{
+   static const char *const words[] = {
+      "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit",
+      "caf\xc3\xa9", "na\xc3\xafve", "\\\"quoted\\\"", "tab\\tbed", "line\\nfeed", "\\u00e9t\\u00e9"
+   };
+   const size_t wordCount = sizeof(words) / sizeof(words[0]);
+   std::mt19937_64 random( 7 );
+   std::uniform_int_distribution<size_t> pick( 0, wordCount - 1 );
+   std::uniform_int_distribution<int> length( 1, 24 );
+   std::string document = "[";
+   for ( size_t index = 0; index < count; ++index )
+   {
+      if ( index > 0 )
+         document += ',';
+      document += "{\"id\":\"";
+      document += words[pick( random )];
+      document += "\",\"title\":\"";
+      for ( int remaining = length( random ); remaining > 0; --remaining )
+      {
+         document += words[pick( random )];
+         if ( remaining > 1 )
+            document += ' ';
+      }
+      document += "\"}";
+   }
+   document += "]";
+   return document;
+}
+
+
+/// Array of chains of objects and arrays nested depth levels deep.
+static std::string
+makeNestedDocument( size_t chains, size_t depth )
+{
+   std::string document = "[";
+   for ( size_t chain = 0; chain < chains; ++chain )
+   {
+      if ( chain > 0 )
+         document += ',';
+      for ( size_t level = 0; level < depth; ++level )
+         document += level % 2 ? "[" : "{\"child\":";
+      document += "null";
+      for ( size_t level = depth; level > 0; --level )
+         document += (level - 1) % 2 ? "]" : "}";
+   }
+   document += "]";
+   return document;
+}
+
+
+/// Single object with count members.
+static std::string
+makeWideObjectDocument( size_t count )
+{
+   std::string document = "{";
+   char buffer[64];
+   for ( size_t index = 0; index < count; ++index )
+   {
+      snprintf( buffer, sizeof(buffer), "%s\"member_%zu\":%zu", index ? "," : "", index * 7919 % count, index );
+      document += buffer;
+   }
+   document += "}";
+   return document;
+}
+
+
+static bool
+loadCorpus( const char *path, Corpus &corpus )
+{
+   std::ifstream file( path, std::ios::binary );
+   if ( !file )
+      return false;
+   std::ostringstream text;
+   text << file.rdbuf();
+   corpus.name_ = path;
+   size_t separator = corpus.name_.find_last_of( "/\\" );
+   if ( separator != std::string::npos )
+      corpus.name_.erase( 0, separator + 1 );
+   corpus.text_ = text.str();
+   return true;
+}
+
+
+// Operations
+// //////////////////////////////////////////////////////////////////
+
+/// Time and allocations accumulated over the measured sections.
+struct Sample
+{
+   double seconds_ = 0;
+   size_t allocations_ = 0;
+   Clock::time_point start_;
+   size_t startAllocations_ = 0;
+
+   void start()
+   {
+      startAllocations_ = allocationCount;
+      start_ = Clock::now();
+   }
+
+   void stop()
+   {
+      seconds_ += elapsedSeconds( start_ );
+      allocations_ += allocationCount - startAllocations_;
+   }
+};
+
+
+/// bytes is the size of the text processed by one operation, 0 if throughput is not meaningful.
+static void
+report( const Corpus &corpus, const char *operation, const Sample &sample, int count, size_t bytes, const char *unit = "doc" )
+{
+   char throughput[32] = "-";
+   if ( bytes != 0 )
+      snprintf( throughput, sizeof(throughput), "%.1f", double(bytes) * count / sample.seconds_ / 1e6 );
+   printf( "%-18s %-22s %12.3f us/%s %10s MB/s %12.1f allocs/%s\n",
+           corpus.name_.c_str(),
+           operation,
+           sample.seconds_ * 1e6 / count, unit,
+           throughput,
+           double(sample.allocations_) / count, unit );
+}
+
+
+/// Checks that document is read back as the tree of corpus.
+static bool
+readsBack( const Corpus &corpus, const char *operation, const std::string &document )
+{
+   Json::Value root;
+   if ( !Json::Reader().parse( document, root, false )  ||  root != corpus.root_ )
+   {
+      printf( "%s: %s output differs from the original!\n", corpus.name_.c_str(), operation );
+      return false;
+   }
+   return true;
+}
+
+
+static bool
+benchmarkParse( const Corpus &corpus, int iterations )
+{
+   Json::Reader reader;
+   Sample sample;
+   size_t parsedCount = 0;
+   for ( int iteration = 0; iteration < iterations; ++iteration )
+   {
+      Json::Value root;
+      sample.start();
+      parsedCount += reader.parse( corpus.text_.data(), corpus.text_.data() + corpus.text_.size(), root, false );
+      sample.stop();
+      if ( iteration == 0  &&  root != corpus.root_ )
+         parsedCount = 0;
+   }
+   report( corpus, "Reader::parse", sample, iterations, corpus.text_.size() );
+   if ( parsedCount != size_t(iterations) )
+   {
+      printf( "Parsing failed!\n" );
+      return false;
+   }
+   return true;
+}
+
+
+static bool
+benchmarkFastWriter( const Corpus &corpus, int iterations )
+{
+   Json::FastWriter writer;
+   std::string document;
+   Sample sample;
+   for ( int iteration = 0; iteration < iterations; ++iteration )
+   {
+      document.clear();
+      sample.start();
+      writer.write( corpus.root_, document );
+      sample.stop();
+   }
+   report( corpus, "FastWriter::write", sample, iterations, document.size() );
+   return readsBack( corpus, "FastWriter", document );
+}
+
+
+static bool
+benchmarkStyledWriter( const Corpus &corpus, int iterations )
+{
+   Json::StyledWriter writer;
+   std::string document;
+   Sample sample;
+   for ( int iteration = 0; iteration < iterations; ++iteration )
+   {
+      sample.start();
+      document = writer.write( corpus.root_ );
+      sample.stop();
+   }
+   report( corpus, "StyledWriter::write", sample, iterations, document.size() );
+   return readsBack( corpus, "StyledWriter", document );
+}
+
+
+static bool
+benchmarkCopyCompareDestroy( const Corpus &corpus, int iterations )
+{
+   Json::Reader reader;
+   Sample copySample;
+   Sample compareSample;
+   Sample destroySample;
+   size_t equalCount = 0;
+   for ( int iteration = 0; iteration < iterations; ++iteration )
+   {
+      copySample.start();
+      Json::Value copy( corpus.root_ );
+      copySample.stop();
+      equalCount += copy == corpus.root_;
+
+      // Copies share the data of the original: compare and destroy a tree of its own.
+      Json::Value *other = new Json::Value;
+      reader.parse( corpus.text_.data(), corpus.text_.data() + corpus.text_.size(), *other, false );
+
+      compareSample.start();
+      equalCount += *other == corpus.root_;
+      compareSample.stop();
+
+      destroySample.start();
+      delete other;
+      destroySample.stop();
+   }
+   report( corpus, "Value copy", copySample, iterations, 0 );
+   report( corpus, "Value compare", compareSample, iterations, 0 );
+   report( corpus, "Value destruction", destroySample, iterations, 0 );
+   if ( equalCount != 2 * size_t(iterations) )
+   {
+      printf( "Copies differ from the original!\n" );
+      return false;
+   }
+   return true;
+}
+
+
+typedef std::vector<std::pair<const Json::Value *, std::string> > Lookups;
+
+static void
+collectLookups( const Json::Value &value, Lookups &lookups, size_t maximumCount )
+{
+   if ( value.type() == Json::objectValue )
+   {
+      for ( const auto &[name, member] : value.items() )
+      {
+         if ( lookups.size() < maximumCount )
+            lookups.emplace_back( &value, std::string( name.c_str(), name.length() ) );
+         collectLookups( member, lookups, maximumCount );
+      }
+   }
+   else if ( value.type() == Json::arrayValue )
+   {
+      for ( Json::ArrayIndex index = 0; index < value.size() && lookups.size() < maximumCount; ++index )
+         collectLookups( value.get( index ), lookups, maximumCount );
+   }
+}
+
+
+static bool
+benchmarkLookup( const Corpus &corpus, int iterations )
+{
+   Lookups lookups;
+   collectLookups( corpus.root_, lookups, 100000 );
+   if ( lookups.empty() )
+      return true;
+   size_t found = 0;
+   Sample sample;
+   sample.start();
+   for ( int iteration = 0; iteration < iterations; ++iteration )
+   {
+      for ( const auto &lookup : lookups )
+         found += lookup.first->tryGet( lookup.second ) != nullptr;
+   }
+   sample.stop();
+   report( corpus, "member lookup", sample, int(lookups.size()) * iterations, 0, "op" );
+   if ( found != lookups.size() * iterations )
+   {
+      printf( "Member lookups failed!\n" );
+      return false;
+   }
+   return true;
+}
+
+
+/// \return false if an operation did not produce the expected result.
+static bool
+benchmarkCorpus( Corpus &corpus, int iterations )
+{
+   Json::Reader reader;
+   if ( !reader.parse( corpus.text_.data(), corpus.text_.data() + corpus.text_.size(), corpus.root_, false ) )
+   {
+      printf( "Failed to parse %s:\n%s\n", corpus.name_.c_str(), reader.getFormattedErrorMessages().c_str() );
+      return false;
+   }
+   printf( "%s: %.2f MB\n", corpus.name_.c_str(), double(corpus.text_.size()) / 1e6 );
+   bool ok = benchmarkParse( corpus, iterations );
+   ok = benchmarkFastWriter( corpus, iterations )  &&  ok;
+   ok = benchmarkStyledWriter( corpus, iterations )  &&  ok;
+   ok = benchmarkCopyCompareDestroy( corpus, iterations )  &&  ok;
+   ok = benchmarkLookup( corpus, iterations )  &&  ok;
+   printf( "\n" );
+   return ok;
+}
+
+
+int main( int argc, const char *argv[] )
+{
+   int iterations = 20;
+   int firstFile = 1;
+   if ( argc > 1  &&  argv[1][0] >= '0'  &&  argv[1][0] <= '9' )
+   {
+      iterations = atoi( argv[1] );
+      firstFile = 2;
+   }
+   if ( iterations <= 0 )
+   {
+      printf( "Usage: %s [iterations] [file.json...]\n", argv[0] );
+      return 1;
+   }
+
+   std::vector<std::string> tokens = makeNumberTokens( 100000 );
+   std::vector<Corpus> corpora( 4 );
+   corpora[0].name_ = "numbers";
+   corpora[0].text_ = makeNumberDocument( tokens );
+   corpora[1].name_ = "strings";
+   corpora[1].text_ = makeStringDocument( 20000 );
+   corpora[2].name_ = "nested";
+   corpora[2].text_ = makeNestedDocument( 1000, 64 );
+   corpora[3].name_ = "wide-object";
+   corpora[3].text_ = makeWideObjectDocument( 100000 );
+   for ( int index = firstFile; index < argc; ++index )
+   {
+      corpora.emplace_back();
+      if ( !loadCorpus( argv[index], corpora.back() ) )
+      {
+         printf( "Failed to read %s\n", argv[index] );
+         return 1;
+      }
+   }
+
+   printf( "%d iterations per operation\n\n", iterations );
+   bool ok = true;
+   for ( Corpus &corpus : corpora )
+      ok = benchmarkCorpus( corpus, iterations )  &&  ok;
+
+   printf( "Double parsing, %d x %d numbers\n", iterations, int(tokens.size()) );
+   double expected = benchmarkDecoder( "sscanf (0.6.0 decodeDouble)", tokens, iterations, decodeDoubleSscanf );
+   if ( benchmarkDecoder( "std::from_chars", tokens, iterations, decodeDoubleFromChars ) != expected )
+   {
+      printf( "The double decoders disagree!\n" );
+      ok = false;
+   }
+   return ok ? 0 : 1;
+}
@@ -9,32 +9,26 @@
 
 #include <json/json.h>
 #include <algorithm> // sort
+#include <chrono>
+#include <filesystem>
 #include <stdio.h>
 
 #if defined(_MSC_VER)  &&  _MSC_VER >= 1310
 # pragma warning( disable: 4996 )     // disable fopen deprecation warning
 #endif
 
-static std::string
-readInputTestFile( const char *path )
+typedef std::chrono::steady_clock Clock;
+
+
+/// Prints the throughput of a step that processed bytes since start.
+static void
+printThroughput( const char *step, 
+                 size_t bytes, 
+                 Clock::time_point start )
 {
-   FILE *file = fopen( path, "rb" );
-   if ( !file )
-      return std::string("");
-   fseek( file, 0, SEEK_END );
-   long size = ftell( file );
-   if (size == -1) {
-       return {};
-   }
-   fseek( file, 0, SEEK_SET );
-   std::string text;
-   char *buffer = new char[size+1];
-   buffer[size] = 0;
-   if ( fread( buffer, 1, size, file ) == (unsigned long)size )
-      text = buffer;
-   fclose( file );
-   delete[] buffer;
-   return text;
+   double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+   printf( "%s: %zu bytes in %.3f ms, %.1f MB/s\n",
+           step, bytes, seconds * 1000, seconds > 0 ? bytes / seconds / 1e6 : 0.0 );
 }
 
 
@@ -88,16 +82,21 @@ printValueTree( FILE *fout, Json::Value &value, const std::string &path = "." )
 }
 
 
+/// Parses input, which is the document or, if inputIsFile, the path of its file.
 static int
 parseAndSaveValueTree( const std::string &input, 
+                       bool inputIsFile,
                        const std::string &actual,
                        const std::string &kind,
                        Json::Value &root,
                        const Json::Features &features,
-                       bool parseOnly )
+                       bool parseOnly,
+                       bool timed )
 {
    Json::Reader reader( features );
-   bool parsingSuccessful = reader.parse( input, root );
+   Clock::time_point start = Clock::now();
+   bool parsingSuccessful = inputIsFile ? reader.parseFile( input, root ) 
+                                        : reader.parse( input, root );
    if ( !parsingSuccessful )
    {
       printf( "Failed to parse %s file: \n%s\n", 
@@ -105,6 +104,14 @@ parseAndSaveValueTree( const std::string &input,
               reader.getFormattedErrorMessages().c_str() );
       return 1;
    }
+   if ( timed )
+   {
+      // The size of pipes is unknown.
+      std::error_code error;
+      std::uintmax_t fileSize = inputIsFile ? std::filesystem::file_size( input, error ) : 0;
+      size_t bytes = inputIsFile ? ( error ? 0 : size_t( fileSize ) ) : input.size();
+      printThroughput( ( "parse " + kind ).c_str(), bytes, start );
+   }
 
    if ( !parseOnly )
    {
@@ -124,12 +131,16 @@ parseAndSaveValueTree( const std::string &input,
 static int
 rewriteValueTree( const std::string &rewritePath, 
                   const Json::Value &root, 
-                  std::string &rewrite )
+                  std::string &rewrite,
+                  bool timed )
 {
    //Json::FastWriter writer;
    //writer.enableYAMLCompatibility();
    Json::StyledWriter writer;
+   Clock::time_point start = Clock::now();
    rewrite = writer.write( root );
+   if ( timed )
+      printThroughput( "write rewrite", rewrite.size(), start );
    FILE *fout = fopen( rewritePath.c_str(), "wt" );
    if ( !fout )
    {
@@ -142,6 +153,28 @@ rewriteValueTree( const std::string &rewritePath,
 }
 
 
+/// Writes root with BinaryWriter and checks that BinaryReader reads back the same tree.
+static int
+checkBinaryRoundTrip( const Json::Value &root )
+{
+   Json::BinaryWriter writer;
+   std::string binary = writer.write( root );
+   Json::BinaryReader reader;
+   Json::Value binaryRoot;
+   if ( !reader.parse( binary, binaryRoot ) )
+   {
+      printf( "Failed to parse binary rewrite:\n%s\n", reader.getFormattedErrorMessages().c_str() );
+      return 1;
+   }
+   if ( binaryRoot != root )
+   {
+      printf( "Binary rewrite differs from the input.\n" );
+      return 1;
+   }
+   return 0;
+}
+
+
 static std::string
 removeSuffix( const std::string &path, 
               const std::string &extension )
@@ -170,7 +203,9 @@ printConfig()
 static int 
 printUsage( const char *argv[] )
 {
-   printf( "Usage: %s [--strict] input-json-file", argv[0] );
+   printf( "Usage: %s [--json-checker] [--time] input-json-file\n", argv[0] );
+   printf( "  --json-checker  Parse only, in strict mode\n" );
+   printf( "  --time          Report the throughput of each parse and write\n" );
    return 3;
 }
 
@@ -178,29 +213,41 @@ printUsage( const char *argv[] )
 int
 parseCommandLine( int argc, const char *argv[], 
                   Json::Features &features, std::string &path,
-                  bool &parseOnly )
+                  bool &parseOnly, bool &timed )
 {
    parseOnly = false;
+   timed = false;
    if ( argc < 2 )
    {
       return printUsage( argv );
    }
 
-   int index = 1;
-   if ( std::string(argv[1]) == "--json-checker" )
-   {
-      features = Json::Features::strictMode();
-      parseOnly = true;
-      ++index;
-   }
-
    if ( std::string(argv[1]) == "--json-config" )
    {
       printConfig();
       return 3;
    }
 
-   if ( index == argc  ||  index + 1 < argc )
+   int index = 1;
+   for ( ; index < argc  &&  std::string(argv[index]).compare( 0, 2, "--" ) == 0; ++index )
+   {
+      std::string option = argv[index];
+      if ( option == "--json-checker" )
+      {
+         features = Json::Features::strictMode();
+         parseOnly = true;
+      }
+      else if ( option == "--time" )
+      {
+         timed = true;
+      }
+      else
+      {
+         return printUsage( argv );
+      }
+   }
+
+   if ( index + 1 != argc )
    {
       return printUsage( argv );
    }
@@ -215,7 +262,8 @@ int main( int argc, const char *argv[] )
    std::string path;
    Json::Features features;
    bool parseOnly;
-   int exitCode = parseCommandLine( argc, argv, features, path, parseOnly );
+   bool timed;
+   int exitCode = parseCommandLine( argc, argv, features, path, parseOnly, timed );
    if ( exitCode != 0 )
    {
       return exitCode;
@@ -223,14 +271,7 @@ int main( int argc, const char *argv[] )
 
    try
    {
-      std::string input = readInputTestFile( path.c_str() );
-      if ( input.empty() )
-      {
-         printf( "Failed to read input or empty input: %s\n", path.c_str() );
-         return 3;
-      }
-
-      std::string basePath = removeSuffix( argv[1], ".json" );
+      std::string basePath = removeSuffix( path, ".json" );
       if ( !parseOnly  &&  basePath.empty() )
       {
          printf( "Bad input path. Path does not end with '.expected':\n%s\n", path.c_str() );
@@ -242,17 +283,19 @@ int main( int argc, const char *argv[] )
       std::string rewriteActualPath = basePath + ".actual-rewrite";
 
       Json::Value root;
-      exitCode = parseAndSaveValueTree( input, actualPath, "input", root, features, parseOnly );
+      exitCode = parseAndSaveValueTree( path, true, actualPath, "input", root, features, parseOnly, timed );
       if ( exitCode == 0  &&  !parseOnly )
       {
          std::string rewrite;
-         exitCode = rewriteValueTree( rewritePath, root, rewrite );
+         exitCode = rewriteValueTree( rewritePath, root, rewrite, timed );
          if ( exitCode == 0 )
          {
             Json::Value rewriteRoot;
-            exitCode = parseAndSaveValueTree( rewrite, rewriteActualPath, 
-               "rewrite", rewriteRoot, features, parseOnly );
+            exitCode = parseAndSaveValueTree( rewrite, false, rewriteActualPath, 
+               "rewrite", rewriteRoot, features, parseOnly, timed );
          }
+         if ( exitCode == 0 )
+            exitCode = checkBinaryRoundTrip( root );
       }
    }
    catch ( const std::exception &e )
@@ -0,0 +1,381 @@
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include <json/binding.h>
+#include "json_tool.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <algorithm>
+#include <utility>
+
+namespace Json {
+
+    // Class Binder
+    // //////////////////////////////////////////////////////////////////
+
+    Binder::~Binder() {}
+
+    bool Binder::readNull([[maybe_unused]] void* object) const {
+        return false;
+    }
+
+    bool Binder::readBool([[maybe_unused]] void* object, [[maybe_unused]] bool value) const {
+        return false;
+    }
+
+    bool Binder::readInt([[maybe_unused]] void* object, [[maybe_unused]] LargestInt value) const {
+        return false;
+    }
+
+    bool Binder::readUInt([[maybe_unused]] void* object, [[maybe_unused]] LargestUInt value) const {
+        return false;
+    }
+
+    bool Binder::readDouble([[maybe_unused]] void* object, [[maybe_unused]] double value) const {
+        return false;
+    }
+
+    bool Binder::readString([[maybe_unused]] void* object, [[maybe_unused]] std::string_view value) const {
+        return false;
+    }
+
+    BoundValue Binder::startArray([[maybe_unused]] void* object) const {
+        return BoundValue();
+    }
+
+    BoundValue Binder::element([[maybe_unused]] void* array) const {
+        return BoundValue();
+    }
+
+    BoundValue Binder::startObject([[maybe_unused]] void* object) const {
+        return BoundValue();
+    }
+
+    BoundValue Binder::member([[maybe_unused]] void* object, [[maybe_unused]] std::string_view name, size_t& field) const {
+        field = notAField;
+        return BoundValue();
+    }
+
+    size_t Binder::fieldCount() const {
+        return 0;
+    }
+
+    const char* Binder::missingMember([[maybe_unused]] const unsigned char* seen) const {
+        return nullptr;
+    }
+
+    bool Binder::isAbsent([[maybe_unused]] const void* object) const {
+        return false;
+    }
+
+    void Binder::writeInt(LargestInt value, std::string& document) {
+        if (value < 0)
+            document += '-';
+        writeUInt(value < 0 ? 0 - LargestUInt(value) : LargestUInt(value), document);
+    }
+
+    void Binder::writeUInt(LargestUInt value, std::string& document) {
+        UIntToStringBuffer buffer;
+        char* end = buffer + sizeof(buffer) - 1; // uintToString() zero-terminates
+        char* current = end + 1;
+        uintToString(value, current);
+        document.append(current, end - current);
+    }
+
+    void Binder::writeDouble(double value, std::string& document) {
+        DoubleToStringBuffer buffer;
+        document.append(buffer, doubleToString(value, buffer) - buffer);
+    }
+
+    void Binder::writeString(std::string_view value, std::string& document) {
+        writeQuotedString(document, value.data(), value.data() + value.length());
+    }
+
+    // Class StructBinder
+    // //////////////////////////////////////////////////////////////////
+
+    StructBinder::StructBinder(Fields&& fields) : fields_{ std::move(fields) }, prefixes_{}, byName_{} {
+        for (size_t index = 0; index < fields_.size(); ++index) {
+            std::string prefix;
+            writeString(fields_[index].name_, prefix);
+            prefixes_.push_back(prefix + ':');
+            byName_.push_back(index);
+        }
+        std::sort(byName_.begin(), byName_.end(), [this](size_t left, size_t right) { return fields_[left].name_ < fields_[right].name_; });
+    }
+
+    const char* StructBinder::expected() const {
+        return "an object";
+    }
+
+    BoundValue StructBinder::startObject(void* object) const {
+        return BoundValue(object, this);
+    }
+
+    BoundValue StructBinder::member(void* object, std::string_view name, size_t& field) const {
+        if (field >= fields_.size() || fields_[field].name_ != name) {
+            auto found = std::lower_bound(byName_.begin(), byName_.end(), name, [this](size_t index, std::string_view key) { return fields_[index].name_ < key; });
+            if (found == byName_.end() || fields_[*found].name_ != name) {
+                field = notAField;
+                return BoundValue();
+            }
+            field = *found;
+        }
+        const Field& bound = fields_[field];
+        return BoundValue(bound.member_(object), &bound.binder_());
+    }
+
+    size_t StructBinder::fieldCount() const {
+        return fields_.size();
+    }
+
+    const char* StructBinder::missingMember(const unsigned char* seen) const {
+        for (size_t index = 0; index < fields_.size(); ++index) {
+            if (fields_[index].required_ && !seen[index])
+                return fields_[index].name_.c_str();
+        }
+        return nullptr;
+    }
+
+    void StructBinder::write(const void* object, std::string& document) const {
+        document += '{';
+        bool first = true;
+        for (size_t index = 0; index < fields_.size(); ++index) {
+            const Field& field = fields_[index];
+            const void* member = field.member_(const_cast<void*>(object));
+            const Binder& binder = field.binder_();
+            if (binder.isAbsent(member))
+                continue;
+            if (!std::exchange(first, false))
+                document += ',';
+            document += prefixes_[index];
+            binder.write(member, document);
+        }
+        document += '}';
+    }
+
+    // Binders of the scalar types
+    // //////////////////////////////////////////////////////////////////
+
+    namespace Bindings {
+
+        const char* BoolBinder::expected() const {
+            return "a boolean";
+        }
+
+        bool BoolBinder::readBool(void* object, bool value) const {
+            *static_cast<bool*>(object) = value;
+            return true;
+        }
+
+        void BoolBinder::write(const void* object, std::string& document) const {
+            document += *static_cast<const bool*>(object) ? "true" : "false";
+        }
+
+        const char* StringBinder::expected() const {
+            return "a string";
+        }
+
+        bool StringBinder::readString(void* object, std::string_view value) const {
+            static_cast<std::string*>(object)->assign(value);
+            return true;
+        }
+
+        void StringBinder::write(const void* object, std::string& document) const {
+            writeString(*static_cast<const std::string*>(object), document);
+        }
+
+        const Binder& boolBinder() {
+            static const BoolBinder binder;
+            return binder;
+        }
+
+        const Binder& stringBinder() {
+            static const StringBinder binder;
+            return binder;
+        }
+
+    } // namespace Bindings
+
+    // Class BindingReader::Filler
+    // //////////////////////////////////////////////////////////////////
+
+    /* Handler that stores the events of the Reader in the bound objects.
+     * BindingReader::frames_ holds the containers being filled. The member receiving
+     * the next value of an object is resolved by key(). The values of unbound members
+     * are skipped, counting the depth of their containers in skipped_.
+     */
+    class BindingReader::Filler : public Handler {
+    public:
+        Filler(BindingReader& reader, BoundValue root) : reader_{ reader }, next_{ root }, skipped_{ 0 } {}
+
+        bool startObject() override {
+            if (skipped_ > 0 || !bind()) {
+                ++skipped_;
+                return true;
+            }
+            BoundValue container = next_.binder_->startObject(next_.object_);
+            if (!container.binder_)
+                return mismatch();
+            Frame& frame = push(container, false);
+            frame.seen_ = reader_.seen_.size();
+            reader_.seen_.resize(frame.seen_ + container.binder_->fieldCount());
+            return true;
+        }
+
+        bool key(std::string_view name) override {
+            if (skipped_ > 0)
+                return true;
+            Frame& frame = top();
+            frame.key_.assign(name);
+            size_t field = frame.count_;
+            next_ = frame.container_.binder_->member(frame.container_.object_, name, field);
+            if (field != Binder::notAField) {
+                reader_.seen_[frame.seen_ + field] = true;
+                frame.count_ = field + 1;
+            }
+            return true;
+        }
+
+        bool endObject() override {
+            if (skipped_ > 0) {
+                --skipped_;
+                return true;
+            }
+            Frame& frame = top();
+            if (const char* missing = frame.container_.binder_->missingMember(reader_.seen_.data() + frame.seen_)) {
+                --reader_.depth_;
+                return fail("Missing member '" + std::string(missing) + "' in " + path());
+            }
+            reader_.seen_.resize(frame.seen_);
+            --reader_.depth_;
+            return true;
+        }
+
+        bool startArray() override {
+            if (skipped_ > 0 || !bind()) {
+                ++skipped_;
+                return true;
+            }
+            BoundValue container = next_.binder_->startArray(next_.object_);
+            if (!container.binder_)
+                return mismatch();
+            push(container, true);
+            return true;
+        }
+
+        bool endArray() override {
+            if (skipped_ > 0) {
+                --skipped_;
+                return true;
+            }
+            --reader_.depth_;
+            return true;
+        }
+
+        bool value([[maybe_unused]] std::nullptr_t value) override {
+            return skipped_ > 0 || !bind() || next_.binder_->readNull(next_.object_) || mismatch();
+        }
+
+        bool value(bool value) override {
+            return skipped_ > 0 || !bind() || next_.binder_->readBool(next_.object_, value) || mismatch();
+        }
+
+        bool value(LargestInt value) override {
+            return skipped_ > 0 || !bind() || next_.binder_->readInt(next_.object_, value) || mismatch();
+        }
+
+        bool value(LargestUInt value) override {
+            return skipped_ > 0 || !bind() || next_.binder_->readUInt(next_.object_, value) || mismatch();
+        }
+
+        bool value(double value) override {
+            return skipped_ > 0 || !bind() || next_.binder_->readDouble(next_.object_, value) || mismatch();
+        }
+
+        bool value(std::string_view value) override {
+            return skipped_ > 0 || !bind() || next_.binder_->readString(next_.object_, value) || mismatch();
+        }
+
+    private:
+        Frame& top() { return reader_.frames_[reader_.depth_ - 1]; }
+
+        Frame& push(BoundValue container, bool isArray) {
+            if (reader_.frames_.size() == reader_.depth_)
+                reader_.frames_.emplace_back();
+            Frame& frame = reader_.frames_[reader_.depth_++];
+            frame.container_ = container;
+            frame.count_ = 0;
+            frame.isArray_ = isArray;
+            return frame;
+        }
+
+        /* Resolves next_, the object receiving the next value: a new element in arrays, the
+         * member found by key() in objects. Returns false if the value is not bound.
+         */
+        bool bind() {
+            if (reader_.depth_ > 0 && top().isArray_) {
+                Frame& frame = top();
+                next_ = frame.container_.binder_->element(frame.container_.object_);
+                ++frame.count_;
+            }
+            return next_.binder_ != nullptr;
+        }
+
+        bool mismatch() { return fail("Expected " + std::string(next_.binder_->expected()) + " at " + path()); }
+
+        bool fail(std::string&& message) {
+            reader_.error_ = std::move(message);
+            return false;
+        }
+
+        // JSON Pointer of the value being read, or "the root".
+        std::string path() const {
+            std::string path;
+            for (size_t depth = 0; depth < reader_.depth_; ++depth) {
+                const Frame& frame = reader_.frames_[depth];
+                appendPointerToken(path, frame.isArray_ ? std::to_string(frame.count_ - 1) : frame.key_);
+            }
+            return path.empty() ? "the root" : path;
+        }
+
+        BindingReader& reader_;
+        BoundValue next_;
+        size_t skipped_;
+    };
+
+    // Class BindingReader
+    // //////////////////////////////////////////////////////////////////
+
+    BindingReader::BindingReader(const Features& features) : reader_{ features }, frames_{}, depth_{ 0 }, seen_{}, error_{} {}
+
+    bool BindingReader::parse(const char* beginDoc, const char* endDoc, BoundValue root) {
+        depth_ = 0;
+        seen_.clear();
+        error_.clear();
+        Filler filler(*this, root);
+        return reader_.parse(beginDoc, endDoc, filler);
+    }
+
+    std::vector<StructuredError> BindingReader::getStructuredErrors() const {
+        std::vector<StructuredError> errors = reader_.getStructuredErrors();
+        // The Reader reports that the Filler aborted the parse.
+        if (!error_.empty() && !errors.empty())
+            errors.front().message_ = error_;
+        return errors;
+    }
+
+    std::string BindingReader::getFormattedErrorMessages() const {
+        if (error_.empty())
+            return reader_.getFormattedErrorMessages();
+        std::string formattedMessage;
+        for (const StructuredError& error : getStructuredErrors()) {
+            formattedMessage += "* Line " + std::to_string(error.line_) + ", Column " + std::to_string(error.column_) + "\n";
+            formattedMessage += "  " + error.message_ + "\n";
+        }
+        return formattedMessage;
+    }
+
+} // namespace Json
@@ -0,0 +1,64 @@
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include <json/document.h>
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <cstring>
+
+namespace Json {
+
+    // Class Arena
+    // //////////////////////////////////////////////////////////////////
+
+    Arena::Arena(std::size_t initialSize) : resource_{ initialSize } {}
+
+    Arena::~Arena() {}
+
+    void* Arena::allocate(std::size_t size, std::size_t alignment) {
+        return resource_.allocate(size, alignment);
+    }
+
+    char* Arena::duplicate(std::string_view str) {
+        char* newString = static_cast<char*>(resource_.allocate(str.length() + 1, 1));
+        if (!str.empty())
+            memcpy(newString, str.data(), str.length());
+        newString[str.length()] = 0;
+        return newString;
+    }
+
+    void Arena::release() {
+        resource_.release();
+    }
+
+    std::pmr::memory_resource* Arena::resource() {
+        return &resource_;
+    }
+
+    // Class Document
+    // //////////////////////////////////////////////////////////////////
+
+    Document::Document(std::size_t initialSize) : arena_{ initialSize }, root_{} {}
+
+    Document::~Document() {}
+
+    Value& Document::root() {
+        return root_;
+    }
+
+    const Value& Document::root() const {
+        return root_;
+    }
+
+    Arena& Document::arena() {
+        return arena_;
+    }
+
+    void Document::clear() {
+        root_ = Value();
+        arena_.release();
+    }
+
+} // namespace Json
@@ -0,0 +1,123 @@
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include <json/file.h>
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <fstream>
+#include <cstdint>
+
+#if defined(_WIN32)
+#define JSONCPP_MAP_WINDOWS 1
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define JSONCPP_MAP_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Json {
+
+    // Class MappedFile
+    // //////////////////////////////////////////////////////////////////
+
+    MappedFile::MappedFile() : data_{ nullptr }, size_{ 0 }, buffer_{}, mapped_{ false } {
+        data_ = buffer_.data();
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    bool MappedFile::open(const std::string& path) {
+        close();
+        return map(path) || read(path);
+    }
+
+    void MappedFile::close() {
+        if (mapped_) {
+#if defined(JSONCPP_MAP_WINDOWS)
+            UnmapViewOfFile(data_);
+#elif defined(JSONCPP_MAP_POSIX)
+            munmap(const_cast<char*>(data_), size_);
+#endif
+            mapped_ = false;
+        }
+        // The buffer keeps its capacity for the next file that cannot be mapped.
+        buffer_.clear();
+        data_ = buffer_.data();
+        size_ = 0;
+    }
+
+    /* Maps the file if it is a regular, non-empty file. Empty files cannot be mapped, and
+     * the size of other files is not known in advance: they are read by read().
+     */
+    bool MappedFile::map([[maybe_unused]] const std::string& path) {
+#if defined(JSONCPP_MAP_WINDOWS)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &size) && size.QuadPart > 0 && UInt64(size.QuadPart) <= SIZE_MAX) {
+            if (HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+                // The view keeps the mapping alive.
+                if (void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) {
+                    data_ = static_cast<const char*>(address);
+                    size_ = size_t(size.QuadPart);
+                    mapped_ = true;
+                }
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+        return mapped_;
+#elif defined(JSONCPP_MAP_POSIX)
+        int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+            return false;
+        struct stat status;
+        if (fstat(file, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0 && UInt64(status.st_size) <= SIZE_MAX) {
+            size_t size = size_t(status.st_size);
+            void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (address != MAP_FAILED) {
+                // Documents are parsed from the beginning to the end: read ahead.
+                posix_madvise(address, size, POSIX_MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(address);
+                size_ = size;
+                mapped_ = true;
+            }
+        }
+        ::close(file);
+        return mapped_;
+#else
+        return false;
+#endif
+    }
+
+    bool MappedFile::read(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return false;
+        char chunk[64 * 1024];
+        while (in.read(chunk, sizeof(chunk)) || in.gcount() > 0)
+            buffer_.append(chunk, size_t(in.gcount()));
+        if (in.bad()) {
+            buffer_.clear();
+            return false;
+        }
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return true;
+    }
+
+} // namespace Json
@@ -0,0 +1,419 @@
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include <json/lazy.h>
+#include "json_tool.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <cstdio>
+#include <cstring>
+
+namespace Json {
+
+    // Strict JSON, but values of any type can be decoded on their own.
+    static Features lazyFeatures() {
+        Features features = Features::strictMode();
+        features.strictRoot_ = false;
+        features.failFast_ = true;
+        return features;
+    }
+
+    // Returns the position following the closing quote of the string starting at quote,
+    // or nullptr if the string is not terminated.
+    static inline const char* skipString(const char* quote, const char* end) {
+        const char* current = quote + 1;
+        for (;;) {
+            current = findQuoteOrBackslash(current, end);
+            if (current == end)
+                return nullptr;
+            if (*current == '"')
+                return current + 1;
+            if (end - current < 2)
+                return nullptr;
+            current += 2;
+        }
+    }
+
+    static inline bool isDelimiter(char c) {
+        return c == ',' || c == ']' || c == '}' || c == ':' || isWhitespace(c);
+    }
+
+    static inline bool hasEscape(const char* begin, const char* end) {
+        return memchr(begin, '\\', end - begin) != nullptr;
+    }
+
+    // Class LazyValue
+    // //////////////////////////////////////////////////////////////////
+
+    LazyValue::LazyValue() : document_{ nullptr }, begin_{ nullptr }, node_{ noNode } {}
+
+    LazyValue::LazyValue(const LazyDocument* document, const char* begin, size_t node) :
+        document_{ document }, begin_{ begin }, node_{ node } {}
+
+    const char* LazyValue::findEnd() const {
+        if (node_ != noNode)
+            return document_->begin_ + document_->nodes_[node_].end_;
+        const char* end = document_->end_;
+        if (*begin_ == '"') {
+            const char* stringEnd = skipString(begin_, end);
+            return stringEnd ? stringEnd : end;
+        }
+        const char* current = begin_;
+        while (current != end && !isDelimiter(*current))
+            ++current;
+        return current;
+    }
+
+    ValueType LazyValue::type() const {
+        if (!document_)
+            return nullValue;
+        switch (*begin_) {
+        case '{':
+            return objectValue;
+        case '[':
+            return arrayValue;
+        case '"':
+            return stringValue;
+        case 't':
+        case 'f':
+            return booleanValue;
+        case 'n':
+            return nullValue;
+        default:
+            break;
+        }
+        const char* end = findEnd();
+        bool isNumber = *begin_ == '-' || (*begin_ >= '0' && *begin_ <= '9');
+        if (isNumber) {
+            for (const char* current = begin_; current != end; ++current) {
+                if (*current == '.' || *current == 'e' || *current == 'E')
+                    return realValue;
+            }
+            // Fewer than 19 digits always fit in a LargestInt.
+            size_t digits = size_t(end - begin_) - (*begin_ == '-' ? 1 : 0);
+            if (digits < 19)
+                return intValue;
+        }
+        return toValue().type();
+    }
+
+    ArrayIndex LazyValue::size() const {
+        if (node_ == noNode)
+            return 0;
+        ArrayIndex count = 0;
+        for (const_iterator it = begin(); it != end(); ++it)
+            ++count;
+        return count;
+    }
+
+    LazyValue LazyValue::operator[](std::string_view key) const {
+        if (node_ == noNode || *begin_ != '{')
+            return LazyValue();
+        for (const_iterator it = begin(); it != end(); ++it) {
+            if (it.keyEquals(key))
+                return *it;
+        }
+        return LazyValue();
+    }
+
+    LazyValue LazyValue::operator[](ArrayIndex index) const {
+        if (node_ == noNode || *begin_ != '[')
+            return LazyValue();
+        for (const_iterator it = begin(); it != end(); ++it) {
+            if (it.index() == index)
+                return *it;
+        }
+        return LazyValue();
+    }
+
+    bool LazyValue::tryGet(std::string_view key, LazyValue& value) const {
+        value = (*this)[key];
+        return bool(value);
+    }
+
+    bool LazyValue::tryGet(ArrayIndex index, LazyValue& value) const {
+        value = (*this)[index];
+        return bool(value);
+    }
+
+    LazyValue::const_iterator LazyValue::begin() const {
+        if (node_ == noNode)
+            return const_iterator();
+        return const_iterator(*this);
+    }
+
+    LazyValue::const_iterator LazyValue::end() const {
+        return const_iterator();
+    }
+
+    std::string_view LazyValue::text() const {
+        if (!document_)
+            return std::string_view();
+        return std::string_view(begin_, findEnd() - begin_);
+    }
+
+    bool LazyValue::toValue(Value& value) const {
+        if (!document_) {
+            value = Value();
+            return false;
+        }
+        return document_->decode(begin_, findEnd(), value);
+    }
+
+    Value LazyValue::toValue() const {
+        Value value;
+        toValue(value);
+        return value;
+    }
+
+    std::string LazyValue::asString(const std::string& defaultValue) const {
+        if (document_ && *begin_ == '"') {
+            const char* end = findEnd();
+            // Strings without escape sequences are copied as they are.
+            if (end - begin_ >= 2 && end[-1] == '"' && !hasEscape(begin_ + 1, end - 1))
+                return std::string(begin_ + 1, end - 1);
+        }
+        Value value;
+        if (!toValue(value))
+            return defaultValue;
+        return value.asString(defaultValue);
+    }
+
+    LargestInt LazyValue::asLargestInt(LargestInt defaultValue) const {
+        Value value;
+        if (!toValue(value) || value.isNull())
+            return defaultValue;
+        return value.asLargestInt();
+    }
+
+    LargestUInt LazyValue::asLargestUInt(LargestUInt defaultValue) const {
+        Value value;
+        if (!toValue(value) || value.isNull())
+            return defaultValue;
+        return value.asLargestUInt();
+    }
+
+    double LazyValue::asDouble(double defaultValue) const {
+        Value value;
+        if (!toValue(value))
+            return defaultValue;
+        return value.asDouble(defaultValue);
+    }
+
+    bool LazyValue::asBool(bool defaultValue) const {
+        Value value;
+        if (!toValue(value))
+            return defaultValue;
+        return value.asBool(defaultValue);
+    }
+
+    // Class LazyValue::const_iterator
+    // //////////////////////////////////////////////////////////////////
+
+    LazyValue::const_iterator::const_iterator() :
+        value_{}, keyBegin_{ nullptr }, keyEnd_{ nullptr }, nextNode_{ 0 }, index_{ 0 }, isObject_{ false } {}
+
+    LazyValue::const_iterator::const_iterator(const LazyValue& container) :
+        value_{ container.document_, nullptr, noNode }, keyBegin_{ nullptr }, keyEnd_{ nullptr },
+        nextNode_{ container.node_ + 1 }, index_{ 0 }, isObject_{ *container.begin_ == '{' } {
+        readElement(container.begin_ + 1);
+    }
+
+    void LazyValue::const_iterator::readElement(const char* current) {
+        const LazyDocument* document = value_.document_;
+        const char* end = document->end_;
+        current = skipWhitespace(current, end);
+        if (isObject_) {
+            if (current == end || *current != '"') {
+                value_ = LazyValue();
+                return;
+            }
+            const char* nameEnd = skipString(current, end);
+            if (!nameEnd) {
+                value_ = LazyValue();
+                return;
+            }
+            keyBegin_ = current + 1;
+            keyEnd_ = nameEnd - 1;
+            current = skipWhitespace(nameEnd, end);
+            if (current == end || *current != ':') {
+                value_ = LazyValue();
+                return;
+            }
+            current = skipWhitespace(current + 1, end);
+        }
+        if (current == end || *current == ']' || *current == '}' || *current == ',') {
+            value_ = LazyValue();
+            return;
+        }
+        size_t node = noNode;
+        if (*current == '{' || *current == '[') {
+            node = nextNode_;
+            nextNode_ = document->nodes_[node].next_;
+        }
+        value_ = LazyValue(document, current, node);
+    }
+
+    LazyValue::const_iterator& LazyValue::const_iterator::operator++() {
+        const LazyDocument* document = value_.document_;
+        const char* current = skipWhitespace(value_.findEnd(), document->end_);
+        if (current != document->end_ && *current == ',') {
+            ++index_;
+            readElement(current + 1);
+        } else {
+            value_ = LazyValue();
+        }
+        return *this;
+    }
+
+    LazyValue::const_iterator LazyValue::const_iterator::operator++(int) {
+        const_iterator previous(*this);
+        ++*this;
+        return previous;
+    }
+
+    std::string LazyValue::const_iterator::key() const {
+        if (!isObject_ || !value_.document_)
+            return std::string();
+        if (!hasEscape(keyBegin_, keyEnd_))
+            return std::string(keyBegin_, keyEnd_);
+        Value name;
+        value_.document_->decode(keyBegin_ - 1, keyEnd_ + 1, name);
+        return name.asString();
+    }
+
+    bool LazyValue::const_iterator::keyEquals(std::string_view key) const {
+        if (!hasEscape(keyBegin_, keyEnd_))
+            return std::string_view(keyBegin_, keyEnd_ - keyBegin_) == key;
+        return this->key() == key;
+    }
+
+    // Class LazyDocument
+    // //////////////////////////////////////////////////////////////////
+
+    LazyDocument::LazyDocument() :
+        nodes_{}, openNodes_{}, document_{}, errors_{}, reader_{ lazyFeatures() }, begin_{ nullptr }, end_{ nullptr }, root_{ nullptr } {}
+
+    bool LazyDocument::parse(const char* beginDoc, const char* endDoc) {
+        begin_ = beginDoc;
+        end_ = endDoc;
+        return index();
+    }
+
+    bool LazyDocument::parse(const std::string& document) {
+        document_ = document;
+        begin_ = document_.data();
+        end_ = begin_ + document_.size();
+        return index();
+    }
+
+    LazyValue LazyDocument::root() const {
+        if (!root_)
+            return LazyValue();
+        return LazyValue(this, root_, *root_ == '{' || *root_ == '[' ? 0 : LazyValue::noNode);
+    }
+
+    std::string LazyDocument::getFormattedErrorMessages() const {
+        return errors_;
+    }
+
+    bool LazyDocument::index() {
+        nodes_.clear();
+        openNodes_.clear();
+        errors_.clear();
+        root_ = nullptr;
+
+        const char* current = skipWhitespace(begin_, end_);
+        if (current == end_)
+            return fail(current, "Syntax error: value, object or array expected.");
+        const char* root = current;
+        if (*root != '{' && *root != '[') {
+            // A single value: decoded on access.
+            const char* valueEnd = root;
+            if (*root == '"') {
+                valueEnd = skipString(root, end_);
+                if (!valueEnd)
+                    return fail(root, "Missing '\"' to close the string.");
+            } else {
+                while (valueEnd != end_ && !isDelimiter(*valueEnd))
+                    ++valueEnd;
+                if (valueEnd == root)
+                    return fail(root, "Syntax error: value, object or array expected.");
+            }
+            current = valueEnd;
+        } else {
+            do {
+                switch (*current) {
+                case '"':
+                    {
+                        const char* stringEnd = skipString(current, end_);
+                        if (!stringEnd)
+                            return fail(current, "Missing '\"' to close the string.");
+                        current = stringEnd;
+                    }
+                    break;
+                case '{':
+                case '[':
+                    // end_ holds the offset of the opening bracket until the container is closed.
+                    openNodes_.push_back(nodes_.size());
+                    nodes_.emplace_back();
+                    nodes_.back().end_ = size_t(current - begin_);
+                    ++current;
+                    break;
+                case '}':
+                case ']':
+                    {
+                        Node& node = nodes_[openNodes_.back()];
+                        char expected = begin_[node.end_] == '{' ? '}' : ']';
+                        if (*current != expected)
+                            return fail(current, expected == '}' ? "Missing '}' or object member name." : "Missing ',' or ']' in array declaration.");
+                        ++current;
+                        node.end_ = size_t(current - begin_);
+                        node.next_ = nodes_.size();
+                        openNodes_.pop_back();
+                    }
+                    break;
+                default:
+                    ++current;
+                    break;
+                }
+                current = skipWhitespace(current, end_);
+            } while (!openNodes_.empty() && current != end_);
+            if (!openNodes_.empty()) {
+                const char* open = begin_ + nodes_[openNodes_.back()].end_;
+                return fail(open, *open == '{' ? "Missing '}' to close the object." : "Missing ']' to close the array.");
+            }
+        }
+        current = skipWhitespace(current, end_);
+        if (current != end_)
+            return fail(current, "Extra characters after the end of the document.");
+        root_ = root;
+        return true;
+    }
+
+    bool LazyDocument::fail(const char* location, const char* message) {
+        int line = 1;
+        const char* lineStart = begin_;
+        for (const char* current = begin_; current != location; ++current) {
+            if (*current == '\n') {
+                ++line;
+                lineStart = current + 1;
+            }
+        }
+        char buffer[18 + 16 + 16 + 1];
+        snprintf(buffer, sizeof(buffer), "Line %d, Column %d", line, int(location - lineStart) + 1);
+        errors_ = std::string("* ") + buffer + "\n  " + message + "\n";
+        nodes_.clear();
+        return false;
+    }
+
+    bool LazyDocument::decode(const char* begin, const char* end, Value& value) const {
+        if (reader_.parse(begin, end, value, false))
+            return true;
+        errors_ = reader_.getFormattedErrorMessages();
+        return false;
+    }
+
+} // namespace Json
@@ -0,0 +1,512 @@
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include <json/patch.h>
+#include <json/statistics.h>
+#include "json_tool.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <algorithm>
+#include <utility>
+
+namespace Json {
+
+    // Class Patch
+    // //////////////////////////////////////////////////////////////////
+
+    static inline bool isNumber(const Value& value) {
+        return value.type() == intValue || value.type() == uintValue || value.type() == realValue;
+    }
+
+    /* Value::operator==(), except that numbers are compared by value whatever their
+     * type. Their hashes do not depend on the type either: the cached hashes of the
+     * containers still tell apart those that differ.
+     */
+    bool Patch::equals(const Value& a, const Value& b) {
+        if (a.type() != b.type())
+            return isNumber(a) && isNumber(b) && equalNumbers(a, b);
+        switch (a.type()) {
+        case arrayValue: {
+            if (a.sharesContainer(b))
+                return true;
+            if (size_t hash = a.cachedHash(), otherHash = b.cachedHash(); hash != 0 && otherHash != 0 && hash != otherHash)
+                return false;
+            ArrayIndex size = a.size();
+            if (size != b.size())
+                return false;
+            for (ArrayIndex index = 0; index < size; ++index) {
+                if (!equals(a.get(index), b.get(index)))
+                    return false;
+            }
+            return true;
+        }
+        case objectValue: {
+            if (a.sharesContainer(b))
+                return true;
+            if (size_t hash = a.cachedHash(), otherHash = b.cachedHash(); hash != 0 && otherHash != 0 && hash != otherHash)
+                return false;
+            const Value::ObjectValues& members = a.items();
+            const Value::ObjectValues& otherMembers = b.items();
+            return members.size() == otherMembers.size() &&
+                   std::equal(members.begin(), members.end(), otherMembers.begin(), [](const auto& member, const auto& otherMember) {
+                       return member.first == otherMember.first && equals(member.second, otherMember.second);
+                   });
+        }
+        default:
+            return a == b;
+        }
+    }
+
+    // Numbers of different types: intValue, uintValue or realValue.
+    bool Patch::equalNumbers(const Value& a, const Value& b) {
+        if (a.type() == realValue || b.type() == realValue) {
+            const Value& real = a.type() == realValue ? a : b;
+            const Value& integer = a.type() == realValue ? b : a;
+            double number = real.asDouble();
+            if (integer.type() == intValue)
+                return number >= -0x1p63 && number < 0x1p63 && LargestInt(number) == integer.asLargestInt() && double(LargestInt(number)) == number;
+            return number >= 0.0 && number < 0x1p64 && LargestUInt(number) == integer.asLargestUInt() && double(LargestUInt(number)) == number;
+        }
+        const Value& signedInteger = a.type() == intValue ? a : b;
+        const Value& unsignedInteger = a.type() == intValue ? b : a;
+        return signedInteger.asLargestInt() >= 0 && LargestUInt(signedInteger.asLargestInt()) == unsignedInteger.asLargestUInt();
+    }
+
+    Value Patch::diff(const Value& from, const Value& to) {
+        Value operations(arrayValue);
+        std::string pointer;
+        diff(from, to, pointer, operations);
+        return operations;
+    }
+
+    void Patch::diff(const Value& from, const Value& to, std::string& pointer, Value& operations) {
+        if (from.sharesContainer(to))
+            return;
+        if (from.type() == objectValue && to.type() == objectValue)
+            diffObjects(from, to, pointer, operations);
+        else if (from.type() == arrayValue && to.type() == arrayValue)
+            diffArrays(from, to, pointer, operations);
+        else if (!equals(from, to))
+            addOperation(operations, "replace", pointer, &to);
+    }
+
+    // The members of both objects are sorted by name: they are merged in a single pass.
+    void Patch::diffObjects(const Value& from, const Value& to, std::string& pointer, Value& operations) {
+        const Value::ObjectValues& fromMembers = from.items();
+        const Value::ObjectValues& toMembers = to.items();
+        size_t length = pointer.length();
+        auto fromMember = fromMembers.begin();
+        auto toMember = toMembers.begin();
+        while (fromMember != fromMembers.end() || toMember != toMembers.end()) {
+            bool removed = toMember == toMembers.end() || (fromMember != fromMembers.end() && fromMember->first < toMember->first);
+            bool added = !removed && (fromMember == fromMembers.end() || toMember->first < fromMember->first);
+            const auto& name = removed ? fromMember->first : toMember->first;
+            appendPointerToken(pointer, std::string_view{ name.c_str(), name.length() });
+            if (removed) {
+                addOperation(operations, "remove", pointer, nullptr);
+                ++fromMember;
+            } else if (added) {
+                addOperation(operations, "add", pointer, &toMember->second);
+                ++toMember;
+            } else {
+                diff(fromMember->second, toMember->second, pointer, operations);
+                ++fromMember;
+                ++toMember;
+            }
+            pointer.resize(length);
+        }
+    }
+
+    /* Skips the equal elements at both ends. The elements left in the middle are
+     * compared one by one, then the extra ones are added or removed.
+     */
+    void Patch::diffArrays(const Value& from, const Value& to, std::string& pointer, Value& operations) {
+        ArrayIndex fromSize = from.size();
+        ArrayIndex toSize = to.size();
+        ArrayIndex prefix = 0;
+        while (prefix < fromSize && prefix < toSize && equals(from.get(prefix), to.get(prefix)))
+            ++prefix;
+        ArrayIndex suffix = 0;
+        while (suffix < fromSize - prefix && suffix < toSize - prefix && equals(from.get(fromSize - 1 - suffix), to.get(toSize - 1 - suffix)))
+            ++suffix;
+        ArrayIndex fromCount = fromSize - prefix - suffix;
+        ArrayIndex toCount = toSize - prefix - suffix;
+        ArrayIndex common = std::min(fromCount, toCount);
+
+        size_t length = pointer.length();
+        for (ArrayIndex index = prefix; index < prefix + toCount; ++index) {
+            appendPointerToken(pointer, std::to_string(index));
+            if (index < prefix + common)
+                diff(from.get(index), to.get(index), pointer, operations);
+            else
+                addOperation(operations, "add", pointer, &to.get(index));
+            pointer.resize(length);
+        }
+        if (fromCount > common) {
+            // Each removal shifts the next element to the same index.
+            appendPointerToken(pointer, std::to_string(prefix + common));
+            for (ArrayIndex count = common; count < fromCount; ++count)
+                addOperation(operations, "remove", pointer, nullptr);
+            pointer.resize(length);
+        }
+    }
+
+    void Patch::addOperation(Value& operations, const char* op, const std::string& pointer, const Value* value) {
+        Value& operation = operations.append(Value(objectValue));
+        operation["op"] = op;
+        operation["path"] = pointer;
+        if (value)
+            operation["value"] = *value;
+    }
+
+    Value Patch::mergeDiff(const Value& from, const Value& to) {
+        if (from.type() != objectValue || to.type() != objectValue)
+            return to;
+        Value patch(objectValue);
+        const Value::ObjectValues& fromMembers = from.items();
+        const Value::ObjectValues& toMembers = to.items();
+        auto fromMember = fromMembers.begin();
+        auto toMember = toMembers.begin();
+        while (fromMember != fromMembers.end() || toMember != toMembers.end()) {
+            bool removed = toMember == toMembers.end() || (fromMember != fromMembers.end() && fromMember->first < toMember->first);
+            bool added = !removed && (fromMember == fromMembers.end() || toMember->first < fromMember->first);
+            const auto& name = removed ? fromMember->first : toMember->first;
+            std::string_view key{ name.c_str(), name.length() };
+            if (removed) {
+                patch[key] = Value();
+                ++fromMember;
+                continue;
+            }
+            if (added) {
+                patch[key] = toMember->second;
+                ++toMember;
+                continue;
+            }
+            const Value& fromValue = fromMember->second;
+            const Value& toValue = toMember->second;
+            if (fromValue.type() == objectValue && toValue.type() == objectValue) {
+                if (!fromValue.sharesContainer(toValue)) {
+                    Value members = mergeDiff(fromValue, toValue);
+                    if (members.size() > 0)
+                        patch[key] = std::move(members);
+                }
+            } else if (!equals(fromValue, toValue)) {
+                patch[key] = toValue;
+            }
+            ++fromMember;
+            ++toMember;
+        }
+        return patch;
+    }
+
+    void Patch::applyMerge(Value& root, const Value& patch) {
+        if (patch.type() != objectValue) {
+            root = patch;
+            return;
+        }
+        if (root.type() != objectValue)
+            root = Value(objectValue);
+        for (const auto& [name, value] : patch.items()) {
+            std::string_view key{ name.c_str(), name.length() };
+            if (value.type() == nullValue)
+                root.removeMember(key, nullptr);
+            else
+                applyMerge(root[key], value);
+        }
+    }
+
+    void Patch::insertElement(Value& array, ArrayIndex index, Value&& element) {
+        Value::ArrayValues& elements = array.arrayValues();
+        elements.insert(elements.begin() + index, std::move(element));
+        // Like append(): Value::seal() expects the parents of pinned elements to be pinned.
+        array.pin();
+    }
+
+    Value Patch::eraseElement(Value& array, ArrayIndex index) {
+        Value::ArrayValues& elements = array.arrayValues();
+        Value element = std::move(elements[index]);
+        elements.erase(elements.begin() + index);
+        return element;
+    }
+
+    // Class Patch::Applier
+    // //////////////////////////////////////////////////////////////////
+
+    /* Applies the operations of a JSON Patch to root, logging how to undo each change.
+     * The log addresses the changed values by JSON Pointers, like the operations: the
+     * containers may be copied by the later changes, invalidating references.
+     */
+    class Patch::Applier {
+    public:
+        explicit Applier(Value& root) : root_{ root }, undo_{}, recording_{ true } {}
+
+        bool apply(const Value& operation, std::string& error);
+
+        /// Undo the changes of the applied operations, the last one first.
+        void undo();
+
+    private:
+        enum UndoKind { undoSet, undoRemove, undoInsert };
+
+        struct Undo {
+            UndoKind kind_;
+            std::string pointer_;
+            Value value_;
+        };
+
+        typedef std::vector<std::string> Tokens;
+
+        bool add(const std::string& pointer, Value&& value, std::string& error);
+        bool remove(const std::string& pointer, Value& removed, std::string& error);
+        bool replace(const std::string& pointer, Value&& value, std::string& error);
+        bool parent(const std::string& pointer, Value*& node, std::string& token, std::string& error);
+        void record(UndoKind kind, std::string pointer, Value value);
+
+        static bool split(const std::string& pointer, Tokens& tokens, std::string& error);
+        template <typename Node>
+        static Node* find(Node& root, const Tokens& tokens, size_t count);
+
+        Value& root_;
+        std::vector<Undo> undo_;
+        bool recording_;
+    };
+
+    // Unescaped reference tokens of pointer; the root is "".
+    bool Patch::Applier::split(const std::string& pointer, Tokens& tokens, std::string& error) {
+        tokens.clear();
+        if (pointer.empty())
+            return true;
+        if (pointer[0] != '/') {
+            error = "invalid JSON Pointer '" + pointer + "'";
+            return false;
+        }
+        for (size_t current = 1;; ++current) {
+            std::string& token = tokens.emplace_back();
+            for (; current != pointer.length() && pointer[current] != '/'; ++current) {
+                char c = pointer[current];
+                if (c == '~') {
+                    if (++current == pointer.length() || (pointer[current] != '0' && pointer[current] != '1')) {
+                        error = "invalid JSON Pointer '" + pointer + "'";
+                        return false;
+                    }
+                    c = pointer[current] == '0' ? '~' : '/';
+                }
+                token += c;
+            }
+            if (current == pointer.length())
+                return true;
+        }
+    }
+
+    /* Goes through the first count tokens from root. Only the non const overloads of
+     * tryGet() detach the containers on the way, if Node is not const.
+     */
+    template <typename Node>
+    Node* Patch::Applier::find(Node& root, const Tokens& tokens, size_t count) {
+        Node* node = &root;
+        for (size_t index = 0; index < count && node; ++index) {
+            const std::string& token = tokens[index];
+            ArrayIndex element;
+            if (node->type() == objectValue)
+                node = node->tryGet(std::string_view{ token });
+            else if (node->type() == arrayValue && decodePointerIndex(token, element))
+                node = node->tryGet(element);
+            else
+                node = nullptr;
+        }
+        return node;
+    }
+
+    bool Patch::Applier::parent(const std::string& pointer, Value*& node, std::string& token, std::string& error) {
+        Tokens tokens;
+        if (!split(pointer, tokens, error))
+            return false;
+        node = find(root_, tokens, tokens.size() - 1);
+        if (!node || (node->type() != arrayValue && node->type() != objectValue)) {
+            error = "the parent of '" + pointer + "' is not an array or an object";
+            return false;
+        }
+        token = std::move(tokens.back());
+        return true;
+    }
+
+    void Patch::Applier::record(UndoKind kind, std::string pointer, Value value) {
+        if (recording_)
+            undo_.push_back(Undo{ kind, std::move(pointer), std::move(value) });
+    }
+
+    bool Patch::Applier::add(const std::string& pointer, Value&& value, std::string& error) {
+        if (pointer.empty()) {
+            record(undoSet, pointer, std::move(root_));
+            root_ = std::move(value);
+            return true;
+        }
+        Value* node;
+        std::string token;
+        if (!parent(pointer, node, token, error))
+            return false;
+        if (node->type() == objectValue) {
+            if (Value* member = node->tryGet(std::string_view{ token })) {
+                record(undoSet, pointer, std::move(*member));
+                *member = std::move(value);
+            } else {
+                node->insert(token, std::move(value));
+                record(undoRemove, pointer, Value());
+            }
+            return true;
+        }
+        ArrayIndex index = node->size();
+        if (token != "-" && (!decodePointerIndex(token, index) || index > node->size())) {
+            error = "'" + pointer + "' is not an index of the array";
+            return false;
+        }
+        insertElement(*node, index, std::move(value));
+        record(undoRemove, pointer.substr(0, pointer.rfind('/') + 1) + std::to_string(index), Value());
+        return true;
+    }
+
+    bool Patch::Applier::remove(const std::string& pointer, Value& removed, std::string& error) {
+        if (pointer.empty()) {
+            error = "the root cannot be removed";
+            return false;
+        }
+        Value* node;
+        std::string token;
+        if (!parent(pointer, node, token, error))
+            return false;
+        if (node->type() == objectValue) {
+            if (!node->removeMember(token, &removed)) {
+                error = "'" + pointer + "' does not exist";
+                return false;
+            }
+        } else {
+            ArrayIndex index;
+            if (!decodePointerIndex(token, index) || index >= node->size()) {
+                error = "'" + pointer + "' does not exist";
+                return false;
+            }
+            removed = eraseElement(*node, index);
+        }
+        record(undoInsert, pointer, removed);
+        return true;
+    }
+
+    bool Patch::Applier::replace(const std::string& pointer, Value&& value, std::string& error) {
+        Tokens tokens;
+        if (!split(pointer, tokens, error))
+            return false;
+        Value* target = find(root_, tokens, tokens.size());
+        if (!target) {
+            error = "'" + pointer + "' does not exist";
+            return false;
+        }
+        record(undoSet, pointer, std::move(*target));
+        *target = std::move(value);
+        return true;
+    }
+
+    bool Patch::Applier::apply(const Value& operation, std::string& error) {
+        const Value* op = operation.type() == objectValue ? operation.tryGet("op") : nullptr;
+        const Value* path = operation.type() == objectValue ? operation.tryGet("path") : nullptr;
+        if (!op || op->type() != stringValue || !path || path->type() != stringValue) {
+            error = "expected an object with the string members 'op' and 'path'";
+            return false;
+        }
+        std::string name = op->asString();
+        std::string pointer = path->asString();
+        const Value* value = operation.tryGet("value");
+        const Value* from = operation.tryGet("from");
+        if ((name == "add" || name == "replace" || name == "test") && !value) {
+            error = "missing member 'value'";
+            return false;
+        }
+        if ((name == "move" || name == "copy") && (!from || from->type() != stringValue)) {
+            error = "missing string member 'from'";
+            return false;
+        }
+
+        if (name == "add")
+            return add(pointer, Value(*value), error);
+        if (name == "remove") {
+            Value removed;
+            return remove(pointer, removed, error);
+        }
+        if (name == "replace")
+            return replace(pointer, Value(*value), error);
+        if (name == "move") {
+            std::string source = from->asString();
+            if (pointer.compare(0, source.length() + 1, source + '/') == 0) {
+                error = "'" + source + "' cannot be moved into itself";
+                return false;
+            }
+            Value moved;
+            return remove(source, moved, error) && add(pointer, std::move(moved), error);
+        }
+        Tokens tokens;
+        if (name == "copy") {
+            std::string source = from->asString();
+            if (!split(source, tokens, error))
+                return false;
+            const Value* copied = find(std::as_const(root_), tokens, tokens.size());
+            if (!copied) {
+                error = "'" + source + "' does not exist";
+                return false;
+            }
+            return add(pointer, Value(*copied), error);
+        }
+        if (name == "test") {
+            if (!split(pointer, tokens, error))
+                return false;
+            const Value* tested = find(std::as_const(root_), tokens, tokens.size());
+            if (!tested || !equals(*tested, *value)) {
+                error = "'" + pointer + "' is not equal to the value";
+                return false;
+            }
+            return true;
+        }
+        error = "unknown operation '" + name + "'";
+        return false;
+    }
+
+    void Patch::Applier::undo() {
+        recording_ = false;
+        std::string error;
+        Tokens tokens;
+        for (auto change = undo_.rbegin(); change != undo_.rend(); ++change) {
+            switch (change->kind_) {
+            case undoSet:
+                split(change->pointer_, tokens, error);
+                *find(root_, tokens, tokens.size()) = std::move(change->value_);
+                break;
+            case undoRemove: {
+                Value removed;
+                remove(change->pointer_, removed, error);
+            } break;
+            case undoInsert:
+                add(change->pointer_, std::move(change->value_), error);
+                break;
+            }
+        }
+        undo_.clear();
+    }
+
+    bool Patch::apply(Value& root, const Value& patch, std::string* error) {
+        std::string message;
+        Applier applier(root);
+        if (patch.type() != arrayValue)
+            message = "The patch is not an array";
+        for (ArrayIndex index = 0; message.empty() && index < patch.size(); ++index) {
+            if (!applier.apply(patch.get(index), message))
+                message = "Operation " + std::to_string(index) + ": " + message;
+        }
+        if (message.empty())
+            return true;
+        applier.undo();
+        if (error)
+            *error = message;
+        return false;
+    }
+
+} // namespace Json
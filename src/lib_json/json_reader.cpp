@@ -14,6 +14,13 @@
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <charconv>
+#include <limits>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <bit>
+#include <cmath>
 
 #if _MSC_VER >= 1400            // VC++ 8.0
 #pragma warning(disable : 4996) // disable warning about strdup being deprecated.
@@ -24,7 +31,7 @@ namespace Json {
     // Implementation of class Features
     // ////////////////////////////////
 
-    Features::Features() : allowComments_(true), strictRoot_(false) {}
+    Features::Features() : allowComments_(true), strictRoot_(false), internKeys_(false), failFast_(false), strictUtf8_(false), maxDepth_(1000) {}
 
     Features Features::all() {
         return Features();
@@ -55,114 +62,511 @@ namespace Json {
         return false;
     }
 
-    // Class Reader
+    /* Value of a decimal number that std::from_chars reported as out of range:
+     * infinity if its magnitude is too large, 0 if its magnitude is too small.
+     * The magnitude is estimated from the position of the first significant digit.
+     */
+    static double outOfRangeDouble(const char* begin, const char* end) {
+        bool isNegative = *begin == '-';
+        const char* current = isNegative ? begin + 1 : begin;
+        long long magnitude = 0;
+        bool inFraction = false;
+        bool significant = false;
+        for (; current != end && *current != 'e' && *current != 'E'; ++current) {
+            if (*current == '.')
+                inFraction = true;
+            else if (*current != '0')
+                significant = true;
+            if (significant)
+                break;
+            if (inFraction && *current == '0')
+                --magnitude;
+        }
+        for (; current != end && *current != 'e' && *current != 'E'; ++current) {
+            if (*current == '.')
+                inFraction = true;
+            else if (!inFraction)
+                ++magnitude;
+        }
+        if (current != end) {
+            bool isNegativeExponent = current[1] == '-';
+            long long exponent = 0;
+            if (std::from_chars(current + 1 + (current[1] == '+'), end, exponent).ec != std::errc())
+                exponent = isNegativeExponent ? -std::numeric_limits<int>::max() : std::numeric_limits<int>::max();
+            magnitude += exponent;
+        }
+        double value = magnitude > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        return isNegative ? -value : value;
+    }
+
+    // Class Handler
     // //////////////////////////////////////////////////////////////////
 
-    Reader::Reader(const Features& features) :
-        nodes_{}, errors_{}, document_{}, begin_{ nullptr }, end_{ nullptr }, current_{ nullptr }, lastValueEnd_{ nullptr },
-        lastValue_{ nullptr }, commentsBefore_{}, features_{ features }, collectComments_{ false } {}
+    Handler::~Handler() {}
 
-    bool Reader::parse(const std::string& document, Value& root, bool collectComments) {
-        document_ = document;
-        const char* begin = document_.c_str();
-        const char* end = begin + document_.length();
-        return parse(begin, end, root, collectComments);
+    bool Handler::startObject() {
+        return true;
+    }
+
+    bool Handler::key([[maybe_unused]] std::string_view name) {
+        return true;
+    }
+
+    bool Handler::endObject() {
+        return true;
+    }
+
+    bool Handler::startArray() {
+        return true;
+    }
+
+    bool Handler::endArray() {
+        return true;
+    }
+
+    bool Handler::value([[maybe_unused]] std::nullptr_t value) {
+        return true;
+    }
+
+    bool Handler::value([[maybe_unused]] bool value) {
+        return true;
+    }
+
+    bool Handler::value([[maybe_unused]] LargestInt value) {
+        return true;
+    }
+
+    bool Handler::value([[maybe_unused]] LargestUInt value) {
+        return true;
+    }
+
+    bool Handler::value([[maybe_unused]] double value) {
+        return true;
+    }
+
+    bool Handler::value([[maybe_unused]] std::string_view value) {
+        return true;
+    }
+
+    // Class BasicReader::ValueBuilder
+    // //////////////////////////////////////////////////////////////////
+
+    /* Handler that builds the Value tree for BasicReader::parse().
+     * BasicReader::nodes_ holds the arrays and objects being filled. The member
+     * receiving the next value of an object, BasicReader::member_, is created by key().
+     * Both outlive the builder, so that a suspended parse resumes with another one.
+     */
+    template <typename Policy>
+    class BasicReader<Policy>::ValueBuilder : public Handler {
+    public:
+        ValueBuilder(BasicReader& reader, Value& root) : reader_{ reader }, root_{ &root } {}
+
+        bool startObject() override {
+            reader_.nodes_.push_back(&store(makeValue(objectValue)));
+            return true;
+        }
+
+        bool key(std::string_view name) override {
+            if (reader_.features_.internKeys_)
+                reader_.member_ = &reader_.keys_.resolve(*reader_.nodes_.back(), name);
+            else
+                reader_.member_ = &(*reader_.nodes_.back())[name];
+            return true;
+        }
+
+        bool endObject() override {
+            return endContainer();
+        }
+
+        bool startArray() override {
+            reader_.nodes_.push_back(&store(makeValue(arrayValue)));
+            return true;
+        }
+
+        bool endArray() override {
+            return endContainer();
+        }
+
+        bool value([[maybe_unused]] std::nullptr_t value) override {
+            store(Value());
+            return true;
+        }
+
+        bool value(bool value) override {
+            store(Value(value));
+            return true;
+        }
+
+        bool value(LargestInt value) override {
+            // Integers greater than Int max are read as uintValue, like BinaryReader does.
+            if (value > Value::maxInt)
+                store(Value(LargestUInt(value)));
+            else
+                store(Value(value));
+            return true;
+        }
+
+        bool value(LargestUInt value) override {
+            store(Value(value));
+            return true;
+        }
+
+        bool value(double value) override {
+            store(Value(value));
+            return true;
+        }
+
+        bool value(std::string_view value) override {
+            if (reader_.inSitu_ && value.data() >= reader_.begin_ && value.data() < reader_.end_) {
+                // Terminate the string by overwriting its closing quote, and reference it.
+                const_cast<Char*>(value.data())[value.length()] = 0;
+                store(Value(StaticString(value.data(), value.length())));
+            } else {
+                store(makeValue(value));
+            }
+            return true;
+        }
+
+    private:
+        Value makeValue(ValueType type) {
+            return reader_.arena_ ? Value(type, *reader_.arena_) : Value(type);
+        }
+
+        Value makeValue(std::string_view value) {
+            return reader_.arena_ ? Value(value, *reader_.arena_) : Value(value);
+        }
+
+        Value& store(Value&& value) {
+            Value* slot;
+            if (reader_.nodes_.empty())
+                slot = &(*root_ = std::move(value));
+            else if (reader_.nodes_.back()->type() == arrayValue)
+                slot = &reader_.nodes_.back()->append(std::move(value));
+            else
+                slot = &(*reader_.member_ = std::move(value));
+            if (reader_.collectingComments()) {
+                if (!reader_.commentsBefore_.empty()) {
+                    slot->setComment(reader_.commentsBefore_, commentBefore);
+                    reader_.commentsBefore_ = "";
+                }
+                reader_.lastValue_ = slot;
+            }
+            return *slot;
+        }
+
+        bool endContainer() {
+            if (reader_.collectingComments())
+                reader_.lastValue_ = reader_.nodes_.back();
+            // The references of the builder into the container are no longer used.
+            reader_.nodes_.back()->unpin();
+            reader_.nodes_.pop_back();
+            return true;
+        }
+
+        BasicReader& reader_;
+        Value* root_;
+    };
+
+    // Class BasicReader
+    // //////////////////////////////////////////////////////////////////
+
+    template <typename Policy>
+    BasicReader<Policy>::BasicReader(const Features& features) :
+        nodes_{}, member_{ nullptr }, containers_{}, errors_{}, document_{}, begin_{ nullptr }, end_{ nullptr }, current_{ nullptr }, lastValueEnd_{ nullptr },
+        lastValue_{ nullptr }, commentsBefore_{}, features_{ features }, keys_{}, arena_{ nullptr }, handler_{ nullptr }, stringBuffer_{}, invalidString_{ nullptr }, statistics_{},
+        collectComments_{ false }, inSitu_{ false }, pendingName_{}, resumeState_{ resumeValue }, streaming_{ false }, suspended_{ false } {}
+
+    template <typename Policy>
+    bool BasicReader<Policy>::parse(const std::string& document, Value& root, bool collectComments) {
+        return parse(document.data(), document.data() + document.length(), root, collectComments);
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::parse(const std::string& document, Document& doc, bool collectComments) {
+        return parse(document.data(), document.data() + document.length(), doc, collectComments);
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::parse(const char* beginDoc, const char* endDoc, Document& doc, bool collectComments) {
+        doc.clear();
+        arena_ = &doc.arena();
+        bool successful = parse(beginDoc, endDoc, doc.root(), collectComments);
+        arena_ = nullptr;
+        return successful;
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::parseFile(const std::string& path, Value& root, bool collectComments) {
+        MappedFile file;
+        return openFile(file, path) && parse(file.begin(), file.end(), root, collectComments);
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::parseFile(const std::string& path, Document& doc, bool collectComments) {
+        MappedFile file;
+        return openFile(file, path) && parse(file.begin(), file.end(), doc, collectComments);
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::openFile(MappedFile& file, const std::string& path) {
+        if (file.open(path))
+            return true;
+        begin_ = end_ = current_ = nullptr;
+        errors_.clear();
+        Token token(tokenError, nullptr, nullptr);
+        addError("Unable to read file '" + path + "'.", token);
+        locateErrors();
+        return false;
     }
 
-    bool Reader::parse(std::istream& sin, Value& root, bool collectComments) {
+    template <typename Policy>
+    bool BasicReader<Policy>::parse(std::istream& sin, Value& root, bool collectComments) {
         // std::istream_iterator<char> begin(sin);
         // std::istream_iterator<char> end;
         //  Those would allow streamed input from a file, if parse() were a
         //  template function.
 
-        // Since std::string is reference-counted, this at least does not
-        // create an extra copy.
-        std::string doc;
-        std::getline(sin, doc, (char)EOF);
-        return parse(doc, root, collectComments);
+        // Read straight into document_ so that the input is only copied once.
+        document_.clear();
+        std::getline(sin, document_, (char)EOF);
+        const char* begin = document_.c_str();
+        const char* end = begin + document_.length();
+        return parse(begin, end, root, collectComments);
     }
 
-    bool Reader::parse(const char* beginDoc, const char* endDoc, Value& root, bool collectComments) {
-        if (!features_.allowComments_) {
-            collectComments = false;
-        }
+    template <typename Policy>
+    bool BasicReader<Policy>::parse(const char* beginDoc, const char* endDoc, Value& root, bool collectComments) {
+        inSitu_ = false;
+        return readDocument(beginDoc, endDoc, root, collectComments);
+    }
 
-        begin_ = beginDoc;
-        end_ = endDoc;
+    template <typename Policy>
+    bool BasicReader<Policy>::parseInSitu(char* beginDoc, char* endDoc, Value& root, bool collectComments) {
+        inSitu_ = true;
+        bool successful = readDocument(beginDoc, endDoc, root, collectComments);
+        inSitu_ = false;
+        return successful;
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::parse(const char* beginDoc, const char* endDoc, Handler& handler) {
+        collectComments_ = false;
+        return readDocument(beginDoc, endDoc, handler);
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::readDocument(const char* beginDoc, const char* endDoc, Value& root, bool collectComments) {
         collectComments_ = collectComments;
-        current_ = begin_;
         lastValueEnd_ = 0;
         lastValue_ = 0;
         commentsBefore_ = "";
+        nodes_.clear();
+
+        ValueBuilder builder(*this, root);
+        bool successful = readDocument(beginDoc, endDoc, builder);
+        if (collectingComments() && !commentsBefore_.empty())
+            root.setComment(commentsBefore_, commentAfter);
+        return successful;
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::readDocument(const char* beginDoc, const char* endDoc, Handler& handler) {
+        JSONCPP_STATISTICS(StatisticsScope statistics(statistics_, Statistics::phaseParse));
+        begin_ = beginDoc;
+        end_ = endDoc;
+        current_ = begin_;
+        handler_ = &handler;
+        invalidString_ = nullptr;
+        containers_.clear();
         errors_.clear();
-        while (!nodes_.empty())
-            nodes_.pop();
-        nodes_.push(&root);
 
-        bool successful = readValue();
         Token token;
         skipCommentTokens(token);
-        if (collectComments_ && !commentsBefore_.empty())
-            root.setComment(commentsBefore_, commentAfter);
-        if (features_.strictRoot_) {
-            if (!root.isArray() && !root.isObject()) {
+        TokenType rootType = token.type_;
+        bool successful = readValue(token);
+        skipCommentTokens(token);
+        handler_ = nullptr;
+        JSONCPP_STATISTICS(statistics_.bytes_ = size_t(current_ - begin_));
+        if (Policy::strictRoot(features_)) {
+            if (rootType != tokenArrayBegin && rootType != tokenObjectBegin) {
                 // Set error location to start of doc, ideally should be first token found in doc
                 token.type_ = tokenError;
                 token.start_ = beginDoc;
                 token.end_ = endDoc;
                 addError("A valid JSON document must be either an array or an object value.", token);
-                return false;
+                successful = false;
             }
         }
+        if (!errors_.empty())
+            locateErrors();
         return successful;
     }
 
-    bool Reader::readValue() {
-        Token token;
-        skipCommentTokens(token);
-        bool successful = true;
+    /* Reads the value starting with token, and all its descendants, in a single loop:
+     * containers_ replaces the call stack. Each iteration reads one value; when the value
+     * is complete, the separators and closing tokens that follow it are read up to the
+     * first token of the next value. If complete, the value has already been read and
+     * the loop starts with the tokens that follow it.
+     */
+    template <typename Policy>
+    bool BasicReader<Policy>::readValue(Token& token, bool complete) {
+        for (;; complete = false) {
+            if (!complete) {
+                JSONCPP_STATISTICS(++statistics_.nodes_);
+                switch (token.type_) {
+                    case tokenObjectBegin:
+                        if (!enterContainer(token, tokenObjectEnd) || !nextToken(token, resumeFirstMember))
+                            return unwind();
+                        if (token.type_ != tokenObjectEnd) { // not an empty object
+                            if (!readMember(token))
+                                return unwind();
+                            continue;
+                        }
+                        if (!leaveContainer(token))
+                            return unwind();
+                        break;
+                    case tokenArrayBegin:
+                        if (!enterContainer(token, tokenArrayEnd))
+                            return unwind();
+                        skipSpaces();
+                        if (current_ == end_ && streaming_)
+                            return suspend(current_, resumeFirstItem);
+                        if (current_ == end_ || *current_ != ']') { // not an empty array
+                            if (!nextToken(token, resumeValue))
+                                return unwind();
+                            continue;
+                        }
+                        readToken(token);
+                        if (!leaveContainer(token))
+                            return unwind();
+                        break;
+                    case tokenNumber:
+                        if (!decodeNumber(token))
+                            return unwind();
+                        break;
+                    case tokenString: {
+                        std::string_view decoded;
+                        if (!decodeString(token, decoded) || !checkHandler(handler_->value(decoded), token))
+                            return unwind();
+                    } break;
+                    case tokenTrue:
+                        if (!checkHandler(handler_->value(true), token))
+                            return unwind();
+                        break;
+                    case tokenFalse:
+                        if (!checkHandler(handler_->value(false), token))
+                            return unwind();
+                        break;
+                    case tokenNull:
+                        if (!checkHandler(handler_->value(nullptr), token))
+                            return unwind();
+                        break;
+                    default:
+                        addError("Syntax error: value, object or array expected.", token);
+                        return unwind();
+                }
+            }
 
-        if (collectComments_ && !commentsBefore_.empty()) {
-            currentValue().setComment(commentsBefore_, commentBefore);
-            commentsBefore_ = "";
+            for (;;) {
+                if (collectingComments())
+                    lastValueEnd_ = current_;
+                if (containers_.empty())
+                    return true;
+                // Accept comments after the last item of the container.
+                if (!nextToken(token, resumeSeparator))
+                    return unwind();
+                if (token.type_ == tokenArraySeparator) {
+                    bool inObject = containers_.back() == tokenObjectEnd;
+                    if (!nextToken(token, inObject ? resumeMember : resumeValue) || (inObject && !readMember(token)))
+                        return unwind();
+                    break;
+                }
+                if (token.type_ != containers_.back()) {
+                    if (containers_.back() == tokenObjectEnd)
+                        addError("Missing ',' or '}' in object declaration", token);
+                    else
+                        addError("Missing ',' or ']' in array declaration", token);
+                    return unwind();
+                }
+                if (!leaveContainer(token))
+                    return unwind();
+            }
         }
+    }
 
-        switch (token.type_) {
-            case tokenObjectBegin:
-                successful = readObject(token);
-                break;
-            case tokenArrayBegin:
-                successful = readArray(token);
-                break;
-            case tokenNumber:
-                successful = decodeNumber(token);
-                break;
-            case tokenString:
-                successful = decodeString(token);
-                break;
-            case tokenTrue:
-                currentValue() = true;
-                break;
-            case tokenFalse:
-                currentValue() = false;
-                break;
-            case tokenNull:
-                currentValue() = Value();
-                break;
-            default:
-                return addError("Syntax error: value, object or array expected.", token);
-        }
+    /* Reads the object member whose name is token, up to the first token of its value,
+     * which is stored in token.
+     */
+    template <typename Policy>
+    bool BasicReader<Policy>::readMember(Token& token) {
+        if (token.type_ != tokenString)
+            return addError("Missing '}' or object member name", token);
+        std::string_view name;
+        if (!decodeString(token, name))
+            return false;
+        return readMemberValue(name, token);
+    }
 
-        if (collectComments_) {
-            lastValueEnd_ = current_;
-            lastValue_ = &currentValue();
+    /* Reads the ':' that follows the member name, then the first token of the member's value,
+     * which is stored in token. On entry, token locates the errors of the handler.
+     */
+    template <typename Policy>
+    bool BasicReader<Policy>::readMemberValue(std::string_view name, Token& token) {
+        Token colon;
+        readToken(colon);
+        if (streaming_ && truncated(colon)) {
+            // name may reference the input, which is not kept.
+            pendingName_ = std::string(name);
+            return suspend(colon.start_, resumeColon);
         }
+        if (colon.type_ != tokenMemberSeparator)
+            return addError("Missing ':' after object member name", colon);
+        if (!checkHandler(handler_->key(name), token))
+            return false;
+        return nextToken(token, resumeValue);
+    }
 
-        return successful;
+    template <typename Policy>
+    bool BasicReader<Policy>::enterContainer(Token& token, TokenType closingType) {
+        if (containers_.size() >= features_.maxDepth_)
+            return addError("Exceeded the maximum nesting depth of arrays and objects (" + std::to_string(features_.maxDepth_) + ").", token);
+        bool accepted = closingType == tokenObjectEnd ? handler_->startObject() : handler_->startArray();
+        if (!checkHandler(accepted, token))
+            return false;
+        containers_.push_back(closingType);
+        JSONCPP_STATISTICS(statistics_.enterContainer());
+        return true;
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::leaveContainer(Token& token) {
+        bool accepted = containers_.back() == tokenObjectEnd ? handler_->endObject() : handler_->endArray();
+        containers_.pop_back();
+        JSONCPP_STATISTICS(statistics_.leaveContainer());
+        return checkHandler(accepted, token);
     }
 
-    void Reader::skipCommentTokens(Token& token) {
-        if (features_.allowComments_) {
+    /* Skips the rest of each container being read, from the innermost, after an error,
+     * unless features_.failFast_. Always returns false. A suspended parse is left as is.
+     */
+    template <typename Policy>
+    bool BasicReader<Policy>::unwind() {
+        if (suspended_)
+            return false;
+        if (features_.failFast_) {
+            containers_.clear();
+            return false;
+        }
+        for (; !containers_.empty(); containers_.pop_back()) {
+            recoverFromError(containers_.back());
+            JSONCPP_STATISTICS(statistics_.leaveContainer());
+        }
+        return false;
+    }
+
+    template <typename Policy>
+    void BasicReader<Policy>::skipCommentTokens(Token& token) {
+        if (Policy::allowComments(features_)) {
             do {
                 readToken(token);
             } while (token.type_ == tokenComment);
@@ -171,14 +575,141 @@ namespace Json {
         }
     }
 
-    bool Reader::expectToken(TokenType type, Token& token, const char* message) {
+    /* Reads the next token that is not a comment, as skipCommentTokens() does. While
+     * streaming_, a token that may continue past end_ suspends the parse in state instead,
+     * before the token: the token is read again once the rest of it has been received.
+     */
+    template <typename Policy>
+    bool BasicReader<Policy>::nextToken(Token& token, ResumeState state) {
+        if (!streaming_) {
+            skipCommentTokens(token);
+            return true;
+        }
+        do {
+            readToken(token);
+            if (truncated(token))
+                return suspend(token.start_, state);
+        } while (token.type_ == tokenComment);
+        return true;
+    }
+
+    // Whether more input could change token, which was read up to end_.
+    template <typename Policy>
+    bool BasicReader<Policy>::truncated(const Token& token) const {
+        switch (token.type_) {
+            case tokenEndOfStream:
+                return token.start_ == end_;
+            case tokenNumber:
+                return token.end_ == end_;
+            case tokenComment:
+                // Only a C++ style comment ends with the line.
+                return token.end_ == end_ && token.start_[1] == '/' && end_[-1] != '\n' && end_[-1] != '\r';
+            case tokenError: {
+                // An unterminated string or comment, or the beginning of a literal.
+                if (token.end_ == end_)
+                    return true;
+                std::string_view rest(token.start_, size_t(end_ - token.start_));
+                return std::string_view("true").starts_with(rest) || std::string_view("false").starts_with(rest) ||
+                       std::string_view("null").starts_with(rest);
+            }
+            default:
+                return false;
+        }
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::suspend(Location location, ResumeState state) {
+        current_ = location;
+        resumeState_ = state;
+        suspended_ = true;
+        return false;
+    }
+
+    /* Continues a suspended parse with its next token, as expected in resumeState_,
+     * then with the value loop.
+     */
+    template <typename Policy>
+    bool BasicReader<Policy>::resume() {
+        Token token;
+        switch (resumeState_) {
+            case resumeValue:
+                if (!nextToken(token, resumeValue))
+                    return unwind();
+                if (containers_.empty() && Policy::strictRoot(features_) && token.type_ != tokenArrayBegin && token.type_ != tokenObjectBegin)
+                    return addError("A valid JSON document must be either an array or an object value.", token);
+                return readValue(token);
+            case resumeFirstMember:
+                if (!nextToken(token, resumeFirstMember))
+                    return unwind();
+                if (token.type_ == tokenObjectEnd)
+                    return leaveContainer(token) ? readValue(token, true) : unwind();
+                return readMember(token) ? readValue(token) : unwind();
+            case resumeMember:
+                if (!nextToken(token, resumeMember) || !readMember(token))
+                    return unwind();
+                return readValue(token);
+            case resumeColon:
+                token = Token(tokenString, current_, current_);
+                return readMemberValue(pendingName_, token) ? readValue(token) : unwind();
+            case resumeFirstItem:
+                skipSpaces();
+                if (current_ == end_ && streaming_)
+                    return suspend(current_, resumeFirstItem);
+                if (current_ == end_ || *current_ != ']')
+                    return nextToken(token, resumeValue) ? readValue(token) : unwind();
+                readToken(token);
+                return leaveContainer(token) ? readValue(token, true) : unwind();
+            case resumeSeparator:
+                return readValue(token, true);
+        }
+        return false;
+    }
+
+    template <typename Policy>
+    void BasicReader<Policy>::startDocument() {
+        nodes_.clear();
+        member_ = nullptr;
+        containers_.clear();
+        errors_.clear();
+        resumeState_ = resumeValue;
+    }
+
+    /* Parses [beginDoc, endDoc) from current, where the last call suspended the parse,
+     * or from the first value after startDocument(), into root. Unless last, a token that
+     * may continue past endDoc suspends the parse: false is returned, with suspended_ set
+     * and current_ on the token. Comments are not collected.
+     */
+    template <typename Policy>
+    bool BasicReader<Policy>::resumeDocument(Location beginDoc, Location current, Location endDoc, Value& root, bool last) {
+        begin_ = beginDoc;
+        end_ = endDoc;
+        current_ = current;
+        collectComments_ = false;
+        inSitu_ = false;
+        invalidString_ = nullptr;
+        streaming_ = !last;
+        suspended_ = false;
+        ValueBuilder builder(*this, root);
+        handler_ = &builder;
+        bool successful = resume();
+        handler_ = nullptr;
+        streaming_ = false;
+        if (!errors_.empty())
+            locateErrors();
+        return successful;
+    }
+
+    template <typename Policy>
+    bool BasicReader<Policy>::expectToken(TokenType type, Token& token, const char* message) {
         readToken(token);
         if (token.type_ != type)
             return addError(message, token);
         return true;
     }
 
-    bool Reader::readToken(Token& token) {
+    template <typename Policy>
+    bool BasicReader<Policy>::readToken(Token& token) {
+        JSONCPP_STATISTICS(++statistics_.tokens_);
         skipSpaces();
         token.start_ = current_;
         Char c = getNextChar();
@@ -198,11 +729,11 @@ namespace Json {
                 break;
             case '"':
                 token.type_ = tokenString;
-                ok = readString();
+                ok = readString(token.escaped_);
                 break;
             case '/':
                 token.type_ = tokenComment;
-                ok = readComment();
+                ok = Policy::allowComments(features_) && readComment();
                 break;
             case '0':
             case '1':
@@ -249,17 +780,13 @@ namespace Json {
         return true;
     }
 
-    void Reader::skipSpaces() {
-        while (current_ != end_) {
-            Char c = *current_;
-            if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
-                ++current_;
-            else
-                break;
-        }
+    template <typename Policy>
+    void BasicReader<Policy>::skipSpaces() {
+        current_ = skipWhitespace(current_, end_);
     }
 
-    bool Reader::match(Location pattern, int patternLength) {
+    template <typename Policy>
+    bool BasicReader<Policy>::match(Location pattern, int patternLength) {
         if (end_ - current_ < patternLength)
             return false;
         int index = patternLength;
@@ -270,7 +797,8 @@ namespace Json {
         return true;
     }
 
-    bool Reader::readComment() {
+    template <typename Policy>
+    bool BasicReader<Policy>::readComment() {
         Location commentBegin = current_ - 1;
         Char c = getNextChar();
         bool successful = false;
@@ -281,7 +809,7 @@ namespace Json {
         if (!successful)
             return false;
 
-        if (collectComments_) {
+        if (collectingComments()) {
             CommentPlacement placement = commentBefore;
             if (lastValueEnd_ && !containsNewLine(lastValueEnd_, commentBegin)) {
                 if (c != '*' || !containsNewLine(commentBegin, current_))
@@ -293,8 +821,9 @@ namespace Json {
         return true;
     }
 
-    void Reader::addComment(Location begin, Location end, CommentPlacement placement) {
-        assert(collectComments_);
+    template <typename Policy>
+    void BasicReader<Policy>::addComment(Location begin, Location end, CommentPlacement placement) {
+        assert(collectingComments());
         if (placement == commentAfterOnSameLine) {
             assert(lastValue_ != 0);
             lastValue_->setComment(std::string(begin, end), placement);
@@ -305,7 +834,8 @@ namespace Json {
         }
     }
 
-    bool Reader::readCStyleComment() {
+    template <typename Policy>
+    bool BasicReader<Policy>::readCStyleComment() {
         while (current_ != end_) {
             Char c = getNextChar();
             if (c == '*' && *current_ == '/')
@@ -314,7 +844,8 @@ namespace Json {
         return getNextChar() == '/';
     }
 
-    bool Reader::readCppStyleComment() {
+    template <typename Policy>
+    bool BasicReader<Policy>::readCppStyleComment() {
         while (current_ != end_) {
             Char c = getNextChar();
             if (c == '\r' || c == '\n')
@@ -323,7 +854,8 @@ namespace Json {
         return true;
     }
 
-    void Reader::readNumber() {
+    template <typename Policy>
+    void BasicReader<Policy>::readNumber() {
         while (current_ != end_) {
             if (!(*current_ >= '0' && *current_ <= '9') && !in(*current_, '.', 'e', 'E', '+', '-'))
                 break;
@@ -331,96 +863,50 @@ namespace Json {
         }
     }
 
-    bool Reader::readString() {
-        Char c = 0;
-        while (current_ != end_) {
-            c = getNextChar();
-            if (c == '\\')
-                getNextChar();
-            else if (c == '"')
-                break;
-        }
-        return c == '"';
-    }
-
-    bool Reader::readObject(Token& /*tokenStart*/) {
-        Token tokenName;
-        std::string name;
-        currentValue() = Value(objectValue);
-        while (readToken(tokenName)) {
-            bool initialTokenOk = true;
-            while (tokenName.type_ == tokenComment && initialTokenOk)
-                initialTokenOk = readToken(tokenName);
-            if (!initialTokenOk)
-                break;
-            if (tokenName.type_ == tokenObjectEnd && name.empty()) // empty object
-                return true;
-            if (tokenName.type_ != tokenString)
-                break;
-
-            name = "";
-            if (!decodeString(tokenName, name))
-                return recoverFromError(tokenObjectEnd);
-
-            Token colon;
-            if (!readToken(colon) || colon.type_ != tokenMemberSeparator) {
-                return addErrorAndRecover("Missing ':' after object member name", colon, tokenObjectEnd);
-            }
-            Value& value = currentValue()[name];
-            nodes_.push(&value);
-            bool ok = readValue();
-            nodes_.pop();
-            if (!ok) // error already set
-                return recoverFromError(tokenObjectEnd);
-
-            Token comma;
-            if (!readToken(comma) || (comma.type_ != tokenObjectEnd && comma.type_ != tokenArraySeparator && comma.type_ != tokenComment)) {
-                return addErrorAndRecover("Missing ',' or '}' in object declaration", comma, tokenObjectEnd);
-            }
-            bool finalizeTokenOk = true;
-            while (comma.type_ == tokenComment && finalizeTokenOk)
-                finalizeTokenOk = readToken(comma);
-            if (comma.type_ == tokenObjectEnd)
+    template <typename Policy>
+    bool BasicReader<Policy>::readString(bool& escaped) {
+        escaped = false;
+        if (features_.strictUtf8_)
+            return readUtf8String(escaped);
+        for (;;) {
+            current_ = findQuoteOrBackslash(current_, end_);
+            if (current_ == end_)
+                return false;
+            if (*current_++ == '"')
                 return true;
+            if (current_ == end_) // '\\' ends the document
+                return false;
+            escaped = true;
+            ++current_; // skip escaped character
         }
-        return addErrorAndRecover("Missing '}' or object member name", tokenName, tokenObjectEnd);
     }
 
-    bool Reader::readArray(Token& /*tokenStart*/) {
-        currentValue() = Value(arrayValue);
-        skipSpaces();
-        if (*current_ == ']') // empty array
-        {
-            Token endArray;
-            readToken(endArray);
-            return true;
-        }
-        int index = 0;
+    /* Reads a string like readString(), validating its UTF-8 in the same scan. The string
+     * is reported as invalid by decodeString(), which knows whether it is a value or a
+     * member name.
+     */
+    template <typename Policy>
+    bool BasicReader<Policy>::readUtf8String(bool& escaped) {
+        Location quote = current_ - 1;
+        bool valid = true;
         for (;;) {
-            Value& value = currentValue()[index++];
-            nodes_.push(&value);
-            bool ok = readValue();
-            nodes_.pop();
-            if (!ok) // error already set
-                return recoverFromError(tokenArrayEnd);
-
-            Token token;
-            // Accept Comment after last item in the array.
-            ok = readToken(token);
-            while (token.type_ == tokenComment && ok) {
-                ok = readToken(token);
-            }
-            bool badTokenType = (token.type_ != tokenArraySeparator && token.type_ != tokenArrayEnd);
-            if (!ok || badTokenType) {
-                return addErrorAndRecover("Missing ',' or ']' in array declaration", token, tokenArrayEnd);
-            }
-            if (token.type_ == tokenArrayEnd)
+            current_ = findQuoteOrBackslash(current_, end_, valid);
+            if (current_ == end_)
+                return false;
+            if (*current_++ == '"')
                 break;
+            if (current_ == end_) // '\\' ends the document
+                return false;
+            escaped = true;
+            ++current_; // skip escaped character
         }
+        if (!valid)
+            invalidString_ = quote;
         return true;
     }
 
-    bool Reader::decodeNumber(Token& token) {
+    template <typename Policy>
+    bool BasicReader<Policy>::decodeNumber(Token& token) {
         bool isDouble = false;
         for (Location inspect = token.start_; inspect != token.end_; ++inspect) {
             isDouble = isDouble || in(*inspect, '.', 'e', 'E', '+') || (*inspect == '-' && inspect != token.start_);
@@ -434,7 +920,9 @@ namespace Json {
         bool isNegative = *current == '-';
         if (isNegative)
             ++current;
-        Value::LargestUInt maxIntegerValue = isNegative ? Value::LargestUInt(-Value::minLargestInt) : Value::maxLargestUInt;
+        if (current == token.end_)
+            return addError("'" + std::string(token.start_, token.end_) + "' is not a number.", token);
+        Value::LargestUInt maxIntegerValue = isNegative ? Value::LargestUInt(Value::maxLargestInt) + 1 : Value::maxLargestUInt;
         Value::LargestUInt threshold = maxIntegerValue / 10;
         Value::UInt lastDigitThreshold = Value::UInt(maxIntegerValue % 10);
         assert(lastDigitThreshold >= 0 && lastDigitThreshold <= 9);
@@ -445,58 +933,67 @@ namespace Json {
                 return addError("'" + std::string(token.start_, token.end_) + "' is not a number.", token);
             Value::UInt digit(c - '0');
             if (value >= threshold) {
-                // If the current digit is not the last one, or if it is
-                // greater than the last digit of the maximum integer value,
-                // the parse the number as a double.
-                if (current != token.end_ || digit > lastDigitThreshold) {
+                // If the value already exceeds the threshold, if the current digit
+                // is not the last one, or if it is greater than the last digit of
+                // the maximum integer value, the parse the number as a double.
+                if (value > threshold || current != token.end_ || digit > lastDigitThreshold) {
                     return decodeDouble(token);
                 }
             }
             value = value * 10 + digit;
         }
         if (isNegative)
-            currentValue() = -Value::LargestInt(value);
-        else if (value <= Value::LargestUInt(Value::maxInt))
-            currentValue() = Value::LargestInt(value);
+            return checkHandler(handler_->value(Value::LargestInt(0 - value)), token);
+        else if (value <= Value::LargestUInt(Value::maxLargestInt))
+            return checkHandler(handler_->value(Value::LargestInt(value)), token);
         else
-            currentValue() = value;
-        return true;
+            return checkHandler(handler_->value(value), token);
     }
 
-    bool Reader::decodeDouble(Token& token) {
+    template <typename Policy>
+    bool BasicReader<Policy>::decodeDouble(Token& token) {
+        // std::from_chars is correctly rounded, works in place on the token and
+        // ignores the locale (sscanf expects a ',' decimal separator in de_DE).
         double value = 0;
-        const int bufferSize = 32;
-        int count;
-        int length = int(token.end_ - token.start_);
-        if (length <= bufferSize) {
-            Char buffer[bufferSize + 1];
-            memcpy(buffer, token.start_, length);
-            buffer[length] = 0;
-            count = sscanf(buffer, "%lf", &value);
-        } else {
-            std::string buffer(token.start_, token.end_);
-            count = sscanf(buffer.c_str(), "%lf", &value);
-        }
-
-        if (count != 1)
+        std::from_chars_result result = std::from_chars(token.start_, token.end_, value);
+        if (result.ec == std::errc::result_out_of_range && result.ptr == token.end_)
+            value = outOfRangeDouble(token.start_, token.end_);
+        else if (result.ec != std::errc() || result.ptr != token.end_)
             return addError("'" + std::string(token.start_, token.end_) + "' is not a number.", token);
-        currentValue() = value;
-        return true;
+        return checkHandler(handler_->value(value), token);
     }
 
-    bool Reader::decodeString(Token& token) {
-        std::string decoded;
-        if (!decodeString(token, decoded))
+    template <typename Policy>
+    bool BasicReader<Policy>::decodeString(Token& token, std::string_view& decoded) {
+        if (token.start_ == invalidString_)
+            return addError("Invalid UTF-8 sequence in string", token, findInvalidUtf8(token.start_ + 1, token.end_ - 1));
+        Location begin = token.start_ + 1; // skip '"'
+        size_t length = token.end_ - token.start_ - 2;
+        if (!token.escaped_) {
+            // Nothing to unescape: reference the document.
+            decoded = std::string_view(begin, length);
+            JSONCPP_STATISTICS(statistics_.stringBytes_ += length);
+            return true;
+        }
+        stringBuffer_.clear();
+        if (!decodeString(token, stringBuffer_))
             return false;
-        currentValue() = decoded;
+        decoded = stringBuffer_;
+        JSONCPP_STATISTICS(statistics_.stringBytes_ += decoded.length());
         return true;
     }
 
-    bool Reader::decodeString(Token& token, std::string& decoded) {
+    template <typename Policy>
+    bool BasicReader<Policy>::decodeString(Token& token, std::string& decoded) {
         decoded.reserve(token.end_ - token.start_ - 2);
         Location current = token.start_ + 1; // skip '"'
         Location end = token.end_ - 1;       // do not include '"'
         while (current != end) {
+            Location special = findQuoteOrBackslash(current, end);
+            decoded.append(current, special);
+            current = special;
+            if (current == end)
+                break;
             Char c = *current++;
             if (c == '"')
                 break;
@@ -538,14 +1035,13 @@ namespace Json {
                     default:
                         return addError("Bad escape sequence in string", token, current);
                 }
-            } else {
-                decoded += c;
             }
         }
         return true;
     }
 
-    bool Reader::decodeUnicodeCodePoint(Token& token, Location& current, Location end, unsigned int& unicode) {
+    template <typename Policy>
+    bool BasicReader<Policy>::decodeUnicodeCodePoint(Token& token, Location& current, Location end, unsigned int& unicode) {
 
         if (!decodeUnicodeEscapeSequence(token, current, end, unicode))
             return false;
@@ -556,16 +1052,20 @@ namespace Json {
             unsigned int surrogatePair;
             if (*(current++) == '\\' && *(current++) == 'u') {
                 if (decodeUnicodeEscapeSequence(token, current, end, surrogatePair)) {
+                    if (features_.strictUtf8_ && (surrogatePair < 0xDC00 || surrogatePair > 0xDFFF))
+                        return addError("Unpaired unicode surrogate in string.", token, current);
                     unicode = 0x10000 + ((unicode & 0x3FF) << 10) + (surrogatePair & 0x3FF);
                 } else
                     return false;
             } else
                 return addError("expecting another \\u token to begin the second half of a unicode surrogate pair", token, current);
-        }
+        } else if (features_.strictUtf8_ && unicode >= 0xDC00 && unicode <= 0xDFFF)
+            return addError("Unpaired unicode surrogate in string.", token, current);
         return true;
     }
 
-    bool Reader::decodeUnicodeEscapeSequence(Token& token, Location& current, Location end, unsigned int& unicode) {
+    template <typename Policy>
+    bool BasicReader<Policy>::decodeUnicodeEscapeSequence(Token& token, Location& current, Location end, unsigned int& unicode) {
         if (end - current < 4)
             return addError("Bad unicode escape sequence in string: four digits expected.", token, current);
         unicode = 0;
@@ -584,12 +1084,14 @@ namespace Json {
         return true;
     }
 
-    bool Reader::addError(const std::string& message, Token& token, Location extra) {
+    template <typename Policy>
+    bool BasicReader<Policy>::addError(const std::string& message, Token& token, Location extra) {
         errors_.emplace_back(token, message, extra);
         return false;
     }
 
-    bool Reader::recoverFromError(TokenType skipUntilToken) {
+    template <typename Policy>
+    bool BasicReader<Policy>::recoverFromError(TokenType skipUntilToken) {
         int errorCount = int(errors_.size());
         Token skip;
         for (;;) {
@@ -602,67 +1104,707 @@ namespace Json {
         return false;
     }
 
-    bool Reader::addErrorAndRecover(const std::string& message, Token& token, TokenType skipUntilToken) {
-        addError(message, token);
-        return recoverFromError(skipUntilToken);
-    }
-
-    Value& Reader::currentValue() {
-        return *(nodes_.top());
+    template <typename Policy>
+    bool BasicReader<Policy>::checkHandler(bool accepted, Token& token) {
+        if (!accepted)
+            return addError("Parsing aborted by handler.", token);
+        return true;
     }
 
-    Reader::Char Reader::getNextChar() {
+    template <typename Policy>
+    typename BasicReader<Policy>::Char BasicReader<Policy>::getNextChar() {
         if (current_ == end_)
             return 0;
         return *current_++;
     }
 
-    void Reader::getLocationLineAndColumn(Location location, int& line, int& column) const {
+    /* Locates the start and the extra location of every error, in a single pass over
+     * the document whatever the number of errors, while the document is available.
+     * Location 2 * i is the start of errors_[i], location 2 * i + 1 its extra location.
+     */
+    template <typename Policy>
+    void BasicReader<Policy>::locateErrors() {
+        std::vector<std::pair<Location, size_t>> locations;
+        locations.reserve(2 * errors_.size());
+        for (size_t index = 0; index < errors_.size(); ++index) {
+            ErrorInfo& error = errors_[index];
+            error.offsetStart_ = size_t(error.token_.start_ - begin_);
+            error.offsetLimit_ = std::max(error.offsetStart_, size_t(error.token_.end_ - begin_));
+            locations.emplace_back(error.token_.start_, 2 * index);
+            if (error.extra_)
+                locations.emplace_back(error.extra_, 2 * index + 1);
+        }
+        std::sort(locations.begin(), locations.end());
+
         Location current = begin_;
         Location lastLineStart = current;
-        line = 0;
-        while (current < location && current != end_) {
-            Char c = *current++;
-            if (c == '\r') {
-                if (*current == '\n')
-                    ++current;
-                lastLineStart = current;
-                ++line;
-            } else if (c == '\n') {
-                lastLineStart = current;
-                ++line;
+        int line = 0;
+        for (const auto& [location, slot] : locations) {
+            while (current < location && current != end_) {
+                Char c = *current++;
+                if (c == '\r') {
+                    if (current != end_ && *current == '\n')
+                        ++current;
+                    lastLineStart = current;
+                    ++line;
+                } else if (c == '\n') {
+                    lastLineStart = current;
+                    ++line;
+                }
             }
+            // column & line start at 1
+            ErrorInfo& error = errors_[slot / 2];
+            (slot % 2 == 0 ? error.lineColumn_ : error.extraLineColumn_) = { line + 1, int(location - lastLineStart) + 1 };
         }
-        // column & line start at 1
-        column = int(location - lastLineStart) + 1;
-        ++line;
     }
 
-    std::string Reader::getLocationLineAndColumn(Location location) const {
-        int line, column;
-        getLocationLineAndColumn(location, line, column);
-        char buffer[18 + 16 + 16 + 1];
-        sprintf(buffer, "Line %d, Column %d", line, column);
-        return buffer;
+    static std::string formatLocation(const std::pair<int, int>& lineColumn) {
+        return "Line " + std::to_string(lineColumn.first) + ", Column " + std::to_string(lineColumn.second);
     }
 
     // Deprecated. Preserved for backward compatibility
-    std::string Reader::getFormatedErrorMessages() const {
+    template <typename Policy>
+    std::string BasicReader<Policy>::getFormatedErrorMessages() const {
         return getFormattedErrorMessages();
     }
 
-    std::string Reader::getFormattedErrorMessages() const {
+    template <typename Policy>
+    std::string BasicReader<Policy>::getFormattedErrorMessages() const {
         std::string formattedMessage;
-        for (Errors::const_iterator itError = errors_.begin(); itError != errors_.end(); ++itError) {
-            const ErrorInfo& error = *itError;
-            formattedMessage += "* " + getLocationLineAndColumn(error.token_.start_) + "\n";
+        for (const ErrorInfo& error : errors_) {
+            formattedMessage += "* " + formatLocation(error.lineColumn_) + "\n";
             formattedMessage += "  " + error.message_ + "\n";
             if (error.extra_)
-                formattedMessage += "See " + getLocationLineAndColumn(error.extra_) + " for detail.\n";
+                formattedMessage += "See " + formatLocation(error.extraLineColumn_) + " for detail.\n";
         }
         return formattedMessage;
     }
 
+    template <typename Policy>
+    std::vector<StructuredError> BasicReader<Policy>::getStructuredErrors() const {
+        std::vector<StructuredError> errors(errors_.size());
+        for (size_t index = 0; index < errors_.size(); ++index) {
+            const ErrorInfo& info = errors_[index];
+            StructuredError& error = errors[index];
+            error.offsetStart_ = info.offsetStart_;
+            error.offsetLimit_ = info.offsetLimit_;
+            error.line_ = info.lineColumn_.first;
+            error.column_ = info.lineColumn_.second;
+            error.message_ = info.message_;
+        }
+        return errors;
+    }
+
+    template <typename Policy>
+    const Statistics& BasicReader<Policy>::getStatistics() const {
+        return statistics_;
+    }
+
+    template class BasicReader<FeaturesPolicy>;
+    template class BasicReader<StrictPolicy>;
+
+    // Class IncrementalReader
+    // //////////////////////////////////////////////////////////////////
+
+    IncrementalReader::IncrementalReader(const Features& features) :
+        reader_{ features }, values_{}, root_{}, buffer_{}, errors_{}, scanned_{ 0 }, documentBegin_{ 0 }, parsed_{ 0 }, resumed_{ 0 }, discardedLines_{ 0 },
+        discardedColumns_{ 0 }, state_{ scanSpace }, allowComments_{ features.allowComments_ }, inDocument_{ false }, failed_{ false } {}
+
+    bool IncrementalReader::feed(const char* data, size_t length) {
+        if (failed_)
+            return false;
+        // The input that precedes the pending token, or the next document, is dropped once
+        // it outweighs the rest, so that each byte is moved at most once on average,
+        // however it is fed.
+        size_t consumed = inDocument_ ? parsed_ : documentBegin_;
+        if (consumed != 0 && consumed >= buffer_.length() - consumed) {
+            if (inDocument_) {
+                // Keep a '\r' that may be followed by a '\n': both end the same line.
+                if (buffer_[consumed - 1] == '\r')
+                    --consumed;
+                // Count the lines that are dropped, to locate the errors of the document.
+                for (size_t index = documentBegin_; index < consumed; ++index) {
+                    char c = buffer_[index];
+                    if (c == '\n' || (c == '\r' && buffer_[index + 1] != '\n')) {
+                        ++discardedLines_;
+                        discardedColumns_ = 0;
+                    } else
+                        ++discardedColumns_;
+                }
+                documentBegin_ = 0;
+                parsed_ -= consumed;
+                resumed_ -= consumed;
+            } else
+                documentBegin_ -= consumed;
+            buffer_.erase(0, consumed);
+            scanned_ -= consumed;
+        }
+        buffer_.append(data, length);
+        return scan();
+    }
+
+    bool IncrementalReader::finish() {
+        if (failed_)
+            return false;
+        // The input is complete: the last token of a document is read without waiting for more.
+        while (inDocument_) {
+            if (!parse(true) || !scan())
+                return false;
+        }
+        if (state_ == scanCppStyleComment)
+            state_ = scanSpace;
+        if (state_ != scanSpace)
+            return fail("Incomplete JSON document at end of stream.");
+        return true;
+    }
+
+    bool IncrementalReader::next(Value& root) {
+        if (values_.empty())
+            return false;
+        root = std::move(values_.front());
+        values_.pop_front();
+        return true;
+    }
+
+    void IncrementalReader::reset() {
+        values_.clear();
+        root_ = Value();
+        buffer_.clear();
+        errors_.clear();
+        scanned_ = 0;
+        documentBegin_ = 0;
+        parsed_ = 0;
+        resumed_ = 0;
+        discardedLines_ = 0;
+        discardedColumns_ = 0;
+        state_ = scanSpace;
+        inDocument_ = false;
+        failed_ = false;
+    }
+
+    std::string IncrementalReader::getFormattedErrorMessages() const {
+        return errors_;
+    }
+
+    // Scans the input that reader_ cannot parse yet: the spaces and comments that precede
+    // a document, and the token on which reader_ is suspended, until the token ends.
+    bool IncrementalReader::scan() {
+        while (scanned_ < buffer_.length()) {
+            Reader::Char c = buffer_[scanned_];
+            switch (state_) {
+            case scanSpace:
+                switch (c) {
+                case ' ':
+                case '\t':
+                case '\r':
+                case '\n':
+                    break;
+                case '/':
+                    if (allowComments_) {
+                        state_ = scanCommentStart;
+                        break;
+                    }
+                    [[fallthrough]];
+                default:
+                    if (!startDocument(scanned_))
+                        return false;
+                    continue;
+                }
+                break;
+            case scanString:
+                if (c == '\\')
+                    state_ = scanStringEscape;
+                else if (c == '"') {
+                    if (!parse(false))
+                        return false;
+                    continue;
+                }
+                break;
+            case scanStringEscape:
+                state_ = scanString;
+                break;
+            case scanToken:
+                switch (c) {
+                case ' ':
+                case '\t':
+                case '\r':
+                case '\n':
+                case '[':
+                case ']':
+                case '{':
+                case '}':
+                case '"':
+                case ',':
+                case ':':
+                case '/':
+                    if (!parse(false))
+                        return false;
+                    continue;
+                default:
+                    break;
+                }
+                break;
+            case scanCommentStart:
+                if (c == '*')
+                    state_ = scanCStyleComment;
+                else if (c == '/')
+                    state_ = scanCppStyleComment;
+                else {
+                    // Not a comment: let reader_ report the stray '/'.
+                    if (!(inDocument_ ? parse(false) : startDocument(scanned_ - 1)))
+                        return false;
+                    continue;
+                }
+                break;
+            case scanCStyleComment:
+                if (c == '*')
+                    state_ = scanCStyleCommentEnd;
+                break;
+            case scanCStyleCommentEnd:
+                if (c == '/') {
+                    if (inDocument_) {
+                        if (!parse(false))
+                            return false;
+                        continue;
+                    }
+                    state_ = scanSpace;
+                } else if (c != '*')
+                    state_ = scanCStyleComment;
+                break;
+            case scanCppStyleComment:
+                if (c == '\r' || c == '\n') {
+                    if (inDocument_) {
+                        if (!parse(false))
+                            return false;
+                        continue;
+                    }
+                    state_ = scanSpace;
+                }
+                break;
+            case scanResume:
+                if (!parse(false))
+                    return false;
+                continue;
+            }
+            ++scanned_;
+            if (!inDocument_ && state_ == scanSpace)
+                documentBegin_ = scanned_;
+        }
+        return true;
+    }
+
+    bool IncrementalReader::startDocument(size_t begin) {
+        reader_.startDocument();
+        documentBegin_ = begin;
+        parsed_ = begin;
+        resumed_ = 0;
+        discardedLines_ = 0;
+        discardedColumns_ = 0;
+        inDocument_ = true;
+        return parse(false);
+    }
+
+    /* Resumes reader_ on the input received so far. When it is suspended again, the
+     * scan waits for the end of the token it stopped on.
+     */
+    bool IncrementalReader::parse(bool last) {
+        const char* data = buffer_.data();
+        const size_t length = buffer_.length();
+        if (reader_.resumeDocument(data + documentBegin_, data + parsed_, data + length, root_, last)) {
+            values_.push_back(std::move(root_));
+            root_ = Value();
+            documentBegin_ = scanned_ = size_t(reader_.current_ - data);
+            inDocument_ = false;
+            state_ = scanSpace;
+            return true;
+        }
+        if (!reader_.suspended_) {
+            // Locate the errors from the beginning of the document, part of which may have been dropped.
+            auto shift = [this](std::pair<int, int>& lineColumn) {
+                if (lineColumn.first == 1)
+                    lineColumn.second += discardedColumns_;
+                lineColumn.first += discardedLines_;
+            };
+            for (auto& error : reader_.errors_) {
+                shift(error.lineColumn_);
+                if (error.extra_)
+                    shift(error.extraLineColumn_);
+            }
+            return fail(reader_.getFormattedErrorMessages());
+        }
+        size_t suspended = size_t(reader_.current_ - data);
+        // Resumed on a token that the scan saw complete, reader_ made no progress: wait for more input.
+        bool stalled = suspended == parsed_ && length == resumed_;
+        parsed_ = suspended;
+        resumed_ = length;
+        scanned_ = suspended + 1;
+        if (stalled || suspended == length) {
+            scanned_ = length;
+            state_ = scanResume;
+        } else if (buffer_[suspended] == '"')
+            state_ = scanString;
+        else if (buffer_[suspended] == '/' && allowComments_)
+            state_ = scanCommentStart;
+        else
+            state_ = scanToken;
+        return true;
+    }
+
+    bool IncrementalReader::fail(const std::string& message) {
+        errors_ = message;
+        failed_ = true;
+        return false;
+    }
+
+    // Class BatchReader
+    // //////////////////////////////////////////////////////////////////
+
+    // Smallest part of a batch worth a thread.
+    static const size_t minimumBatchRangeSize = 64 * 1024;
+
+    BatchReader::BatchReader(const Features& features, unsigned int threadCount) :
+        readers_(threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency()), Reader(features)), batchBegin_{ nullptr },
+        bounds_{}, ranges_{}, exceptions_{}, workers_{}, generation_{ 0 }, rangeCount_{ 0 }, pending_{ 0 }, stopping_{ false }, mutex_{}, start_{}, done_{} {}
+
+    BatchReader::~BatchReader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        start_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    bool BatchReader::parse(const std::string& document, Records& records) {
+        const char* begin = document.c_str();
+        return parse(begin, begin + document.length(), records);
+    }
+
+    bool BatchReader::parse(const char* beginDoc, const char* endDoc, Records& records) {
+        records.clear();
+        size_t length = endDoc - beginDoc;
+        size_t rangeCount = std::clamp<size_t>(length / minimumBatchRangeSize, 1, readers_.size());
+
+        // Split at the first line boundary after each nth of the batch.
+        batchBegin_ = beginDoc;
+        bounds_.assign(rangeCount + 1, endDoc);
+        bounds_[0] = beginDoc;
+        for (size_t index = 1; index < rangeCount; ++index) {
+            const char* split = std::max(beginDoc + length / rangeCount * index, bounds_[index - 1]);
+            const char* newline = static_cast<const char*>(memchr(split, '\n', endDoc - split));
+            bounds_[index] = newline ? newline + 1 : endDoc;
+        }
+        ranges_.resize(rangeCount);
+        for (auto& range : ranges_)
+            range.clear();
+        exceptions_.assign(rangeCount, nullptr);
+
+        if (rangeCount > 1) {
+            // Only this thread writes generation_: the new workers wait for the next one.
+            while (workers_.size() + 1 < rangeCount)
+                workers_.emplace_back(&BatchReader::work, this, workers_.size() + 1, generation_);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++generation_;
+                rangeCount_ = rangeCount;
+                pending_ = rangeCount - 1;
+            }
+            start_.notify_all();
+        }
+        parseRange(0);
+        if (rangeCount > 1) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return pending_ == 0; });
+        }
+        for (auto& exception : exceptions_) {
+            if (exception)
+                std::rethrow_exception(exception);
+        }
+
+        size_t recordCount = 0;
+        for (const auto& range : ranges_)
+            recordCount += range.size();
+        records.reserve(recordCount);
+        bool successful = true;
+        for (auto& range : ranges_) {
+            for (auto& record : range) {
+                successful = successful && record.errors_.empty();
+                records.push_back(std::move(record));
+            }
+        }
+        return successful;
+    }
+
+    void BatchReader::parseRange(size_t index) {
+        try {
+            parseLines(readers_[index], batchBegin_, bounds_[index], bounds_[index + 1], ranges_[index]);
+        } catch (...) {
+            exceptions_[index] = std::current_exception();
+        }
+    }
+
+    // Body of workers_[index - 1]: parses range index of each batch that has one.
+    void BatchReader::work(size_t index, size_t generation) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            start_.wait(lock, [&] { return generation_ != generation || stopping_; });
+            if (stopping_)
+                return;
+            generation = generation_;
+            if (index >= rangeCount_)
+                continue;
+            lock.unlock();
+            parseRange(index);
+            lock.lock();
+            if (--pending_ == 0)
+                done_.notify_one();
+        }
+    }
+
+    void BatchReader::parseLines(Reader& reader, const char* batchBegin, const char* begin, const char* end, Records& records) {
+        while (begin != end) {
+            const char* newline = static_cast<const char*>(memchr(begin, '\n', end - begin));
+            const char* lineEnd = newline ? newline : end;
+            const char* next = newline ? newline + 1 : end;
+            if (lineEnd != begin && lineEnd[-1] == '\r')
+                --lineEnd;
+            if (skipWhitespace(begin, lineEnd) != lineEnd) {
+                Record& record = records.emplace_back();
+                record.offset_ = begin - batchBegin;
+                if (!reader.parse(begin, lineEnd, record.root_, false)) {
+                    record.root_ = Value();
+                    record.errors_ = reader.getFormattedErrorMessages();
+                }
+            }
+            begin = next;
+        }
+    }
+
+    // Class BinaryReader
+    // //////////////////////////////////////////////////////////////////
+
+    // Additional information of an indefinite-length item, and the "break" byte ending it.
+    static const unsigned int cborIndefiniteLength = 31;
+    static const unsigned char cborBreak = 0xff;
+
+    static double decodeHalfFloat(unsigned int half) {
+        int exponent = (half >> 10) & 0x1f;
+        unsigned int mantissa = half & 0x3ff;
+        double value;
+        if (exponent == 0)
+            value = ldexp(mantissa, -24);
+        else if (exponent != 31)
+            value = ldexp(mantissa + 1024, exponent - 25);
+        else
+            value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+        return half & 0x8000 ? -value : value;
+    }
+
+    BinaryReader::BinaryReader(unsigned int maxDepth) :
+        errors_{}, stringBuffer_{}, begin_{ nullptr }, end_{ nullptr }, current_{ nullptr }, depth_{ 0 }, maxDepth_{ maxDepth } {}
+
+    bool BinaryReader::parse(const char* beginDoc, const char* endDoc, Value& root) {
+        begin_ = reinterpret_cast<Location>(beginDoc);
+        end_ = reinterpret_cast<Location>(endDoc);
+        current_ = begin_;
+        depth_ = 0;
+        errors_.clear();
+        root = Value();
+        if (!readValue(root))
+            return false;
+        if (current_ != end_)
+            return addError("Extra data after the end of the document.", current_);
+        return true;
+    }
+
+    bool BinaryReader::parse(const std::string& document, Value& root) {
+        return parse(document.data(), document.data() + document.size(), root);
+    }
+
+    std::string BinaryReader::getFormattedErrorMessages() const {
+        return errors_;
+    }
+
+    bool BinaryReader::readHead(unsigned int& major, unsigned int& info, UInt64& argument) {
+        if (current_ == end_)
+            return addError("Unexpected end of data.", current_);
+        Location head = current_++;
+        major = *head >> 5;
+        info = *head & 0x1f;
+        argument = 0;
+        if (info < 24) {
+            argument = info;
+        } else if (info <= 27) {
+            size_t length = size_t(1) << (info - 24);
+            if (size_t(end_ - current_) < length)
+                return addError("Unexpected end of data.", current_);
+            for (size_t index = 0; index < length; ++index)
+                argument = (argument << 8) | *current_++;
+        } else if (info != cborIndefiniteLength) {
+            return addError("Reserved additional information.", head);
+        }
+        return true;
+    }
+
+    bool BinaryReader::readValue(Value& value) {
+        Location start;
+        unsigned int major = 0, info = 0;
+        UInt64 argument;
+        // Tags only qualify the item that follows.
+        do {
+            start = current_;
+            if (!readHead(major, info, argument))
+                return false;
+            if (info == cborIndefiniteLength && (major < cborByteString || major == cborTag))
+                return addError("Invalid indefinite-length item.", start);
+        } while (major == cborTag);
+        switch (major) {
+        case cborUnsigned:
+            // Same types as the integers read by Reader::decodeNumber().
+            if (argument <= UInt64(Value::maxInt))
+                value = Value(LargestInt(argument));
+            else
+                value = Value(LargestUInt(argument));
+            return true;
+        case cborNegative:
+            // The value is -1 - argument.
+            if (argument <= UInt64(Value::maxLargestInt))
+                value = Value(LargestInt(-1 - LargestInt(argument)));
+            else
+                value = Value(-1.0 - double(argument));
+            return true;
+        case cborByteString:
+        case cborTextString: {
+            std::string_view str;
+            if (!readString(major, info, argument, str))
+                return false;
+            value = Value(str);
+            return true;
+        }
+        case cborArray:
+        case cborMap: {
+            if (depth_ >= maxDepth_)
+                return addError("Exceeded the maximum nesting depth of arrays and objects (" + std::to_string(maxDepth_) + ").", start);
+            ++depth_;
+            bool ok = major == cborArray ? readArray(info, argument, value) : readObject(info, argument, value);
+            --depth_;
+            return ok;
+        }
+        default:
+            break;
+        }
+        switch (info) {
+        case 20:
+            value = Value(false);
+            return true;
+        case 21:
+            value = Value(true);
+            return true;
+        case 22: // null
+        case 23: // undefined
+            value = Value();
+            return true;
+        case 25:
+            value = Value(decodeHalfFloat(unsigned(argument)));
+            return true;
+        case 26:
+            value = Value(double(std::bit_cast<float>(uint32_t(argument))));
+            return true;
+        case 27:
+            value = Value(std::bit_cast<double>(argument));
+            return true;
+        case cborIndefiniteLength:
+            return addError("Unexpected break.", start);
+        default:
+            return addError("Unsupported simple value.", start);
+        }
+    }
+
+    bool BinaryReader::readString(unsigned int major, unsigned int info, UInt64 length, std::string_view& str) {
+        if (info != cborIndefiniteLength) {
+            if (UInt64(end_ - current_) < length)
+                return addError("Unexpected end of data.", current_);
+            str = std::string_view(reinterpret_cast<const char*>(current_), size_t(length));
+            current_ += length;
+            return true;
+        }
+        stringBuffer_.clear();
+        while (!readBreak()) {
+            Location chunk = current_;
+            unsigned int chunkMajor, chunkInfo;
+            if (!readHead(chunkMajor, chunkInfo, length))
+                return false;
+            if (chunkMajor != major || chunkInfo == cborIndefiniteLength)
+                return addError("Invalid chunk in indefinite-length string.", chunk);
+            if (UInt64(end_ - current_) < length)
+                return addError("Unexpected end of data.", current_);
+            stringBuffer_.append(reinterpret_cast<const char*>(current_), size_t(length));
+            current_ += length;
+        }
+        str = stringBuffer_;
+        return true;
+    }
+
+    bool BinaryReader::readArray(unsigned int info, UInt64 size, Value& value) {
+        value = Value(arrayValue);
+        if (info == cborIndefiniteLength) {
+            while (!readBreak()) {
+                if (!readValue(value.emplace_back()))
+                    return false;
+            }
+            value.unpin();
+            return true;
+        }
+        // Each element takes at least one byte.
+        if (UInt64(end_ - current_) < size)
+            return addError("Unexpected end of data.", current_);
+        value.reserve(ArrayIndex(size));
+        for (UInt64 index = 0; index < size; ++index) {
+            if (!readValue(value.emplace_back()))
+                return false;
+        }
+        value.unpin();
+        return true;
+    }
+
+    bool BinaryReader::readObject(unsigned int info, UInt64 size, Value& value) {
+        value = Value(objectValue);
+        bool indefinite = info == cborIndefiniteLength;
+        // Each member takes at least two bytes.
+        if (!indefinite && UInt64(end_ - current_) / 2 < size)
+            return addError("Unexpected end of data.", current_);
+        for (UInt64 index = 0; indefinite ? !readBreak() : index < size; ++index) {
+            Location name = current_;
+            unsigned int major = 0;
+            UInt64 length;
+            if (!readHead(major, info, length))
+                return false;
+            if (major != cborTextString)
+                return addError("Object member name must be a text string.", name);
+            std::string_view key;
+            if (!readString(major, info, length, key))
+                return false;
+            if (!readValue(value[key]))
+                return false;
+        }
+        // The references to the members are no longer used.
+        value.unpin();
+        return true;
+    }
+
+    bool BinaryReader::readBreak() {
+        if (current_ == end_ || *current_ != cborBreak)
+            return false;
+        ++current_;
+        return true;
+    }
+
+    bool BinaryReader::addError(const std::string& message, Location location) {
+        errors_ = "* Byte " + std::to_string(location - begin_) + "\n  " + message + "\n";
+        return false;
+    }
+
     std::istream& operator>>(std::istream& sin, Value& root) {
         Json::Reader reader;
         bool ok = reader.parse(sin, root, true);
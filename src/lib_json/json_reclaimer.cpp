@@ -0,0 +1,93 @@
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include <json/reclaimer.h>
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <utility>
+
+namespace Json {
+
+    // Class Reclaimer
+    // //////////////////////////////////////////////////////////////////
+
+    Reclaimer::Reclaimer(size_t capacity) :
+        backlog_(capacity), head_{ 0 }, count_{ 0 }, busy_{ false }, stopping_{ false }, mutex_{}, ready_{}, idle_{}, thread_{} {
+        if (capacity > 0)
+            thread_ = std::thread(&Reclaimer::run, this);
+    }
+
+    Reclaimer::~Reclaimer() {
+        if (!thread_.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_one();
+        thread_.join();
+    }
+
+    bool Reclaimer::reclaim(Value&& value) {
+        std::unique_ptr<Document> noDocument;
+        if (value.ownsContainer() && defer(value, noDocument))
+            return true;
+        Value discarded{ std::move(value) };
+        return false;
+    }
+
+    bool Reclaimer::reclaim(std::unique_ptr<Document> document) {
+        Value noValue;
+        if (document && defer(noValue, document))
+            return true;
+        document.reset();
+        return false;
+    }
+
+    void Reclaimer::flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return count_ == 0 && !busy_; });
+    }
+
+    // Moves value and document to the backlog, unless it is full.
+    bool Reclaimer::defer(Value& value, std::unique_ptr<Document>& document) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (count_ == backlog_.size())
+                return false;
+            // The slot was emptied by run(): the swaps leave value and document empty.
+            Garbage& slot = backlog_[(head_ + count_) % backlog_.size()];
+            slot.value_.swap(value);
+            slot.document_.swap(document);
+            ++count_;
+        }
+        ready_.notify_one();
+        return true;
+    }
+
+    void Reclaimer::run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            ready_.wait(lock, [this] { return count_ > 0 || stopping_; });
+            if (count_ == 0)
+                return;
+            Garbage garbage;
+            Garbage& slot = backlog_[head_];
+            garbage.value_.swap(slot.value_);
+            garbage.document_.swap(slot.document_);
+            head_ = (head_ + 1) % backlog_.size();
+            --count_;
+            busy_ = true;
+            lock.unlock();
+            garbage.value_ = Value();
+            garbage.document_.reset();
+            lock.lock();
+            busy_ = false;
+            if (count_ == 0)
+                idle_.notify_all();
+        }
+    }
+
+} // namespace Json
@@ -0,0 +1,68 @@
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#if !defined(JSONCPP_IS_AMALGAMATION)
+#include <json/statistics.h>
+#include <json/value.h>
+#include "json_tool.h"
+#endif // if !defined(JSONCPP_IS_AMALGAMATION)
+#include <atomic>
+
+namespace Json {
+
+    thread_local size_t heapAllocationCount = 0;
+
+    static std::atomic<StatisticsListener*> statisticsListener{ nullptr };
+
+    /* Allocates from new/delete, counting the blocks in heapAllocationCount.
+     */
+    class CountingHeapResource : public std::pmr::memory_resource {
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++heapAllocationCount;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    std::pmr::memory_resource* countingHeapResource() {
+        // Never destroyed: static Value objects may be released after it would be.
+        static CountingHeapResource* resource = new CountingHeapResource();
+        return resource;
+    }
+
+    void reportStatistics(const Statistics& statistics) {
+        if (StatisticsListener* listener = statisticsListener.load(std::memory_order_acquire))
+            listener->record(statistics);
+    }
+
+    void setStatisticsListener(StatisticsListener* listener) {
+        statisticsListener.store(listener, std::memory_order_release);
+    }
+
+    // Class Statistics
+    // //////////////////////////////////////////////////////////////////
+
+    Statistics::Statistics() :
+        phase_{ phaseParse }, bytes_{ 0 }, tokens_{ 0 }, nodes_{ 0 }, maxDepth_{ 0 }, stringBytes_{ 0 }, allocations_{ 0 }, nanoseconds_{ 0 }, depth_{ 0 } {}
+
+    void Statistics::reset(Phase phase) {
+        *this = Statistics();
+        phase_ = phase;
+    }
+
+    // Class StatisticsListener
+    // //////////////////////////////////////////////////////////////////
+
+    StatisticsListener::~StatisticsListener() {}
+
+} // namespace Json
@@ -14,6 +14,27 @@
  * It is an internal header that must not be exposed.
  */
 
+#include <charconv>
+#include <cstring>
+#include <bit>
+#include <chrono>
+#include <memory_resource>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JSONCPP_USE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSONCPP_USE_SSE2 1
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <tmmintrin.h>
+#define JSONCPP_USE_SSSE3 1
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define JSONCPP_USE_NEON 1
+#endif
+
 namespace Json {
 
     /// Converts a unicode code-point to UTF-8.
@@ -50,6 +71,424 @@ namespace Json {
         return ch > 0 && ch <= 0x1F;
     }
 
+    /** Escape of each character in a JSON string: 0 if the character is written as is,
+     * 'u' if it is written as \\u00XX, otherwise the character following the '\\'.
+     */
+    static constexpr char escapeTable[256] = {
+        'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u', // 0x00
+        'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', // 0x10
+        0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,                               // 0x20
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,                                 // 0x30
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,                                 // 0x40
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0,                              // 0x50
+    };
+
+    /// Returns the first character of [begin, end) that must be escaped in a JSON string
+    /// ('"', '\\' or a control character), or end if there is none.
+    static inline const char* findCharacterToEscape(const char* begin, const char* end) {
+#if defined(JSONCPP_USE_AVX2)
+        const __m256i quote32 = _mm256_set1_epi8('"');
+        const __m256i backslash32 = _mm256_set1_epi8('\\');
+        const __m256i maxControl32 = _mm256_set1_epi8(0x1F);
+        for (; end - begin >= 32; begin += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32), _mm256_cmpeq_epi8(chunk, backslash32)),
+                                              _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, maxControl32), chunk));
+            unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(special));
+            if (mask != 0)
+                return begin + std::countr_zero(mask);
+        }
+#endif
+#if defined(JSONCPP_USE_SSE2)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i maxControl = _mm_set1_epi8(0x1F);
+        for (; end - begin >= 16; begin += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            // Unsigned chunk <= 0x1F is tested as min(chunk, 0x1F) == chunk.
+            __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                           _mm_cmpeq_epi8(_mm_min_epu8(chunk, maxControl), chunk));
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(special));
+            if (mask != 0)
+                return begin + std::countr_zero(mask);
+        }
+#elif defined(JSONCPP_USE_NEON)
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t backslash = vdupq_n_u8('\\');
+        const uint8x16_t maxControl = vdupq_n_u8(0x1F);
+        for (; end - begin >= 16; begin += 16) {
+            uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(begin));
+            uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)), vcleq_u8(chunk, maxControl));
+            if (vmaxvq_u8(special) != 0)
+                break; // located by the scalar loop
+        }
+#endif
+        for (; begin != end; ++begin) {
+            if (escapeTable[static_cast<unsigned char>(*begin)])
+                break;
+        }
+        return begin;
+    }
+
+    /* Appends the quoted and escaped string [begin, end) to out.
+     * Output must provide append(const char* data, size_t length).
+     * Runs of characters that need no escaping are located with findCharacterToEscape()
+     * and appended at once.
+     *
+     * Even though \/ is considered a legal escape in JSON, a bare slash is also
+     * legal, so '/' is not escaped.
+     * blep notes: actually escaping \/ may be useful in javascript to avoid </
+     * sequence. Should add a flag to allow this compatibility mode and prevent this
+     * sequence from occurring.
+     */
+    template <typename Output>
+    static void writeQuotedString(Output& out, const char* begin, const char* end) {
+        static const char hexDigits[] = "0123456789ABCDEF";
+        out.append("\"", 1);
+        for (;;) {
+            const char* special = findCharacterToEscape(begin, end);
+            out.append(begin, special - begin);
+            if (special == end)
+                break;
+            unsigned char c = static_cast<unsigned char>(*special);
+            char escape = escapeTable[c];
+            if (escape == 'u') {
+                char unicode[] = { '\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xf] };
+                out.append(unicode, sizeof(unicode));
+            } else {
+                char shortEscape[] = { '\\', escape };
+                out.append(shortEscape, sizeof(shortEscape));
+            }
+            begin = special + 1;
+        }
+        out.append("\"", 1);
+    }
+
+    /// Returns the first '"' or '\\' of [begin, end), or end if there is none.
+    static inline const char* findQuoteOrBackslash(const char* begin, const char* end) {
+#if defined(JSONCPP_USE_AVX2)
+        const __m256i quote32 = _mm256_set1_epi8('"');
+        const __m256i backslash32 = _mm256_set1_epi8('\\');
+        for (; end - begin >= 32; begin += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32), _mm256_cmpeq_epi8(chunk, backslash32));
+            unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(special));
+            if (mask != 0)
+                return begin + std::countr_zero(mask);
+        }
+#endif
+#if defined(JSONCPP_USE_SSE2)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        for (; end - begin >= 16; begin += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(special));
+            if (mask != 0)
+                return begin + std::countr_zero(mask);
+        }
+#elif defined(JSONCPP_USE_NEON)
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t backslash = vdupq_n_u8('\\');
+        for (; end - begin >= 16; begin += 16) {
+            uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(begin));
+            if (vmaxvq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash))) != 0)
+                break; // located by the scalar loop
+        }
+#endif
+        for (; begin != end; ++begin) {
+            if (*begin == '"' || *begin == '\\')
+                break;
+        }
+        return begin;
+    }
+
+    /** Returns the end of the UTF-8 sequence starting at begin, whose first byte is not
+     * ASCII, or nullptr if the sequence is not valid: truncated, overlong, a surrogate or
+     * above U+10FFFF (RFC 3629).
+     */
+    static inline const char* skipUtf8Sequence(const char* begin, const char* end) {
+        unsigned char lead = static_cast<unsigned char>(*begin);
+        ptrdiff_t length;
+        unsigned char minSecond = 0x80;
+        unsigned char maxSecond = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF)
+            length = 2;
+        else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            if (lead == 0xE0)
+                minSecond = 0xA0;
+            else if (lead == 0xED)
+                maxSecond = 0x9F;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            if (lead == 0xF0)
+                minSecond = 0x90;
+            else if (lead == 0xF4)
+                maxSecond = 0x8F;
+        } else
+            return nullptr;
+        if (end - begin < length)
+            return nullptr;
+        unsigned char second = static_cast<unsigned char>(begin[1]);
+        if (second < minSecond || second > maxSecond)
+            return nullptr;
+        for (ptrdiff_t index = 2; index < length; ++index) {
+            if ((static_cast<unsigned char>(begin[index]) & 0xC0) != 0x80)
+                return nullptr;
+        }
+        return begin + length;
+    }
+
+    /// Returns the first byte of [begin, end) that does not belong to a valid UTF-8
+    /// sequence, or end if the range is valid UTF-8.
+    static inline const char* findInvalidUtf8(const char* begin, const char* end) {
+        while (begin != end) {
+            if (static_cast<unsigned char>(*begin) < 0x80)
+                ++begin;
+            else if (const char* next = skipUtf8Sequence(begin, end))
+                begin = next;
+            else
+                break;
+        }
+        return begin;
+    }
+
+#if defined(JSONCPP_USE_SSSE3) || defined(JSONCPP_USE_NEON)
+    /* Tables of the UTF-8 validation of "Validating UTF-8 In Less Than One Instruction
+     * Per Byte" (Keiser, Lemire), indexed by the high nibble of a byte, its low nibble,
+     * and the high nibble of the following byte. A pair of bytes is invalid if the three
+     * entries share a bit. Two continuations in a row are only valid as the third or
+     * fourth byte of a sequence (utf8TwoContinuations): see checkUtf8Block().
+     */
+    enum {
+        utf8TooShort = 1 << 0,         // 11______ 0_______, 11______ 11______
+        utf8TooLong = 1 << 1,          // 0_______ 10______
+        utf8Overlong3 = 1 << 2,        // 11100000 100_____
+        utf8TooLarge = 1 << 3,         // 11110100 1001____, 11110100 101_____, 11110101+ 10______
+        utf8Surrogate = 1 << 4,        // 11101101 101_____
+        utf8Overlong2 = 1 << 5,        // 1100000_ 10______
+        utf8TooLarge1000 = 1 << 6,     // 11110101+ 1000____
+        utf8Overlong4 = 1 << 6,        // 11110000 1000____
+        utf8TwoContinuations = 1 << 7, // 10______ 10______
+        utf8Carry = utf8TooShort | utf8TooLong | utf8TwoContinuations
+    };
+
+    alignas(16) static constexpr unsigned char utf8FirstHigh[16] = {
+        utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong,
+        utf8TwoContinuations, utf8TwoContinuations, utf8TwoContinuations, utf8TwoContinuations,
+        utf8TooShort | utf8Overlong2,
+        utf8TooShort,
+        utf8TooShort | utf8Overlong3 | utf8Surrogate,
+        utf8TooShort | utf8TooLarge | utf8TooLarge1000 | utf8Overlong4,
+    };
+
+    alignas(16) static constexpr unsigned char utf8FirstLow[16] = {
+        utf8Carry | utf8Overlong3 | utf8Overlong2 | utf8Overlong4,
+        utf8Carry | utf8Overlong2,
+        utf8Carry,
+        utf8Carry,
+        utf8Carry | utf8TooLarge,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000 | utf8Surrogate,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+        utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    };
+
+    alignas(16) static constexpr unsigned char utf8SecondHigh[16] = {
+        utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort,
+        utf8TooLong | utf8Overlong2 | utf8TwoContinuations | utf8Overlong3 | utf8TooLarge1000 | utf8Overlong4,
+        utf8TooLong | utf8Overlong2 | utf8TwoContinuations | utf8Overlong3 | utf8TooLarge,
+        utf8TooLong | utf8Overlong2 | utf8TwoContinuations | utf8Surrogate | utf8TooLarge,
+        utf8TooLong | utf8Overlong2 | utf8TwoContinuations | utf8Surrogate | utf8TooLarge,
+        utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort,
+    };
+
+    alignas(16) static constexpr unsigned char utf8Indices[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+#endif
+
+#if defined(JSONCPP_USE_SSSE3)
+    /* Returns non-zero bytes where the sequences of chunk, following previous, are not
+     * valid UTF-8. Sequences truncated at the end of chunk are left to the next block: a
+     * block ending with an ASCII byte checks all the sequences before it.
+     */
+    static inline __m128i checkUtf8Block(__m128i chunk, __m128i previous) {
+        const __m128i lowNibble = _mm_set1_epi8(0x0F);
+        __m128i previous1 = _mm_alignr_epi8(chunk, previous, 15);
+        __m128i firstHigh = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8FirstHigh)), _mm_and_si128(_mm_srli_epi16(previous1, 4), lowNibble));
+        __m128i firstLow = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8FirstLow)), _mm_and_si128(previous1, lowNibble));
+        __m128i secondHigh = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8SecondHigh)), _mm_and_si128(_mm_srli_epi16(chunk, 4), lowNibble));
+        __m128i pairErrors = _mm_and_si128(_mm_and_si128(firstHigh, firstLow), secondHigh);
+        // Bytes 2 or 3 after a lead of three or four bytes must be continuations: their
+        // high bit is set by the saturated subtractions, and matches the two-continuations bit.
+        __m128i thirdByte = _mm_subs_epu8(_mm_alignr_epi8(chunk, previous, 14), _mm_set1_epi8(char(0xE0 - 0x80)));
+        __m128i fourthByte = _mm_subs_epu8(_mm_alignr_epi8(chunk, previous, 13), _mm_set1_epi8(char(0xF0 - 0x80)));
+        __m128i continuations = _mm_and_si128(_mm_or_si128(thirdByte, fourthByte), _mm_set1_epi8(char(0x80)));
+        return _mm_xor_si128(continuations, pairErrors);
+    }
+#elif defined(JSONCPP_USE_NEON)
+    static inline uint8x16_t checkUtf8Block(uint8x16_t chunk, uint8x16_t previous) {
+        const uint8x16_t lowNibble = vdupq_n_u8(0x0F);
+        uint8x16_t previous1 = vextq_u8(previous, chunk, 15);
+        uint8x16_t firstHigh = vqtbl1q_u8(vld1q_u8(utf8FirstHigh), vshrq_n_u8(previous1, 4));
+        uint8x16_t firstLow = vqtbl1q_u8(vld1q_u8(utf8FirstLow), vandq_u8(previous1, lowNibble));
+        uint8x16_t secondHigh = vqtbl1q_u8(vld1q_u8(utf8SecondHigh), vshrq_n_u8(chunk, 4));
+        uint8x16_t pairErrors = vandq_u8(vandq_u8(firstHigh, firstLow), secondHigh);
+        uint8x16_t thirdByte = vqsubq_u8(vextq_u8(previous, chunk, 14), vdupq_n_u8(0xE0 - 0x80));
+        uint8x16_t fourthByte = vqsubq_u8(vextq_u8(previous, chunk, 13), vdupq_n_u8(0xF0 - 0x80));
+        uint8x16_t continuations = vandq_u8(vorrq_u8(thirdByte, fourthByte), vdupq_n_u8(0x80));
+        return veorq_u8(continuations, pairErrors);
+    }
+#endif
+
+    /* Returns the first '"' or '\\' of [begin, end), or end if there is none, like
+     * findQuoteOrBackslash(), and clears valid if the bytes before it are not valid UTF-8.
+     *
+     * Both searches run over the same 16-byte blocks. The bytes following the quote or
+     * backslash are replaced by zeros, so that a sequence truncated by it is invalid, and
+     * the last bytes of the document are copied into a zero-padded block.
+     */
+    static inline const char* findQuoteOrBackslash(const char* begin, const char* end, bool& valid) {
+#if defined(JSONCPP_USE_SSSE3)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i indices = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8Indices));
+        __m128i previous = _mm_setzero_si128();
+        __m128i errors = _mm_setzero_si128();
+        for (;;) {
+            bool last = end - begin < 16;
+            __m128i chunk;
+            if (last) {
+                char padded[16] = {};
+                std::memcpy(padded, begin, size_t(end - begin));
+                chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded));
+            } else
+                chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash))));
+            if (mask != 0) {
+                last = true;
+                end = begin + std::countr_zero(mask);
+                chunk = _mm_and_si128(chunk, _mm_cmplt_epi8(indices, _mm_set1_epi8(char(end - begin))));
+            }
+            // ASCII only blocks following ASCII bytes are valid.
+            if (_mm_movemask_epi8(_mm_or_si128(chunk, previous)) != 0)
+                errors = _mm_or_si128(errors, checkUtf8Block(chunk, previous));
+            if (last) {
+                valid = valid && _mm_movemask_epi8(_mm_cmpeq_epi8(errors, _mm_setzero_si128())) == 0xFFFF;
+                return end;
+            }
+            previous = chunk;
+            begin += 16;
+        }
+#elif defined(JSONCPP_USE_NEON)
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t backslash = vdupq_n_u8('\\');
+        const uint8x16_t indices = vld1q_u8(utf8Indices);
+        uint8x16_t previous = vdupq_n_u8(0);
+        uint8x16_t errors = vdupq_n_u8(0);
+        for (;;) {
+            bool last = end - begin < 16;
+            uint8x16_t chunk;
+            if (last) {
+                unsigned char padded[16] = {};
+                std::memcpy(padded, begin, size_t(end - begin));
+                chunk = vld1q_u8(padded);
+            } else
+                chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(begin));
+            if (vmaxvq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash))) != 0) {
+                last = true;
+                end = findQuoteOrBackslash(begin, end);
+                chunk = vandq_u8(chunk, vcltq_u8(indices, vdupq_n_u8(uint8_t(end - begin))));
+            }
+            // ASCII only blocks following ASCII bytes are valid.
+            if (vmaxvq_u8(vorrq_u8(chunk, previous)) >= 0x80)
+                errors = vorrq_u8(errors, checkUtf8Block(chunk, previous));
+            if (last) {
+                valid = valid && vmaxvq_u8(errors) == 0;
+                return end;
+            }
+            previous = chunk;
+            begin += 16;
+        }
+#else
+        for (;;) {
+#if defined(JSONCPP_USE_SSE2)
+            // Skip the blocks of ASCII characters other than '"' and '\\'.
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            for (; end - begin >= 16; begin += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+                __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)), chunk);
+                unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(special));
+                if (mask != 0) {
+                    begin += std::countr_zero(mask);
+                    break;
+                }
+            }
+#endif
+            if (begin == end || *begin == '"' || *begin == '\\')
+                return begin;
+            if (static_cast<unsigned char>(*begin) < 0x80)
+                ++begin;
+            else if (const char* next = skipUtf8Sequence(begin, end))
+                begin = next;
+            else {
+                valid = false;
+                ++begin;
+            }
+        }
+#endif
+    }
+
+    /// Returns true if c is a JSON whitespace: ' ', '\\t', '\\n' or '\\r'.
+    static inline bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    /// Returns the first character of [begin, end) that is not a JSON whitespace, or end.
+    static inline const char* skipWhitespace(const char* begin, const char* end) {
+        // Tokens are usually separated by zero or one space: only scan in
+        // blocks once a run has started (indentation of styled documents).
+        if (begin == end || !isWhitespace(*begin))
+            return begin;
+#if defined(JSONCPP_USE_SSE2)
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i carriageReturn = _mm_set1_epi8('\r');
+        for (; end - begin >= 16; begin += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                         _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, carriageReturn)));
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(blank)) ^ 0xFFFFu;
+            if (mask != 0)
+                return begin + std::countr_zero(mask);
+        }
+#elif defined(JSONCPP_USE_NEON)
+        const uint8x16_t space = vdupq_n_u8(' ');
+        const uint8x16_t tab = vdupq_n_u8('\t');
+        const uint8x16_t newline = vdupq_n_u8('\n');
+        const uint8x16_t carriageReturn = vdupq_n_u8('\r');
+        for (; end - begin >= 16; begin += 16) {
+            uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(begin));
+            uint8x16_t blank = vorrq_u8(vorrq_u8(vceqq_u8(chunk, space), vceqq_u8(chunk, tab)),
+                                        vorrq_u8(vceqq_u8(chunk, newline), vceqq_u8(chunk, carriageReturn)));
+            if (vminvq_u8(blank) == 0)
+                break; // located by the scalar loop
+        }
+#endif
+        while (begin != end && isWhitespace(*begin))
+            ++begin;
+        return begin;
+    }
+
     enum {
         /// Constant that specify the size of the buffer that must be passed to uintToString.
         uintToStringBufferSize = 3 * sizeof(LargestUInt) + 1
@@ -71,6 +510,129 @@ namespace Json {
         } while (value != 0);
     }
 
+    enum {
+        /// Constant that specify the size of the buffer that must be passed to doubleToString.
+        /// The longest shortest representation is "-2.2250738585072014e-308".
+        doubleToStringBufferSize = 32
+    };
+
+    // Defines a char buffer for use with doubleToString().
+    typedef char DoubleToStringBuffer[doubleToStringBufferSize];
+
+    /** Converts a double to the shortest string that reads back to the same double.
+     * The decimal separator is always '.', whatever the locale. A ".0" suffix is
+     * added to integral values so that they are read back as real values.
+     * @param value Double to convert to string
+     * @param buffer Output string buffer. Must have at least doubleToStringBufferSize chars.
+     * @return Pointer on the terminating zero written in buffer.
+     */
+    static inline char* doubleToString(double value, char* buffer) {
+        char* end = std::to_chars(buffer, buffer + doubleToStringBufferSize - 3, value).ptr;
+        bool isIntegral = true;
+        for (const char* current = buffer; current != end; ++current) {
+            if (*current == '.' || *current == 'e' || *current == 'n') // "inf" and "nan" included
+                isIntegral = false;
+        }
+        if (isIntegral) {
+            *end++ = '.';
+            *end++ = '0';
+        }
+        *end = 0;
+        return end;
+    }
+
+    // Decodes a JSON Pointer reference token that is an array index: digits without leading zero.
+    static inline bool decodePointerIndex(std::string_view token, ArrayIndex& index) {
+        if (token.empty() || (token[0] == '0' && token.length() > 1))
+            return false;
+        LargestUInt value = 0;
+        for (char c : token) {
+            if (c < '0' || c > '9')
+                return false;
+            value = value * 10 + LargestUInt(c - '0');
+            if (value >= LargestUInt(ArrayIndex(-1)))
+                return false;
+        }
+        index = ArrayIndex(value);
+        return true;
+    }
+
+    // Appends '/' and the escaped JSON Pointer reference token of name to pointer.
+    static inline void appendPointerToken(std::string& pointer, std::string_view name) {
+        pointer += '/';
+        for (char c : name) {
+            if (c == '~')
+                pointer += "~0";
+            else if (c == '/')
+                pointer += "~1";
+            else
+                pointer += c;
+        }
+    }
+
+    /// Major types of the CBOR data items written by BinaryWriter and read by BinaryReader.
+    enum CborMajorType {
+        cborUnsigned = 0,
+        cborNegative = 1,
+        cborByteString = 2,
+        cborTextString = 3,
+        cborArray = 4,
+        cborMap = 5,
+        cborTag = 6,
+        cborSimple = 7
+    };
+
+
+#if defined(JSONCPP_ENABLE_STATISTICS)
+#define JSONCPP_STATISTICS(statement) statement
+#else
+#define JSONCPP_STATISTICS(statement) static_cast<void>(0)
+#endif
+
+    /// Number of heap blocks allocated for Value trees by the current thread.
+    /// Only maintained if JSONCPP_ENABLE_STATISTICS is defined.
+    extern thread_local size_t heapAllocationCount;
+
+    /// Memory resource counting its allocations in heapAllocationCount.
+    std::pmr::memory_resource* countingHeapResource();
+
+    /// Memory resource of the arrays and objects of Value that are not built in an Arena.
+    static inline std::pmr::memory_resource* heapResource() {
+#if defined(JSONCPP_ENABLE_STATISTICS)
+        return countingHeapResource();
+#else
+        return std::pmr::get_default_resource();
+#endif
+    }
+
+    /// Send statistics to the listener registered with setStatisticsListener(), if any.
+    void reportStatistics(const Statistics& statistics);
+
+    /* Measures the duration and the allocations of the operation running while it
+     * exists, and reports its statistics when it is destroyed.
+     */
+    class StatisticsScope {
+    public:
+        StatisticsScope(Statistics& statistics, Statistics::Phase phase) :
+            statistics_{ statistics }, start_{ std::chrono::steady_clock::now() }, allocations_{ heapAllocationCount } {
+            statistics.reset(phase);
+        }
+
+        ~StatisticsScope() {
+            statistics_.nanoseconds_ = UInt64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+            statistics_.allocations_ = heapAllocationCount - allocations_;
+            reportStatistics(statistics_);
+        }
+
+        StatisticsScope(const StatisticsScope&) = delete;
+        StatisticsScope& operator=(const StatisticsScope&) = delete;
+
+    private:
+        Statistics& statistics_;
+        std::chrono::steady_clock::time_point start_;
+        size_t allocations_;
+    };
+
 } // namespace Json {
 
 #endif // LIB_JSONCPP_JSONCPP_TOOL_H_INCLUDED
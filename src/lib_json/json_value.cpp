@@ -5,7 +5,9 @@
 
 #if !defined(JSONCPP_IS_AMALGAMATION)
 #include <json/value.h>
+#include <json/document.h>
 #include <json/writer.h>
+#include "json_tool.h"
 #ifndef JSONCPP_USE_SIMPLE_INTERNAL_ALLOCATOR
 #include "json_batchallocator.h"
 #endif // #ifndef JSONCPP_USE_SIMPLE_INTERNAL_ALLOCATOR
@@ -17,40 +19,257 @@
 #include <cassert>
 #include <cstddef> // size_t
 #include <cmath>   // std::nextafter
+#include <atomic>
+#include <bit>
+#include <new>
+#include <memory>
+#include <type_traits>
 
 namespace Json {
 
-    /// Unknown size marker
-    static constexpr auto unknown = std::numeric_limits<unsigned int>::max();
+    // Short strings, lengths and the ownership flags all fit in the 16 bytes
+    // of the discriminated union: keep it that way.
+    static_assert(sizeof(Value) == 16, "sizeof(Value) must not grow");
 
-    /** Duplicates the specified string value.
-     * @param value Pointer to the string to duplicate. Must be zero-terminated if
-     *              length is "unknown".
-     * @param length Length of the value. if equals to unknown, then it will be
-     *               computed using strlen(value).
-     * @return Pointer on the duplicate instance of string.
+    /* Header stored in front of the characters of a reference counted string:
+     * the heap allocated strings of values, member names and interned names.
      */
-    static inline char* duplicateStringValue(const char* value, unsigned int length = unknown) {
-        if (length == unknown) {
-            length = (unsigned int)strlen(value);
+    struct SharedString {
+        std::atomic<unsigned int> refCount_;
+    };
+
+    static inline SharedString* sharedStringHeader(const char* value) {
+        return reinterpret_cast<SharedString*>(const_cast<char*>(value)) - 1;
+    }
+
+    /** Creates a reference counted copy of value, with a reference count of 1.
+     * @return Pointer on the zero-terminated characters of the string.
+     */
+    static inline char* newSharedString(std::string_view value) {
+        // Allocated as the containers are, through operator new, so that a
+        // replacement of the global operator new sees every block of a tree.
+        void* block = ::operator new(sizeof(SharedString) + value.length() + 1);
+        JSONCPP_STATISTICS(++heapAllocationCount);
+        SharedString* header = new (block) SharedString{ { 1 } };
+        char* newString = reinterpret_cast<char*>(header + 1);
+        memcpy(newString, value.data(), value.length());
+        newString[value.length()] = 0;
+        return newString;
+    }
+
+    static inline void retainSharedString(const char* value) {
+        sharedStringHeader(value)->refCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static inline void releaseSharedString(const char* value) {
+        SharedString* header = sharedStringHeader(value);
+        if (header->refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            header->~SharedString();
+            ::operator delete(header);
         }
-        else if (length == 0) {
-            return nullptr;
+    }
+
+    /* Open addressing table of the members of a large object, by the hash of
+     * their names. It is kept beside the sorted map, which still holds the
+     * members, their order and the references handed out to them: a name is
+     * found by comparing hashes, then the one name whose hash matches.
+     * The table is only modified with the map, while the object is not shared,
+     * so concurrent readers of a shared object never write to it.
+     */
+    class MemberIndex {
+    public:
+        typedef Value::ObjectValues::value_type Member;
+
+        // Smaller objects are searched in the map, with as few comparisons.
+        static constexpr size_t minimumSize = 16;
+
+        explicit MemberIndex(std::pmr::memory_resource* resource) : resource_{ resource }, slots_{ nullptr }, capacity_{ 0 }, size_{ 0 } {}
+        MemberIndex(const MemberIndex&) = delete;
+        MemberIndex& operator=(const MemberIndex&) = delete;
+
+        ~MemberIndex() {
+            clear();
         }
-        char* newString = static_cast<char*>(malloc(length + 1));
-        JSONCPP_ASSERT_MESSAGE(newString != 0, "Failed to allocate string value buffer");
-        [[likely]] if (newString) {
-            memcpy(newString, value, length);
-            newString[length] = 0;
+
+        bool isBuilt() const {
+            return slots_ != nullptr;
+        }
+
+        const Member* find(std::string_view name) const {
+            const size_t hash = hashName(name);
+            const size_t mask = capacity_ - 1;
+            for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+                const Slot& entry = slots_[slot];
+                if (!entry.member_)
+                    return nullptr;
+                if (entry.hash_ == hash && sameName(entry.member_->first, name))
+                    return entry.member_;
+            }
+        }
+
+        // Indexes member, just inserted into members.
+        void insert(const Value::ObjectValues& members, const Member& member) {
+            if (slots_ && 2 * (size_ + 1) <= capacity_)
+                add(hashName(nameOf(member.first)), &member);
+            else
+                rebuild(members);
+        }
+
+        // Forgets member, about to be erased from its object.
+        void erase(const Member& member) {
+            if (!slots_)
+                return;
+            const size_t mask = capacity_ - 1;
+            size_t slot = hashName(nameOf(member.first)) & mask;
+            while (slots_[slot].member_ != &member)
+                slot = (slot + 1) & mask;
+            // Shift back the following entries that may not be found past the hole.
+            for (size_t next = (slot + 1) & mask; slots_[next].member_; next = (next + 1) & mask) {
+                const size_t home = slots_[next].hash_ & mask;
+                if (((next - home) & mask) >= ((next - slot) & mask)) {
+                    slots_[slot] = slots_[next];
+                    slot = next;
+                }
+            }
+            slots_[slot] = Slot{};
+            --size_;
+        }
+
+        void rebuild(const Value::ObjectValues& members) {
+            clear();
+            if (members.size() < minimumSize)
+                return;
+            capacity_ = std::bit_ceil(2 * members.size());
+            slots_ = static_cast<Slot*>(resource_->allocate(capacity_ * sizeof(Slot), alignof(Slot)));
+            std::uninitialized_fill_n(slots_, capacity_, Slot{});
+            for (const Member& member : members)
+                add(hashName(nameOf(member.first)), &member);
+        }
+
+        void clear() {
+            if (slots_)
+                resource_->deallocate(slots_, capacity_ * sizeof(Slot), alignof(Slot));
+            slots_ = nullptr;
+            capacity_ = 0;
+            size_ = 0;
+        }
+
+    private:
+        struct Slot {
+            size_t hash_;
+            const Member* member_; // nullptr if the slot is free
+        };
+
+        static size_t hashName(std::string_view name) {
+            return std::hash<std::string_view>{}(name);
+        }
+
+        template <typename Name>
+        static std::string_view nameOf(const Name& name) {
+            return std::string_view{ name.c_str(), name.length() };
+        }
+
+        // Interned and shared names are recognized by their address.
+        template <typename Name>
+        static bool sameName(const Name& name, std::string_view other) {
+            return name.length() == other.length() && (name.c_str() == other.data() || memcmp(name.c_str(), other.data(), other.length()) == 0);
+        }
+
+        void add(size_t hash, const Member* member) {
+            const size_t mask = capacity_ - 1;
+            size_t slot = hash & mask;
+            while (slots_[slot].member_)
+                slot = (slot + 1) & mask;
+            slots_[slot] = Slot{ hash, member };
+            ++size_;
         }
-        return newString;
-    }
 
-    /** Free the string duplicated by duplicateStringValue().
+        std::pmr::memory_resource* resource_;
+        Slot* slots_;
+        size_t capacity_; // 0, or a power of 2 at least twice size_
+        size_t size_;
+    };
+
+    // Arrays are not indexed.
+    class NoIndex {
+    public:
+        explicit NoIndex([[maybe_unused]] std::pmr::memory_resource* resource) {}
+        void rebuild([[maybe_unused]] const Value::ArrayValues& elements) {}
+    };
+
+    /* Array or object, with the hash of its content once it is computed
+     * (see Value::hash()), and the index of the members of a large object.
+     * Heap allocated containers are shared by the copies of a Value until one
+     * of them is modified (see Value::detach()), unless they are pinned
+     * (see Value::pin()).
      */
-    static inline void releaseStringValue(char* value) {
-        if (value)
-            free(value);
+    template <typename Container>
+    class SharedContainer : public Container {
+    public:
+        template <typename... Args>
+        explicit SharedContainer(Args&&... args) :
+            Container(std::forward<Args>(args)...), refCount_{ 1 }, hash_{ 0 }, pinned_{ false }, index_{ this->get_allocator().resource() } {
+            index_.rebuild(*this);
+        }
+
+        std::atomic<unsigned int> refCount_;
+        // 0 until computed. Concurrent readers compute and store the same hash.
+        std::atomic<size_t> hash_;
+        // Only set and cleared while the container is not shared.
+        bool pinned_;
+        std::conditional_t<std::is_same_v<Container, Value::ObjectValues>, MemberIndex, NoIndex> index_;
+    };
+
+    template <typename Container, typename... Args>
+    static inline Container* newSharedContainer(Args&&... args) {
+        JSONCPP_STATISTICS(++heapAllocationCount);
+        return new SharedContainer<Container>(std::forward<Args>(args)...);
+    }
+
+    // Containers of an arena are never released: their reference count is unused.
+    template <typename Container>
+    static inline Container* newArenaContainer(std::pmr::memory_resource* resource) {
+        void* block = resource->allocate(sizeof(SharedContainer<Container>), alignof(SharedContainer<Container>));
+        return new (block) SharedContainer<Container>(resource);
+    }
+
+    template <typename Container>
+    static inline SharedContainer<Container>* sharedContainer(const Container* container) {
+        return static_cast<SharedContainer<Container>*>(const_cast<Container*>(container));
+    }
+
+    template <typename Container>
+    static inline void retainSharedContainer(const Container* container) {
+        sharedContainer(container)->refCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename Container>
+    static inline void releaseSharedContainer(const Container* container) {
+        SharedContainer<Container>* shared = sharedContainer(container);
+        if (shared->refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete shared;
+    }
+
+    // A container referenced only once may be modified in place; no other
+    // thread can acquire a new reference to it concurrently.
+    template <typename Container>
+    static inline bool isSharedContainer(const Container* container) {
+        return sharedContainer(container)->refCount_.load(std::memory_order_acquire) != 1;
+    }
+
+    template <typename Container>
+    static inline bool isPinnedContainer(const Container* container) {
+        return sharedContainer(container)->pinned_;
+    }
+
+    static inline MemberIndex& memberIndex(const Value::ObjectValues* members) {
+        return sharedContainer(members)->index_;
+    }
+
+    // Returns the member of it, just inserted into members, once it is indexed.
+    static inline Value& indexMember(Value::ObjectValues* members, Value::ObjectValues::iterator it) {
+        memberIndex(members).insert(*members, *it);
+        return it->second;
     }
 
 } // namespace Json
@@ -78,26 +297,42 @@ namespace Json {
         // Notes: index_ indicates if the string was allocated when
         // a string is stored.
 
-    Value::CZString::CZString(ArrayIndex index) : cstr_(nullptr), index_(index) {}
+    Value::CZString::CZString(ArrayIndex index) : cstr_(nullptr), index_(index), length_(0) {}
 
-    Value::CZString::CZString(const char* cstr, DuplicationPolicy allocate) :
-        cstr_(allocate == duplicate ? duplicateStringValue(cstr) : cstr), index_(allocate) {}
+    Value::CZString::CZString(const char* cstr, DuplicationPolicy allocate) : CZString(cstr, strlen(cstr), allocate) {}
 
-    Value::CZString::CZString(const CZString& other) :
-        cstr_(other.index_ != noDuplication && other.cstr_ ? duplicateStringValue(other.cstr_) : other.cstr_),
-        index_(other.cstr_ ? (other.index_ == noDuplication ? noDuplication : duplicate) : other.index_) {}
+    Value::CZString::CZString(const char* cstr, size_t length, DuplicationPolicy allocate) :
+        cstr_(allocate == duplicate ? newSharedString(std::string_view{ cstr, length }) : cstr), index_(allocate),
+        length_(static_cast<unsigned int>(length)) {
+        if (allocate == interned)
+            retainSharedString(cstr_);
+    }
+
+    // Names that are reference counted are shared by the copy. Others are
+    // duplicated, unless they are static.
+    Value::CZString::CZString(const CZString& other) : cstr_(other.cstr_), index_(other.index_), length_(other.length_) {
+        if (!cstr_)
+            return;
+        if (index_ == duplicateOnCopy) {
+            cstr_ = newSharedString(view());
+            index_ = duplicate;
+        } else if (index_ == duplicate || index_ == interned)
+            retainSharedString(cstr_);
+    }
 
     Value::CZString::CZString(std::string_view str) :
-        cstr_(str.data() ? duplicateStringValue(str.data(), static_cast<unsigned int>(str.length())) : nullptr), index_(str.data() ? duplicate : noDuplication) {}
+        cstr_(str.data() ? newSharedString(str) : nullptr), index_(str.data() ? duplicate : noDuplication),
+        length_(static_cast<unsigned int>(str.length())) {}
 
     Value::CZString::~CZString() {
-        if (cstr_ && index_ == duplicate)
-            releaseStringValue(const_cast<char*>(cstr_));
+        if (cstr_ && (index_ == duplicate || index_ == interned))
+            releaseSharedString(cstr_);
     }
 
     void Value::CZString::swap(CZString& other) {
         std::swap(cstr_, other.cstr_);
         std::swap(index_, other.index_);
+        std::swap(length_, other.length_);
     }
 
     Value::CZString& Value::CZString::operator=(const CZString& other) {
@@ -106,12 +341,16 @@ namespace Json {
         return *this;
     }
 
+    std::string_view Value::CZString::view() const {
+        return std::string_view{ cstr_, length_ };
+    }
+
     bool Value::CZString::operator<(const CZString& other) const {
         if (cstr_ == other.cstr_) {
             return false;
         }
         if (cstr_ && other.cstr_) {
-            return strcmp(cstr_, other.cstr_) < 0;
+            return view() < other.view();
         }
         return false;
     }
@@ -123,7 +362,7 @@ namespace Json {
         if (cstr_ == other.cstr_) {
             return true;
         }
-        return strcmp(cstr_, other.cstr_) == 0;
+        return view() == other.view();
     }
 
     ArrayIndex Value::CZString::index() const {
@@ -135,7 +374,7 @@ namespace Json {
     }
 
     size_t Value::CZString::length() const {
-        return strlen(cstr_);
+        return length_;
     }
 
     bool Value::CZString::isStaticString() const {
@@ -157,7 +396,7 @@ namespace Json {
      * This optimization is used in ValueInternalMap fast allocator.
      */
     Value::Value(ValueType type)
-        : value_{}, type_{ type }, allocated_{ false }
+        : value_{}, type_{ type }, allocated_{ false }, shortLength_{ notShortString }
     {
         switch (type) {
         case nullValue:
@@ -170,11 +409,16 @@ namespace Json {
             value_.real_ = 0.0;
             break;
         case stringValue:
-            value_.string_ = nullptr;
+            // Empty short string: value_.shortString_ is zero-filled by value_{}.
+            shortLength_ = 0;
             break;
         case arrayValue:
+            value_.array_ = newSharedContainer<ArrayValues>(heapResource());
+            allocated_ = true;
+            break;
         case objectValue:
-            value_.map_ = new ObjectValues();
+            value_.map_ = newSharedContainer<ObjectValues>(heapResource());
+            allocated_ = true;
             break;
         case booleanValue:
             value_.bool_ = false;
@@ -184,41 +428,77 @@ namespace Json {
         }
     }
 
+    Value::Value(ValueType type, Arena& arena)
+        : value_{}, type_{ type }, allocated_{ false }, shortLength_{ notShortString }
+    {
+        switch (type) {
+        case arrayValue:
+            value_.array_ = newArenaContainer<ArrayValues>(arena.resource());
+            break;
+        case objectValue:
+            value_.map_ = newArenaContainer<ObjectValues>(arena.resource());
+            break;
+        default:
+            // Scalar types are zero-initialized by value_{}.
+            break;
+        }
+    }
+
 #if defined(JSONCPP_HAS_INT64)
     Value::Value(UInt value) :
-        value_{ .uint_ = value }, type_{ uintValue }, allocated_{ false } {}
+        value_{ .uint_ = value }, type_{ uintValue }, allocated_{ false }, shortLength_{ notShortString } {}
 
     Value::Value(Int value) :
-        value_{ .int_ = value }, type_{ intValue }, allocated_{ false } {}
+        value_{ .int_ = value }, type_{ intValue }, allocated_{ false }, shortLength_{ notShortString } {}
 
 #endif // if defined(JSONCPP_HAS_INT64)
 
     Value::Value(Int64 value) :
-        value_{ .int_ = value }, type_{ intValue }, allocated_{ false } {}
+        value_{ .int_ = value }, type_{ intValue }, allocated_{ false }, shortLength_{ notShortString } {}
 
     Value::Value(UInt64 value) :
-        value_{ .uint_ = value }, type_{ uintValue }, allocated_{ false } {}
+        value_{ .uint_ = value }, type_{ uintValue }, allocated_{ false }, shortLength_{ notShortString } {}
 
     Value::Value(double value) :
-        value_{ .real_ = value }, type_{ realValue }, allocated_{ false } {}
+        value_{ .real_ = value }, type_{ realValue }, allocated_{ false }, shortLength_{ notShortString } {}
 
     Value::Value(const char* value) :
-        value_{ .string_ = duplicateStringValue(value) }, type_{ stringValue }, allocated_{ true } {}
+        value_{}, type_{ stringValue }, allocated_{ false }, shortLength_{ notShortString }
+    {
+        initString(value, strlen(value));
+    }
 
     Value::Value(const StaticString& value) :
-        value_{ .string_ = const_cast<char*>(value.c_str()) }, type_{ stringValue }, allocated_{ false } {}
+        value_{ .string_ = { const_cast<char*>(value.c_str()), static_cast<unsigned int>(value.length()) } }, type_{ stringValue },
+        allocated_{ false }, shortLength_{ notShortString } {}
 
     Value::Value(std::string_view value) :
-        value_{ .string_ = duplicateStringValue(value.data(), (unsigned int)value.length()) }, type_{ stringValue }, allocated_{ true } {}
+        value_{}, type_{ stringValue }, allocated_{ false }, shortLength_{ notShortString }
+    {
+        initString(value.data(), value.length());
+    }
 
     Value::Value(const std::string& value) :
         Value{ std::string_view{ value } } {}
 
+    Value::Value(std::string_view value, Arena& arena) :
+        value_{}, type_{ stringValue }, allocated_{ false }, shortLength_{ notShortString }
+    {
+        if (value.length() <= shortStringCapacity)
+            initString(value.data(), value.length());
+        else
+            value_.string_ = { arena.duplicate(value), static_cast<unsigned int>(value.length()) };
+    }
+
     Value::Value(bool value) :
-        value_{ .bool_ = value }, type_{ booleanValue }, allocated_{ false } {}
+        value_{ .bool_ = value }, type_{ booleanValue }, allocated_{ false }, shortLength_{ notShortString } {}
 
+    /* Heap allocated strings and containers are shared with other, in constant time.
+     * Static strings, pinned containers and the payloads allocated in an arena are
+     * copied to the heap.
+     */
     Value::Value(const Value& other) :
-        value_{}, type_{ other.type_ }, allocated_{ false }
+        value_{}, type_{ other.type_ }, allocated_{ false }, shortLength_{ notShortString }
     {
         switch (type_) {
         case nullValue:
@@ -229,16 +509,30 @@ namespace Json {
             value_ = other.value_;
             break;
         case stringValue:
-            if (other.value_.string_) {
-                value_.string_ = duplicateStringValue(other.value_.string_);
+            if (other.allocated_) {
+                retainSharedString(other.value_.string_.data_);
+                value_ = other.value_;
                 allocated_ = true;
+            } else {
+                std::string_view str = other.stringView();
+                initString(str.data(), str.length());
             }
-            else
-                value_.string_ = nullptr;
             break;
         case arrayValue:
+            if (other.allocated_ && !isPinnedContainer(other.value_.array_)) {
+                retainSharedContainer(other.value_.array_);
+                value_.array_ = other.value_.array_;
+            } else
+                value_.array_ = newSharedContainer<ArrayValues>(*other.value_.array_, heapResource());
+            allocated_ = true;
+            break;
         case objectValue:
-            value_.map_ = new ObjectValues(*other.value_.map_);
+            if (other.allocated_ && !isPinnedContainer(other.value_.map_)) {
+                retainSharedContainer(other.value_.map_);
+                value_.map_ = other.value_.map_;
+            } else
+                value_.map_ = newSharedContainer<ObjectValues>(*other.value_.map_, heapResource());
+            allocated_ = true;
             break;
         default:
             JSONCPP_ASSERT_UNREACHABLE;
@@ -261,11 +555,15 @@ namespace Json {
             break;
         case stringValue:
             if (allocated_)
-                releaseStringValue(value_.string_);
+                releaseSharedString(value_.string_.data_);
             break;
         case arrayValue:
+            if (allocated_)
+                releaseSharedContainer(value_.array_);
+            break;
         case objectValue:
-            delete value_.map_;
+            if (allocated_)
+                releaseSharedContainer(value_.map_);
             break;
         default:
             JSONCPP_ASSERT_UNREACHABLE;
@@ -290,6 +588,200 @@ namespace Json {
     void Value::swap(Value& other) {
         std::swap(type_, other.type_);
         std::swap(value_, other.value_);
+        std::swap(allocated_, other.allocated_);
+        std::swap(shortLength_, other.shortLength_);
+    }
+
+    /* Gives the Value its own copy of its array or object before it is modified,
+     * if the container is shared with other values. The elements are not copied:
+     * they share their own payloads until they are modified in turn.
+     */
+    void Value::detach() {
+        switch (type_) {
+        case arrayValue:
+            if (allocated_ && isSharedContainer(value_.array_)) {
+                ArrayValues* array = newSharedContainer<ArrayValues>(*value_.array_, heapResource());
+                releaseSharedContainer(value_.array_);
+                value_.array_ = array;
+            } else
+                sharedContainer(value_.array_)->hash_.store(0, std::memory_order_relaxed);
+            break;
+        case objectValue:
+            if (allocated_ && isSharedContainer(value_.map_)) {
+                ObjectValues* map = newSharedContainer<ObjectValues>(*value_.map_, heapResource());
+                releaseSharedContainer(value_.map_);
+                value_.map_ = map;
+            } else
+                sharedContainer(value_.map_)->hash_.store(0, std::memory_order_relaxed);
+            break;
+        default:
+            break;
+        }
+    }
+
+    /* References to the elements of a container remain valid until it is modified, and
+     * writing through them bypasses detach(). Once they are handed out, the container
+     * must not be shared by copies, and its hash, or the hash of its ancestors, cannot
+     * be cached.
+     */
+    void Value::pin() {
+        detach();
+        switch (type_) {
+        case arrayValue:
+            sharedContainer(value_.array_)->pinned_ = true;
+            break;
+        case objectValue:
+            sharedContainer(value_.map_)->pinned_ = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    // The non const accessors pin every container on the way to the elements they
+    // return, so the descendants of a container that is not pinned are not pinned.
+    void Value::seal() {
+        switch (type_) {
+        case arrayValue:
+            if (!isPinnedContainer(value_.array_))
+                return;
+            sharedContainer(value_.array_)->pinned_ = false;
+            for (Value& element : *value_.array_)
+                element.seal();
+            break;
+        case objectValue:
+            if (!isPinnedContainer(value_.map_))
+                return;
+            sharedContainer(value_.map_)->pinned_ = false;
+            for (auto& [name, member] : *value_.map_)
+                member.seal();
+            break;
+        default:
+            break;
+        }
+    }
+
+    void Value::unpin() {
+        switch (type_) {
+        case arrayValue:
+            sharedContainer(value_.array_)->pinned_ = false;
+            break;
+        case objectValue:
+            sharedContainer(value_.map_)->pinned_ = false;
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool Value::hasCachedHash() const {
+        switch (type_) {
+        case arrayValue:
+        case objectValue:
+            return cachedHash() != 0;
+        default:
+            return true;
+        }
+    }
+
+    size_t Value::cachedHash() const {
+        switch (type_) {
+        case arrayValue:
+            return sharedContainer(value_.array_)->hash_.load(std::memory_order_relaxed);
+        case objectValue:
+            return sharedContainer(value_.map_)->hash_.load(std::memory_order_relaxed);
+        default:
+            return 0;
+        }
+    }
+
+    bool Value::sharesContainer(const Value& other) const {
+        if (type_ != other.type_)
+            return false;
+        switch (type_) {
+        case arrayValue:
+            return value_.array_ == other.value_.array_;
+        case objectValue:
+            return value_.map_ == other.value_.map_;
+        default:
+            return false;
+        }
+    }
+
+    bool Value::ownsContainer() const {
+        if (!allocated_)
+            return false;
+        switch (type_) {
+        case arrayValue:
+            return !isSharedContainer(value_.array_);
+        case objectValue:
+            return !isSharedContainer(value_.map_);
+        default:
+            return false;
+        }
+    }
+
+    // Mixes value into seed, with the finalizer of SplitMix64.
+    static inline size_t combineHash(size_t seed, size_t value) {
+        UInt64 hash = UInt64(seed) * 0x100000001b3ull + UInt64(value) + 0x9e3779b97f4a7c15ull;
+        hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+        return size_t(hash ^ (hash >> 31));
+    }
+
+    size_t Value::hash() const {
+        size_t hash = cachedHash();
+        if (hash != 0)
+            return hash;
+        switch (type_) {
+        case nullValue:
+            return combineHash(nullValue, 0);
+        case intValue:
+            return combineHash(intValue, size_t(value_.int_));
+        case uintValue:
+            // Same hash as the equal intValue.
+            return combineHash(intValue, size_t(value_.uint_));
+        case realValue:
+            // Same hash as the equal integer, including 0.0 == -0.0.
+            if (value_.real_ >= -0x1p63 && value_.real_ < 0x1p63 && value_.real_ == double(LargestInt(value_.real_)))
+                return combineHash(intValue, size_t(LargestInt(value_.real_)));
+            if (value_.real_ >= 0x1p63 && value_.real_ < 0x1p64 && value_.real_ == double(LargestUInt(value_.real_)))
+                return combineHash(intValue, size_t(LargestUInt(value_.real_)));
+            return combineHash(realValue, size_t(std::bit_cast<UInt64>(value_.real_)));
+        case booleanValue:
+            return combineHash(booleanValue, value_.bool_);
+        case stringValue:
+            return combineHash(stringValue, std::hash<std::string_view>{}(stringView()));
+        case arrayValue: {
+            // Cached only if no container of the tree is pinned: see pin().
+            bool cacheable = !isPinnedContainer(value_.array_);
+            hash = combineHash(arrayValue, value_.array_->size());
+            for (const Value& element : *value_.array_) {
+                hash = combineHash(hash, element.hash());
+                cacheable = cacheable && element.hasCachedHash();
+            }
+            hash += hash == 0;
+            if (cacheable)
+                sharedContainer(value_.array_)->hash_.store(hash, std::memory_order_relaxed);
+            return hash;
+        }
+        case objectValue: {
+            bool cacheable = !isPinnedContainer(value_.map_);
+            hash = combineHash(objectValue, value_.map_->size());
+            for (const auto& [name, member] : *value_.map_) {
+                hash = combineHash(hash, std::hash<std::string_view>{}(std::string_view{ name.c_str(), name.length() }));
+                hash = combineHash(hash, member.hash());
+                cacheable = cacheable && member.hasCachedHash();
+            }
+            hash += hash == 0;
+            if (cacheable)
+                sharedContainer(value_.map_)->hash_.store(hash, std::memory_order_relaxed);
+            return hash;
+        }
+        default:
+            JSONCPP_ASSERT_UNREACHABLE;
+        }
+        return 0; // unreachable
     }
 
     ValueType Value::type() const {
@@ -320,9 +812,13 @@ namespace Json {
         case booleanValue:
             return value_.bool_ < other.value_.bool_;
         case stringValue:
-            return (!value_.string_ && other.value_.string_) ||
-                (other.value_.string_ && value_.string_ && strcmp(value_.string_, other.value_.string_) < 0);
-        case arrayValue:
+            return stringView() < other.stringView();
+        case arrayValue: {
+            int delta = int(value_.array_->size() - other.value_.array_->size());
+            if (delta)
+                return delta < 0;
+            return (*value_.array_) < (*other.value_.array_);
+        }
         case objectValue: {
             int delta = int(value_.map_->size() - other.value_.map_->size());
             if (delta)
@@ -362,10 +858,18 @@ namespace Json {
         case booleanValue:
             return value_.bool_ == other.value_.bool_;
         case stringValue:
-            return (value_.string_ == other.value_.string_) ||
-                (other.value_.string_ && value_.string_ && strcmp(value_.string_, other.value_.string_) == 0);
+            return stringView() == other.stringView();
         case arrayValue:
+            if (value_.array_ == other.value_.array_)
+                return true;
+            if (size_t hash = cachedHash(), otherHash = other.cachedHash(); hash != 0 && otherHash != 0 && hash != otherHash)
+                return false;
+            return value_.array_->size() == other.value_.array_->size() && (*value_.array_) == (*other.value_.array_);
         case objectValue:
+            if (value_.map_ == other.value_.map_)
+                return true;
+            if (size_t hash = cachedHash(), otherHash = other.cachedHash(); hash != 0 && otherHash != 0 && hash != otherHash)
+                return false;
             return value_.map_->size() == other.value_.map_->size() && (*value_.map_) == (*other.value_.map_);
         default:
             JSONCPP_ASSERT_UNREACHABLE;
@@ -379,7 +883,38 @@ namespace Json {
 
     const char* Value::asCString() const {
         JSONCPP_ASSERT(type_ == stringValue);
-        return value_.string_;
+        return shortLength_ != notShortString ? value_.shortString_ : value_.string_.data_;
+    }
+
+    bool Value::getString(const char** begin, const char** end) const {
+        if (type_ != stringValue)
+            return false;
+        std::string_view str = stringView();
+        *begin = str.data();
+        *end = str.data() + str.length();
+        return true;
+    }
+
+    std::string_view Value::stringView() const {
+        if (shortLength_ != notShortString)
+            return std::string_view{ value_.shortString_, shortLength_ };
+        return std::string_view{ value_.string_.data_, value_.string_.length_ };
+    }
+
+    /* Stores [value, value + length) in value_.shortString_ if it is short
+     * enough, or else in a heap allocated copy.
+     */
+    void Value::initString(const char* value, size_t length) {
+        if (length <= shortStringCapacity) {
+            memcpy(value_.shortString_, value, length);
+            value_.shortString_[length] = 0;
+            shortLength_ = static_cast<unsigned char>(length);
+            allocated_ = false;
+        } else {
+            value_.string_ = { newSharedString(std::string_view{ value, length }), static_cast<unsigned int>(length) };
+            shortLength_ = notShortString;
+            allocated_ = true;
+        }
     }
 
     std::string Value::asString(const std::string& defaultValue) const {
@@ -387,7 +922,7 @@ namespace Json {
         case nullValue:
             return defaultValue;
         case stringValue:
-            return value_.string_ ? value_.string_ : "";
+            return std::string(stringView());
         case booleanValue:
             return value_.bool_ ? "true" : "false";
         case intValue:
@@ -601,8 +1136,9 @@ namespace Json {
         case booleanValue:
             return value_.bool_;
         case stringValue:
-            return value_.string_ && value_.string_[0] != '\0';
+            return !stringView().empty();
         case arrayValue:
+            return !value_.array_->empty();
         case objectValue:
             return !value_.map_->empty();
         default:
@@ -629,9 +1165,9 @@ namespace Json {
             return (other == nullValue && value_.bool_ == false) || other == intValue || other == uintValue || other == realValue || other == stringValue ||
                 other == booleanValue;
         case stringValue:
-            return other == stringValue || (other == nullValue && (!value_.string_ || value_.string_[0] == '\0'));
+            return other == stringValue || (other == nullValue && stringView().empty());
         case arrayValue:
-            return other == arrayValue || (other == nullValue && value_.map_->empty());
+            return other == arrayValue || (other == nullValue && value_.array_->empty());
         case objectValue:
             return other == objectValue || (other == nullValue && value_.map_->empty());
         default:
@@ -650,13 +1186,8 @@ namespace Json {
         case booleanValue:
         case stringValue:
             return 0;
-        case arrayValue: // size of the array is highest index + 1
-            if (!value_.map_->empty()) {
-                ObjectValues::const_iterator itLast = value_.map_->end();
-                --itLast;
-                return (*itLast).first.index() + 1;
-            }
-            return 0;
+        case arrayValue:
+            return ArrayIndex(value_.array_->size());
         case objectValue:
             return ArrayIndex(value_.map_->size());
         default:
@@ -679,10 +1210,14 @@ namespace Json {
     void Value::clear() {
         JSONCPP_ASSERT(type_ == nullValue || type_ == arrayValue || type_ == objectValue);
 
+        detach();
         switch (type_) {
         case arrayValue:
+            value_.array_->clear();
+            break;
         case objectValue:
             value_.map_->clear();
+            memberIndex(value_.map_).clear();
             break;
         default:
             break;
@@ -693,17 +1228,15 @@ namespace Json {
         JSONCPP_ASSERT(type_ == nullValue || type_ == arrayValue);
         if (type_ == nullValue)
             *this = Value(arrayValue);
-        ArrayIndex oldSize = size();
-        if (newSize == 0)
-            clear();
-        else if (newSize > oldSize)
-            (*this)[newSize - 1];
-        else {
-            for (ArrayIndex index = newSize; index < oldSize; ++index) {
-                value_.map_->erase(index);
-            }
-            assert(size() == newSize);
-        }
+        detach();
+        value_.array_->resize(newSize);
+    }
+
+    void Value::reserve(ArrayIndex newSize) {
+        JSONCPP_ASSERT(type_ == nullValue || type_ == arrayValue || type_ == objectValue);
+        if (type_ == objectValue)
+            return;
+        arrayValues().reserve(newSize);
     }
 
     Value& Value::get(ArrayIndex index) {
@@ -742,31 +1275,45 @@ namespace Json {
         return *value;
     }
 
+    /* Returned by the modifying accessors called on a value of another type
+     * when JSONCPP_FAIL_MESSAGE does not throw: whatever is stored into it is
+     * dropped by the next mismatched access on the same thread.
+     */
+    static Value& discardedValue([[maybe_unused]] const char* message) {
+        JSONCPP_FAIL_MESSAGE(message);
+        static thread_local Value discarded;
+        discarded = Value();
+        return discarded;
+    }
+
     Value* Value::tryGet(ArrayIndex index) {
+        pin();
         return const_cast<Value*>(std::as_const(*this).tryGet(index));
     }
 
     const Value* Value::tryGet(ArrayIndex index) const {
         JSONCPP_ASSERT(type_ == nullValue || type_ == arrayValue);
-        if (type_ == nullValue)
+        if (type_ != arrayValue || index >= value_.array_->size())
             return nullptr;
 
-        const auto it = value_.map_->find(index);
-        if (it != value_.map_->end()) {
-            return &it->second;
-        }
-        return nullptr;
+        return &(*value_.array_)[index];
     }
 
     Value* Value::tryGet(std::string_view key) {
+        pin();
         return const_cast<Value*>(std::as_const(*this).tryGet(key));
     }
 
     const Value* Value::tryGet(std::string_view key) const {
         JSONCPP_ASSERT(type_ == nullValue || type_ == objectValue);
-        if (type_ == nullValue)
+        if (type_ != objectValue)
             return nullptr;
 
+        const MemberIndex& index = memberIndex(value_.map_);
+        if (index.isBuilt()) {
+            const auto member = index.find(key);
+            return member ? &member->second : nullptr;
+        }
         const auto it = value_.map_->find(key);
         if (it != value_.map_->end()) {
             return &it->second;
@@ -775,13 +1322,16 @@ namespace Json {
     }
 
     Value* Value::tryGet(const CZString& key) {
+        pin();
         return const_cast<Value*>(std::as_const(*this).tryGet(key));
     }
 
     const Value* Value::tryGet(const CZString& key) const {
         JSONCPP_ASSERT(type_ == nullValue || type_ == objectValue);
-        if (type_ == nullValue)
+        if (type_ != objectValue)
             return nullptr;
+        if (key.c_str())
+            return tryGet(std::string_view{ key.c_str(), key.length() });
 
         const auto it = value_.map_->find(key);
         if (it != value_.map_->end()) {
@@ -794,36 +1344,52 @@ namespace Json {
         JSONCPP_ASSERT(type_ == nullValue || type_ == arrayValue);
         if (type_ == nullValue)
             *this = Value(arrayValue);
+        else if (type_ != arrayValue)
+            return discardedValue("Value is not an array");
 
-        auto ret = this->tryGet(index);
-        if (ret) {
-            return *ret;
-        }
-        return value_.map_->emplace(index, null).first->second;
+        pin();
+        if (index >= value_.array_->size())
+            value_.array_->resize(index + 1);
+        return (*value_.array_)[index];
     }
 
     Value& Value::operator[](std::string_view key) {
         JSONCPP_ASSERT(type_ == nullValue || type_ == objectValue);
         if (type_ == nullValue)
             *this = Value(objectValue);
+        else if (type_ != objectValue)
+            return discardedValue("Value is not an object");
 
         auto ret = this->tryGet(key);
         if (ret) {
             return *ret;
         }
-        return value_.map_->emplace(key, null).first->second;
+        if (auto resource = arenaResource()) {
+            // The member name is stored alongside the map nodes in the arena.
+            char* name = static_cast<char*>(resource->allocate(key.length() + 1, 1));
+            memcpy(name, key.data(), key.length());
+            name[key.length()] = 0;
+            auto inserted = value_.map_->emplace(std::piecewise_construct, std::forward_as_tuple(name, key.length(), CZString::duplicateOnCopy),
+                                                 std::forward_as_tuple());
+            return indexMember(value_.map_, inserted.first);
+        }
+        return indexMember(value_.map_, value_.map_->emplace(key, null).first);
     }
 
     Value& Value::operator[](const CZString& key) {
         JSONCPP_ASSERT(type_ == nullValue || type_ == objectValue);
         if (type_ == nullValue)
             *this = Value(objectValue);
+        else if (type_ != objectValue)
+            return discardedValue("Value is not an object");
 
         auto ret = this->tryGet(key);
         if (ret) {
             return *ret;
         }
-        return value_.map_->emplace(key, null).first->second;
+        if (!key.isStaticString() && arenaResource())
+            return (*this)[std::string_view{ key.c_str(), key.length() }];
+        return indexMember(value_.map_, value_.map_->emplace(key, null).first);
     }
 
     Value& Value::operator[](const StaticString& key) {
@@ -831,16 +1397,21 @@ namespace Json {
     }
 
     Value& Value::resolveReference(const char* key, bool isStatic) {
-        JSONCPP_ASSERT(type_ == nullValue || type_ == objectValue);
-        if (type_ == nullValue)
-            *this = Value(objectValue);
-
         CZString actualKey(key, isStatic ? CZString::noDuplication : CZString::duplicateOnCopy);
-        auto ret = this->tryGet(actualKey);
-        if (ret) {
-            return *ret;
+        return (*this)[actualKey];
+    }
+
+    std::pmr::memory_resource* Value::arenaResource() const {
+        if (allocated_)
+            return nullptr;
+        switch (type_) {
+        case arrayValue:
+            return value_.array_->get_allocator().resource();
+        case objectValue:
+            return value_.map_->get_allocator().resource();
+        default:
+            return nullptr;
         }
-        return value_.map_->emplace(actualKey, null).first->second;
     }
 
     bool Value::isValidIndex(ArrayIndex index) const {
@@ -848,7 +1419,25 @@ namespace Json {
     }
 
     Value& Value::append(const Value& value) {
-        return (*this)[size()] = value;
+        Value& element = arrayValues().emplace_back(value);
+        pin();
+        return element;
+    }
+
+    Value& Value::append(Value&& value) {
+        Value& element = arrayValues().emplace_back(std::move(value));
+        pin();
+        return element;
+    }
+
+    Value::ArrayValues& Value::arrayValues() {
+        JSONCPP_ASSERT(type_ == nullValue || type_ == arrayValue);
+        if (type_ == nullValue)
+            *this = Value(arrayValue);
+        else if (type_ != arrayValue)
+            return discardedValue("Value is not an array").arrayValues();
+        detach();
+        return *value_.array_;
     }
 
     Value Value::removeMember(std::string_view key) {
@@ -856,13 +1445,40 @@ namespace Json {
         if (type_ == nullValue)
             return null;
 
-        const auto it = value_.map_->find(key);
-        if (it != value_.map_->end()) {
-            Value old(it->second);
-            value_.map_->erase(it);
-            return old;
-        }
-        return null;
+        Value old;
+        removeMember(key, &old);
+        return old;
+    }
+
+    bool Value::removeMember(std::string_view key, Value* removed) {
+        JSONCPP_ASSERT(type_ == nullValue || type_ == objectValue);
+        if (type_ != objectValue)
+            return false;
+
+        auto it = value_.map_->find(key);
+        if (it == value_.map_->end())
+            return false;
+        const ObjectValues* map = value_.map_;
+        detach(); // only copy the object if the member exists
+        if (value_.map_ != map)
+            it = value_.map_->find(key);
+        if (removed)
+            *removed = std::move(it->second);
+        memberIndex(value_.map_).erase(*it);
+        value_.map_->erase(it);
+        return true;
+    }
+
+    Value& Value::insert(std::string_view key, const Value& value) {
+        Value& member = (*this)[key];
+        member = value;
+        return member;
+    }
+
+    Value& Value::insert(std::string_view key, Value&& value) {
+        Value& member = (*this)[key];
+        member = std::move(value);
+        return member;
     }
 
     bool Value::isMember(std::string_view key) const {
@@ -878,6 +1494,79 @@ namespace Json {
         return *value_.map_;
     }
 
+    // //////////////////////////////////////////////////////////////////
+    // //////////////////////////////////////////////////////////////////
+    // //////////////////////////////////////////////////////////////////
+    // class KeyTable
+    // //////////////////////////////////////////////////////////////////
+    // //////////////////////////////////////////////////////////////////
+    // //////////////////////////////////////////////////////////////////
+
+    KeyTable::KeyTable() : names_{} {}
+
+    KeyTable::KeyTable(const KeyTable& other) : names_{ other.names_ } {
+        for (auto& [_, name] : names_)
+            retainSharedString(name);
+    }
+
+    KeyTable::~KeyTable() {
+        clear();
+    }
+
+    KeyTable& KeyTable::operator=(const KeyTable& other) {
+        KeyTable temp(other);
+        swap(temp);
+        return *this;
+    }
+
+    void KeyTable::swap(KeyTable& other) {
+        names_.swap(other.names_);
+    }
+
+    Value& KeyTable::resolve(Value& object, std::string_view name) {
+        JSONCPP_ASSERT(object.type_ == nullValue || object.type_ == objectValue);
+        if (object.type_ == nullValue)
+            object = Value(objectValue);
+        else if (object.type_ != objectValue)
+            return discardedValue("Value is not an object");
+
+        if (object.arenaResource())
+            return object[name];
+        object.pin();
+        Value::ObjectValues& members = *object.value_.map_;
+        auto it = members.end();
+        if (const MemberIndex& index = memberIndex(&members); index.isBuilt()) {
+            if (auto member = index.find(name))
+                return const_cast<Value&>(member->second);
+        } else {
+            it = members.lower_bound(name);
+            if (it != members.end() && !members.key_comp()(name, it->first))
+                return it->second;
+        }
+        it = members.emplace_hint(it, std::piecewise_construct, std::forward_as_tuple(intern(name), name.length(), Value::CZString::interned),
+                                  std::forward_as_tuple());
+        return indexMember(&members, it);
+    }
+
+    size_t KeyTable::size() const {
+        return names_.size();
+    }
+
+    void KeyTable::clear() {
+        for (auto& [_, name] : names_)
+            releaseSharedString(name);
+        names_.clear();
+    }
+
+    const char* KeyTable::intern(std::string_view name) {
+        auto it = names_.find(name);
+        if (it != names_.end())
+            return it->second;
+        char* newName = newSharedString(name);
+        names_.emplace(std::string_view{ newName, name.length() }, newName);
+        return newName;
+    }
+
     bool Value::isNull() const {
         return type_ == nullValue;
     }
@@ -940,6 +1629,9 @@ namespace Json {
     Value::const_iterator Value::begin() const {
         switch (type_) {
         case arrayValue:
+            if (value_.array_)
+                return const_iterator(value_.array_->begin(), value_.array_->begin());
+            break;
         case objectValue:
             if (value_.map_)
                 return const_iterator(value_.map_->begin());
@@ -953,6 +1645,9 @@ namespace Json {
     Value::const_iterator Value::end() const {
         switch (type_) {
         case arrayValue:
+            if (value_.array_)
+                return const_iterator(value_.array_->end(), value_.array_->begin());
+            break;
         case objectValue:
             if (value_.map_)
                 return const_iterator(value_.map_->end());
@@ -964,8 +1659,12 @@ namespace Json {
     }
 
     Value::iterator Value::begin() {
+        pin();
         switch (type_) {
         case arrayValue:
+            if (value_.array_)
+                return iterator(value_.array_->begin(), value_.array_->begin());
+            break;
         case objectValue:
             if (value_.map_)
                 return iterator(value_.map_->begin());
@@ -977,8 +1676,12 @@ namespace Json {
     }
 
     Value::iterator Value::end() {
+        pin();
         switch (type_) {
         case arrayValue:
+            if (value_.array_)
+                return iterator(value_.array_->end(), value_.array_->begin());
+            break;
         case objectValue:
             if (value_.map_)
                 return iterator(value_.map_->end());
@@ -995,7 +1698,12 @@ namespace Json {
 
     Path::Path(
         const std::string& path, const PathArgument& a1, const PathArgument& a2, const PathArgument& a3, const PathArgument& a4, const PathArgument& a5
-    ) {
+    ) :
+        steps_{}, keys_{}, valid_{ true } {
+        if (!path.empty() && path[0] == '/') {
+            makePointer(path);
+            return;
+        }
         InArgs in;
         in.push_back(&a1);
         in.push_back(&a2);
@@ -1012,16 +1720,19 @@ namespace Json {
         while (current != end) {
             if (*current == '[') {
                 ++current;
-                if (*current == '%')
+                if (current != end && *current == '%') {
                     addPathInArg(path, in, itInArg, PathArgument::kindIndex);
-                else {
+                    ++current;
+                } else {
                     ArrayIndex index = 0;
                     for (; current != end && *current >= '0' && *current <= '9'; ++current)
                         index = index * 10 + ArrayIndex(*current - '0');
-                    args_.emplace_back(index);
+                    addStep(PathArgument::kindIndex, index, std::string_view());
                 }
-                if (current == end || *current++ != ']')
+                if (current == end || *current++ != ']') {
                     invalidPath(path, int(current - path.c_str()));
+                    return;
+                }
             } else if (*current == '%') {
                 addPathInArg(path, in, itInArg, PathArgument::kindKey);
                 ++current;
@@ -1031,96 +1742,186 @@ namespace Json {
                 const char* beginName = current;
                 while (current != end && !strchr("[.", *current))
                     ++current;
-                args_.push_back(std::string(beginName, current));
+                addStep(PathArgument::kindKey, 0, std::string_view(beginName, current - beginName));
+            }
+        }
+    }
+
+    void Path::makePointer(const std::string& pointer) {
+        const char* current = pointer.c_str();
+        const char* end = current + pointer.length();
+        while (current != end) {
+            ++current; // skip '/'
+            Step step{ PathArgument::kindToken, notAnIndex, static_cast<unsigned int>(keys_.size()), 0 };
+            for (; current != end && *current != '/'; ++current) {
+                char c = *current;
+                if (c == '~') {
+                    if (++current == end || (*current != '0' && *current != '1')) {
+                        invalidPath(pointer, int(current - pointer.c_str()));
+                        return;
+                    }
+                    c = *current == '0' ? '~' : '/';
+                }
+                keys_ += c;
             }
+            step.keyLength_ = static_cast<unsigned int>(keys_.size() - step.keyBegin_);
+            decodePointerIndex(key(step), step.index_);
+            steps_.push_back(step);
         }
     }
 
     void Path::addPathInArg([[maybe_unused]] const std::string& path, const InArgs& in, InArgs::const_iterator& itInArg, PathArgument::Kind kind) {
-        if (itInArg == in.end()) {
+        if (itInArg == in.end() || (*itInArg)->kind_ == PathArgument::kindNone) {
             // Error: missing argument %d
+            valid_ = false;
         } else if ((*itInArg)->kind_ != kind) {
             // Error: bad argument type
+            valid_ = false;
         } else {
-            args_.push_back(**itInArg);
+            addStep(kind, (*itInArg)->index_, (*itInArg)->key_);
         }
+        if (itInArg != in.end())
+            ++itInArg;
+    }
+
+    void Path::addStep(PathArgument::Kind kind, ArrayIndex index, std::string_view key) {
+        steps_.push_back(Step{ kind, index, static_cast<unsigned int>(keys_.size()), static_cast<unsigned int>(key.length()) });
+        keys_.append(key);
     }
 
     void Path::invalidPath([[maybe_unused]] const std::string& path, [[maybe_unused]] int location) {
         // Error: invalid path.
+        valid_ = false;
+    }
+
+    bool Path::sameStep(size_t position, const Path& other, size_t otherPosition) const {
+        const Step& step = steps_[position];
+        const Step& otherStep = other.steps_[otherPosition];
+        return step.kind_ == otherStep.kind_ && step.index_ == otherStep.index_ && key(step) == other.key(otherStep);
+    }
+
+    // Node is const for lookups, and non const to detach the containers on the way.
+    template <typename Node>
+    Node* Path::child(Node& node, const Step& step) const {
+        switch (step.kind_) {
+        case PathArgument::kindIndex:
+            return node.type() == arrayValue ? node.tryGet(step.index_) : nullptr;
+        case PathArgument::kindKey:
+            return node.type() == objectValue ? node.tryGet(key(step)) : nullptr;
+        case PathArgument::kindToken:
+            if (node.type() == objectValue)
+                return node.tryGet(key(step));
+            if (node.type() == arrayValue && step.index_ != notAnIndex)
+                return node.tryGet(step.index_);
+            return nullptr;
+        case PathArgument::kindNone:
+            break;
+        }
+        return nullptr;
     }
 
-    const Value& Path::resolve(const Value& root) const {
+    const Value* Path::find(const Value& root) const {
         const Value* node = &root;
-        for (const auto& arg : args_) {
-            if (arg.kind_ == PathArgument::kindIndex) {
-                if (!node->isArray() || node->isValidIndex(arg.index_)) {
-                    // Error: unable to resolve path (array value expected at position...
-                }
-
-                {
-                    auto temp = node->tryGet(arg.index_);
-                    node = (temp ? temp : &Value::null);
-                }
-            } else if (arg.kind_ == PathArgument::kindKey) {
-                if (!node->isObject()) {
-                    // Error: unable to resolve path (object value expected at position...)
-                }
+        for (const auto& step : steps_) {
+            node = child(*node, step);
+            if (!node)
+                break;
+        }
+        return node;
+    }
 
-                {
-                    auto temp = node->tryGet(arg.key_);
-                    node = (temp ? temp : &Value::null);
-                }
-                if (node == &Value::null) {
-                    // Error: unable to resolve path (object has no member named '' at position...)
-                }
-            }
+    Value* Path::find(Value& root) const {
+        Value* node = &root;
+        for (const auto& step : steps_) {
+            node = child(*node, step);
+            if (!node)
+                break;
         }
-        return *node;
+        return node;
+    }
+
+    const Value& Path::resolve(const Value& root) const {
+        const Value* node = find(root);
+        return node ? *node : Value::null;
     }
 
     Value Path::resolve(const Value& root, const Value& defaultValue) const {
-        const Value* node = &root;
-        for (const auto& arg : args_) {
-            if (arg.kind_ == PathArgument::kindIndex) {
-                if (!node->isArray() || node->isValidIndex(arg.index_))
-                    return defaultValue;
-
-                {
-                    auto temp = node->tryGet(arg.index_);
-                    node = (temp ? temp : &Value::null);
-                }
-            } else if (arg.kind_ == PathArgument::kindKey) {
-                if (!node->isObject())
-                    return defaultValue;
-                
-                {
-                    auto temp = node->tryGet(arg.key_);
-                    node = (temp ? temp : &Value::null);
-                }
-                if (node == &Value::null)
-                    return defaultValue;
-            }
-        }
-        return *node;
+        const Value* node = find(root);
+        return node ? *node : defaultValue;
     }
 
     Value& Path::make(Value& root) const {
         Value* node = &root;
-        for (const auto& arg : args_) {
-            if (arg.kind_ == PathArgument::kindIndex) {
-                if (!node->isArray()) {
-                    // Error: node is not an array at position ...
-                }
-                node = &((*node)[arg.index_]);
-            } else if (arg.kind_ == PathArgument::kindKey) {
-                if (!node->isObject()) {
-                    // Error: node is not an object at position...
-                }
-                node = &((*node)[arg.key_]);
+        for (const auto& step : steps_) {
+            switch (step.kind_) {
+            case PathArgument::kindIndex:
+                // Error if the node is not an array
+                node = &((*node)[step.index_]);
+                break;
+            case PathArgument::kindKey:
+                // Error if the node is not an object
+                node = &((*node)[key(step)]);
+                break;
+            case PathArgument::kindToken:
+                if (node->type() == arrayValue && key(step) == "-")
+                    node = &node->append(Value());
+                else if (node->type() == arrayValue && step.index_ != notAnIndex)
+                    node = &((*node)[step.index_]);
+                else // Error if the node is an array
+                    node = &((*node)[key(step)]);
+                break;
+            case PathArgument::kindNone:
+                break;
             }
         }
         return *node;
     }
 
+    // class PathSet
+    // //////////////////////////////////////////////////////////////////
+
+    PathSet::PathSet() : paths_{}, nextEnd_{}, nodes_{ Node{ none, 0, none, none, none } } {}
+
+    size_t PathSet::add(const Path& path) {
+        size_t id = paths_.size();
+        paths_.push_back(path);
+        nextEnd_.push_back(none);
+        size_t node = 0;
+        for (size_t position = 0; position < path.size(); ++position) {
+            size_t child = nodes_[node].firstChild_;
+            size_t previous = none;
+            while (child != none && !paths_[nodes_[child].path_].sameStep(nodes_[child].step_, path, position)) {
+                previous = child;
+                child = nodes_[child].nextSibling_;
+            }
+            if (child == none) {
+                child = nodes_.size();
+                nodes_.push_back(Node{ id, position, none, none, none });
+                if (previous == none)
+                    nodes_[node].firstChild_ = child;
+                else
+                    nodes_[previous].nextSibling_ = child;
+            }
+            node = child;
+        }
+        nextEnd_[id] = nodes_[node].firstEnd_;
+        nodes_[node].firstEnd_ = id;
+        return id;
+    }
+
+    void PathSet::find(const Value& root, std::vector<const Value*>& results) const {
+        results.assign(paths_.size(), nullptr);
+        find(0, root, results);
+    }
+
+    void PathSet::find(size_t node, const Value& value, std::vector<const Value*>& results) const {
+        for (size_t end = nodes_[node].firstEnd_; end != none; end = nextEnd_[end])
+            results[end] = &value;
+        for (size_t child = nodes_[node].firstChild_; child != none; child = nodes_[child].nextSibling_) {
+            const Path& path = paths_[nodes_[child].path_];
+            if (const Value* childValue = path.child(value, path.steps_[nodes_[child].step_]))
+                find(child, *childValue, results);
+        }
+    }
+
 } // namespace Json
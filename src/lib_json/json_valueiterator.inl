@@ -16,22 +16,32 @@ namespace Json {
     // //////////////////////////////////////////////////////////////////
 
     ValueIteratorBase::ValueIteratorBase()
-        : current_(), isNull_(true){}
+        : current_(), arrayCurrent_(), arrayBegin_(), isNull_(true), isArray_(false) {}
 
-          ValueIteratorBase::ValueIteratorBase(const Value::ObjectValues::iterator& current)
-        : current_(current), isNull_(false) {
-    }
+    ValueIteratorBase::ValueIteratorBase(const Value::ObjectValues::iterator& current)
+        : current_(current), arrayCurrent_(), arrayBegin_(), isNull_(false), isArray_(false) {}
+
+    ValueIteratorBase::ValueIteratorBase(const Value::ArrayValues::iterator& current, const Value::ArrayValues::iterator& begin)
+        : current_(), arrayCurrent_(current), arrayBegin_(begin), isNull_(false), isArray_(true) {}
 
     Value& ValueIteratorBase::deref() const {
+        if (isArray_)
+            return *arrayCurrent_;
         return current_->second;
     }
 
     void ValueIteratorBase::increment() {
-        ++current_;
+        if (isArray_)
+            ++arrayCurrent_;
+        else
+            ++current_;
     }
 
     void ValueIteratorBase::decrement() {
-        --current_;
+        if (isArray_)
+            --arrayCurrent_;
+        else
+            --current_;
     }
 
     ValueIteratorBase::difference_type ValueIteratorBase::computeDistance(const SelfType& other) const {
@@ -44,6 +54,10 @@ namespace Json {
             return 0;
         }
 
+        if (isArray_) {
+            return difference_type(other.arrayCurrent_ - arrayCurrent_);
+        }
+
         // Usage of std::distance is not portable (does not compile with Sun Studio 12 RogueWave STL,
         // which is the one used by default).
         // Using a portable hand-made version for non random iterator instead:
@@ -59,24 +73,35 @@ namespace Json {
         if (isNull_) {
             return other.isNull_;
         }
-        return current_ == other.current_;
+        if (isArray_) {
+            return other.isArray_ && arrayCurrent_ == other.arrayCurrent_;
+        }
+        return !other.isArray_ && current_ == other.current_;
     }
 
     void ValueIteratorBase::copy(const SelfType& other) {
         current_ = other.current_;
+        arrayCurrent_ = other.arrayCurrent_;
+        arrayBegin_ = other.arrayBegin_;
+        isNull_ = other.isNull_;
+        isArray_ = other.isArray_;
     }
 
     Value ValueIteratorBase::key() const {
-        const Value::CZString czstring = (*current_).first;
+        if (isArray_)
+            return Value(index());
+        const Value::CZString& czstring = (*current_).first;
         if (czstring.c_str()) {
             if (czstring.isStaticString())
                 return Value(StaticString(czstring.c_str()));
-            return Value(czstring.c_str());
+            return Value(std::string_view(czstring.c_str(), czstring.length()));
         }
         return Value(czstring.index());
     }
 
     UInt ValueIteratorBase::index() const {
+        if (isArray_)
+            return Value::UInt(arrayCurrent_ - arrayBegin_);
         const Value::CZString czstring = (*current_).first;
         if (!czstring.c_str())
             return czstring.index();
@@ -84,6 +109,8 @@ namespace Json {
     }
 
     const char* ValueIteratorBase::memberName() const {
+        if (isArray_)
+            return "";
         const char* name = (*current_).first.c_str();
         return name ? name : "";
     }
@@ -100,6 +127,9 @@ namespace Json {
 
     ValueConstIterator::ValueConstIterator(const Value::ObjectValues::iterator& current) : ValueIteratorBase(current) {}
 
+    ValueConstIterator::ValueConstIterator(const Value::ArrayValues::iterator& current, const Value::ArrayValues::iterator& begin) :
+        ValueIteratorBase(current, begin) {}
+
     ValueConstIterator& ValueConstIterator::operator=(const ValueIteratorBase& other) {
         copy(other);
         return *this;
@@ -117,6 +147,9 @@ namespace Json {
 
     ValueIterator::ValueIterator(const Value::ObjectValues::iterator& current) : ValueIteratorBase(current) {}
 
+    ValueIterator::ValueIterator(const Value::ArrayValues::iterator& current, const Value::ArrayValues::iterator& begin) :
+        ValueIteratorBase(current, begin) {}
+
     ValueIterator::ValueIterator(const ValueConstIterator& other) : ValueIteratorBase(other) {}
 
     ValueIterator::ValueIterator(const ValueIterator& other) : ValueIteratorBase(other) {}
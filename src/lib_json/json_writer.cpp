@@ -12,8 +12,12 @@
 #include <stdio.h>
 #include <string.h>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 #if _MSC_VER >= 1400            // VC++ 8.0
 #pragma warning(disable : 4996) // disable warning about strdup being deprecated.
@@ -21,14 +25,6 @@
 
 namespace Json {
 
-    static bool containsControlCharacter(const char* str) {
-        while (*str) {
-            if (isControlCharacter(*(str++)))
-                return true;
-        }
-        return false;
-    }
-
     std::string valueToString(LargestInt value) {
         UIntToStringBuffer buffer;
         char* current = buffer + sizeof(buffer);
@@ -63,42 +59,9 @@ namespace Json {
 #endif // # if defined(JSONCPP_HAS_INT64)
 
     std::string valueToString(double value) {
-        char buffer[32];
-#if defined(_MSC_VER) && defined(__STDC_SECURE_LIB__) // Use secure version with visual studio 2005 to avoid warning.
-        sprintf_s(buffer, sizeof(buffer), "%#.16g", value);
-#else
-        sprintf(buffer, "%#.16g", value);
-#endif
-        char* ch = buffer + strlen(buffer) - 1;
-        if (*ch != '0')
-            return buffer; // nothing to truncate, so save time
-        while (ch > buffer && *ch == '0') {
-            --ch;
-        }
-        char* last_nonzero = ch;
-        while (ch >= buffer) {
-            switch (*ch) {
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                    --ch;
-                    continue;
-                case '.':
-                    // Truncate zeroes to save bytes in output, but keep one.
-                    *(last_nonzero + 2) = '\0';
-                    return buffer;
-                default:
-                    return buffer;
-            }
-        }
-        return buffer;
+        DoubleToStringBuffer buffer;
+        char* end = doubleToString(value, buffer);
+        return std::string(buffer, end);
     }
 
     std::string valueToString(bool value) {
@@ -106,62 +69,107 @@ namespace Json {
     }
 
     std::string valueToQuotedString(const char* value) {
-        // Not sure how to handle unicode...
-        if (strpbrk(value, "\"\\\b\f\n\r\t") == NULL && !containsControlCharacter(value))
-            return std::string("\"") + value + "\"";
-        // We have to walk value and escape any special characters.
-        // Appending to std::string is not efficient, but this should be rare.
-        // (Note: forward slashes are *not* rare, but I am not escaping them.)
-        std::string::size_type maxsize = strlen(value) * 2 + 3; // allescaped+quotes+NULL
+        size_t length = strlen(value);
         std::string result;
-        result.reserve(maxsize); // to avoid lots of mallocs
-        result += "\"";
-        for (const char* c = value; *c != 0; ++c) {
-            switch (*c) {
-                case '\"':
-                    result += "\\\"";
-                    break;
-                case '\\':
-                    result += "\\\\";
-                    break;
-                case '\b':
-                    result += "\\b";
-                    break;
-                case '\f':
-                    result += "\\f";
-                    break;
-                case '\n':
-                    result += "\\n";
-                    break;
-                case '\r':
-                    result += "\\r";
-                    break;
-                case '\t':
-                    result += "\\t";
-                    break;
-                // case '/':
-                //  Even though \/ is considered a legal escape in JSON, a bare
-                //  slash is also legal, so I see no reason to escape it.
-                //  (I hope I am not misunderstanding something.
-                //  blep notes: actually escaping \/ may be useful in javascript to avoid </
-                //  sequence.
-                //  Should add a flag to allow this compatibility mode and prevent this
-                //  sequence from occurring.
-                default:
-                    if (isControlCharacter(*c)) {
-                        std::ostringstream oss;
-                        oss << "\\u" << std::hex << std::uppercase << std::setfill('0') << std::setw(4) << static_cast<int>(*c);
-                        result += oss.str();
-                    } else {
-                        result += *c;
-                    }
-                    break;
-            }
-        }
-        result += "\"";
+        result.reserve(length + 2);
+        writeQuotedString(result, value, value + length);
         return result;
     }
 
+    // Class OutputSink
+    // //////////////////////////////////////////////////////////////////
+
+    OutputSink::~OutputSink() {}
+
+    // Appends to a std::string.
+    class StringSink : public OutputSink {
+    public:
+        explicit StringSink(std::string& document) : document_{ document } {}
+
+        void write(const char* data, size_t length) override {
+            document_.append(data, length);
+        }
+
+    private:
+        std::string& document_;
+    };
+
+    // Copies what fits in [buffer, buffer + capacity), counting all the characters.
+    class ArraySink : public OutputSink {
+    public:
+        ArraySink(char* buffer, size_t capacity) : buffer_{ buffer }, capacity_{ capacity }, length_{ 0 } {}
+
+        void write(const char* data, size_t length) override {
+            if (length_ < capacity_)
+                memcpy(buffer_ + length_, data, std::min(length, capacity_ - length_));
+            length_ += length;
+        }
+
+        size_t length() const {
+            return length_;
+        }
+
+    private:
+        char* buffer_;
+        size_t capacity_;
+        size_t length_;
+    };
+
+    class StreamSink : public OutputSink {
+    public:
+        explicit StreamSink(std::ostream& out) : out_{ out } {}
+
+        void write(const char* data, size_t length) override {
+            out_.write(data, std::streamsize(length));
+        }
+
+    private:
+        std::ostream& out_;
+    };
+
+    /* Accumulates the output of a writer in a fixed-size chunk, which is
+     * handed to the sink each time it is full.
+     */
+    class ChunkedOutput {
+    public:
+        explicit ChunkedOutput(OutputSink& sink) : sink_{ sink }, flushed_{ 0 }, length_{ 0 } {}
+
+        ~ChunkedOutput() {
+            flush();
+        }
+
+        void append(const char* data, size_t length) {
+            if (length_ + length > sizeof(chunk_)) {
+                flush();
+                if (length > sizeof(chunk_)) {
+                    sink_.write(data, length);
+                    flushed_ += length;
+                    return;
+                }
+            }
+            memcpy(chunk_ + length_, data, length);
+            length_ += length;
+        }
+
+        void flush() {
+            if (length_ != 0)
+                sink_.write(chunk_, length_);
+            flushed_ += length_;
+            length_ = 0;
+        }
+
+        /// Number of characters appended so far.
+        size_t size() const {
+            return flushed_ + length_;
+        }
+
+    private:
+        OutputSink& sink_;
+        size_t flushed_;
+        size_t length_;
+        char chunk_[4096];
+    };
+
     // Class Writer
     // //////////////////////////////////////////////////////////////////
     Writer::~Writer() {}
@@ -169,483 +177,981 @@ namespace Json {
     // Class FastWriter
     // //////////////////////////////////////////////////////////////////
 
-    FastWriter::FastWriter() : yamlCompatiblityEnabled_(false) {}
+    FastWriter::FastWriter() : yamlCompatiblityEnabled_(false), threadCount_(1) {}
 
     void FastWriter::enableYAMLCompatibility() {
         yamlCompatiblityEnabled_ = true;
     }
 
-    std::string FastWriter::write(const Value& root) {
-        document_ = "";
-        writeValue(root);
-        document_ += "\n";
-        return document_;
+    void FastWriter::enableParallelWrite(unsigned int threadCount) {
+        threadCount_ = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
     }
 
-    void FastWriter::writeValue(const Value& value) {
+    class FastWriter::Output : public ChunkedOutput {
+    public:
+        using ChunkedOutput::ChunkedOutput;
+    };
+
+    // Class FastWriter::ParallelWrite
+    // //////////////////////////////////////////////////////////////////
+
+    // Containers nested deeper than this are never split.
+    static const unsigned int maximumSplitDepth = 4;
+    // Nested containers are split if they have at least minimumSplitSize elements, or
+    // if their parent has fewer than shallowContainerSize elements: a small container
+    // near the root may hold large ones.
+    static const ArrayIndex minimumSplitSize = 256;
+    static const ArrayIndex shallowContainerSize = 16;
+    // Bounds of the weight of a task (see weightOf()).
+    static const size_t minimumTaskWeight = 4 * 1024;
+    static const size_t maximumTaskWeight = 256 * 1024;
+    static const size_t tasksPerThread = 8;
+    // Serialized tasks waiting to be written, per thread: bounds the memory used.
+    static const size_t bufferedTasksPerThread = 4;
+
+    /* Estimated cost of writing value: its number of elements for arrays and objects,
+     * a sixteenth of its length for strings. Looking deeper would cost as much as writing.
+     */
+    static size_t weightOf(const Value& value) {
         switch (value.type()) {
-        case nullValue:
-            document_ += "null";
-            break;
-        case intValue:
-            document_ += valueToString(value.asLargestInt());
-            break;
-        case uintValue:
-            document_ += valueToString(value.asLargestUInt());
-            break;
-        case realValue:
-            document_ += valueToString(value.asDouble());
-            break;
-        case stringValue:
-            document_ += valueToQuotedString(value.asCString());
-            break;
-        case booleanValue:
-            document_ += valueToString(value.asBool());
-            break;
-        case arrayValue: {
-            document_ += "[";
-            auto size = value.size();
-            for (ArrayIndex index = 0; index < size; ++index) {
-                if (index > 0)
-                    document_ += ",";
-                writeValue(value.get(index));
-            }
-            document_ += "]";
-        } break;
-        case objectValue: {
-            document_ += "{";
-            bool begin = false;
-            for (const auto& [name, _] : value.items()) {
-                if (std::exchange(begin, true))
-                    document_ += ",";
-                document_ += valueToQuotedString(name.c_str());
-                document_ += yamlCompatiblityEnabled_ ? ": " : ":";
-                writeValue(value.get(name));
-            }
-            document_ += "}";
-        } break;
+        case arrayValue:
+        case objectValue:
+            return 1 + size_t(value.size());
+        case stringValue: {
+            const char* begin;
+            const char* end;
+            value.getString(&begin, &end);
+            return 1 + size_t(end - begin) / 16;
+        }
+        default:
+            return 1;
         }
     }
 
-    // Class StyledWriter
-    // //////////////////////////////////////////////////////////////////
+    /* The document is planned as a sequence of spans: literal text (the brackets, the
+     * separators and the member names of the split containers), then a range of
+     * elements of a split container. Consecutive spans are grouped into tasks of about
+     * the same weight. Each task is serialized into its own buffer by any thread, and
+     * the calling thread writes the buffers in order; it serializes the next task to
+     * write directly to the output if no thread started it yet. Tasks are only started
+     * while fewer than window_ buffers wait to be written.
+     */
+    class FastWriter::ParallelWrite {
+    public:
+        ParallelWrite(FastWriter& writer, unsigned int threadCount);
+        ~ParallelWrite();
 
-    StyledWriter::StyledWriter() : childValues_{}, document_{}, indentString_{}, rightMargin_{ 74 }, indentSize_{ 3 }, addChildValues_{ false } {}
+        /// \brief Write root to out.
+        /// \return \c false, without writing anything, if root is too small to be split.
+        bool write(const Value& root, Output& out);
 
-    std::string StyledWriter::write(const Value& root) {
-        document_ = "";
-        addChildValues_ = false;
-        indentString_ = "";
-        writeCommentBeforeValue(root);
-        writeValue(root);
-        writeCommentAfterValueOnSameLine(root);
-        document_ += "\n";
-        return document_;
+    private:
+        struct Span {
+            // The literal text is text_[previous span's literalEnd_, literalEnd_).
+            size_t literalEnd_;
+            // Null for the literal text ending the document.
+            const Value* container_;
+            // Nesting depth of container_, the root being 1.
+            unsigned int depth_;
+            // Elements of an array.
+            ArrayIndex begin_;
+            ArrayIndex end_;
+            // Members of an object.
+            Value::ObjectValues::const_iterator first_;
+            Value::ObjectValues::const_iterator last_;
+        };
+
+        struct Task {
+            // The spans of the task are spans_[previous task's spanEnd_, spanEnd_).
+            size_t spanEnd_;
+            std::string document_;
+            Statistics statistics_;
+            bool done_;
+        };
+
+        void plan(const Value& container, unsigned int depth, Output& literal);
+        void addSpan(const Value& container, unsigned int depth, ArrayIndex begin, ArrayIndex end, Output& literal);
+        void addSpan(const Value& container, unsigned int depth, Value::ObjectValues::const_iterator first, Value::ObjectValues::const_iterator last,
+                     Output& literal);
+        bool schedule();
+        void addTask(const Span& span);
+        void work();
+        void execute(FastWriter& writer, size_t index);
+        void serialize(FastWriter& writer, size_t index, Output& out);
+        void writeSpan(FastWriter& writer, size_t position, Output& out);
+        void stop();
+
+        FastWriter& writer_;
+        unsigned int threadCount_;
+        std::string text_;
+        std::vector<Span> planned_;
+        std::vector<Span> spans_;
+        size_t weight_;
+        std::vector<Task> tasks_;
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        // Signaled when tasks are done, and when buffers are written.
+        std::condition_variable done_;
+        std::condition_variable written_;
+        // Buffers of the written tasks, reused by the next ones.
+        std::vector<std::string> buffers_;
+        size_t next_;
+        size_t writtenCount_;
+        size_t window_;
+        bool stopped_;
+        std::exception_ptr exception_;
+    };
+
+    FastWriter::ParallelWrite::ParallelWrite(FastWriter& writer, unsigned int threadCount)
+        : writer_{ writer }, threadCount_{ threadCount }, text_{}, planned_{}, spans_{}, weight_{ 0 }, tasks_{}, workers_{}, mutex_{}, done_{}, written_{},
+          buffers_{}, next_{ 0 }, writtenCount_{ 0 }, window_{ 0 }, stopped_{ false }, exception_{} {}
+
+    FastWriter::ParallelWrite::~ParallelWrite() {
+        stop();
     }
 
-    void StyledWriter::writeValue(const Value& value) {
-        switch (value.type()) {
-        case nullValue:
-            pushValue("null");
-            break;
-        case intValue:
-            pushValue(valueToString(value.asLargestInt()));
-            break;
-        case uintValue:
-            pushValue(valueToString(value.asLargestUInt()));
-            break;
-        case realValue:
-            pushValue(valueToString(value.asDouble()));
-            break;
-        case stringValue:
-            pushValue(valueToQuotedString(value.asCString()));
-            break;
-        case booleanValue:
-            pushValue(valueToString(value.asBool()));
-            break;
-        case arrayValue:
-            writeArrayValue(value);
-            break;
-        case objectValue: {
-            auto& items = value.items();
-            if (items.empty())
-                pushValue("{}");
-            else {
-                writeWithIndent("{");
-                indent();
-                auto it = items.begin();
-                for (;;) {
-                    const auto& [name, childValue] = *it;
-                    writeCommentBeforeValue(childValue);
-                    writeWithIndent(valueToQuotedString(name.c_str()));
-                    document_ += " : ";
-                    writeValue(childValue);
-                    if (++it == items.end()) {
-                        writeCommentAfterValueOnSameLine(childValue);
-                        break;
-                    }
-                    document_ += ",";
-                    writeCommentAfterValueOnSameLine(childValue);
+    bool FastWriter::ParallelWrite::write(const Value& root, Output& out) {
+        if ((root.type() != arrayValue && root.type() != objectValue) || root.size() == 0)
+            return false;
+        {
+            StringSink sink(text_);
+            Output literal(sink);
+            plan(root, 1, literal);
+            planned_.push_back(Span{ literal.size(), nullptr, 0, 0, 0, {}, {} });
+        }
+        if (!schedule()) {
+            // The planned containers and member names are counted again by writeValue().
+            JSONCPP_STATISTICS(writer_.statistics_.reset(Statistics::phaseWrite));
+            return false;
+        }
+
+        size_t threadCount = std::min<size_t>(threadCount_, tasks_.size());
+        window_ = threadCount * bufferedTasksPerThread;
+        for (size_t index = 1; index < threadCount; ++index)
+            workers_.emplace_back(&ParallelWrite::work, this);
+
+        // The calling thread serializes tasks too while it waits for the next buffer.
+        FastWriter helper;
+        helper.yamlCompatiblityEnabled_ = writer_.yamlCompatiblityEnabled_;
+        for (size_t index = 0; index < tasks_.size(); ++index) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // The next task to write is serialized directly to out if no thread started it.
+            bool direct = next_ == index && !exception_;
+            if (direct)
+                ++next_;
+            while (!direct && !tasks_[index].done_ && !exception_) {
+                if (next_ < tasks_.size() && next_ < writtenCount_ + window_) {
+                    size_t next = next_++;
+                    lock.unlock();
+                    execute(helper, next);
+                    lock.lock();
+                } else {
+                    done_.wait(lock);
                 }
-                unindent();
-                writeWithIndent("}");
             }
-        } break;
+            if (exception_)
+                break;
+            lock.unlock();
+
+            Task& task = tasks_[index];
+            if (direct)
+                serialize(helper, index, out);
+            else
+                out.append(task.document_.data(), task.document_.size());
+            task.document_.clear();
+            JSONCPP_STATISTICS(writer_.statistics_.nodes_ += task.statistics_.nodes_);
+            JSONCPP_STATISTICS(writer_.statistics_.stringBytes_ += task.statistics_.stringBytes_);
+            JSONCPP_STATISTICS(writer_.statistics_.maxDepth_ = std::max(writer_.statistics_.maxDepth_, task.statistics_.maxDepth_));
+            lock.lock();
+            buffers_.push_back(std::move(task.document_));
+            ++writtenCount_;
+            lock.unlock();
+            written_.notify_all();
         }
+        stop();
+        if (exception_)
+            std::rethrow_exception(exception_);
+        return true;
     }
 
-    void StyledWriter::writeArrayValue(const Value& value) {
-        auto size = value.size();
-        if (size == 0)
-            pushValue("[]");
-        else {
-            bool isArrayMultiLine = isMultineArray(value);
-            if (isArrayMultiLine) {
-                writeWithIndent("[");
-                indent();
-                bool hasChildValue = !childValues_.empty();
-                ArrayIndex index = 0;
-                for (;;) {
-                    const auto& childValue = value.get(index);
-                    writeCommentBeforeValue(childValue);
-                    if (hasChildValue)
-                        writeWithIndent(childValues_[index]);
-                    else {
-                        writeIndent();
-                        writeValue(childValue);
-                    }
-                    if (++index == size) {
-                        writeCommentAfterValueOnSameLine(childValue);
-                        break;
-                    }
-                    document_ += ",";
-                    writeCommentAfterValueOnSameLine(childValue);
+    /* Writes the opening bracket of container, the elements that are split in turn, and
+     * the closing bracket to literal, and adds the spans of the other elements.
+     */
+    void FastWriter::ParallelWrite::plan(const Value& container, unsigned int depth, Output& literal) {
+        JSONCPP_STATISTICS(++writer_.statistics_.nodes_);
+        JSONCPP_STATISTICS(writer_.statistics_.enterContainer());
+        ArrayIndex size = container.size();
+        auto split = [&](const Value& element) {
+            return depth < maximumSplitDepth && (element.type() == arrayValue || element.type() == objectValue) && element.size() > 0 &&
+                   (element.size() >= minimumSplitSize || size < shallowContainerSize);
+        };
+        if (container.type() == arrayValue) {
+            literal.append("[", 1);
+            ArrayIndex begin = 0;
+            for (ArrayIndex index = 0; index < size; ++index) {
+                const Value& element = container.get(index);
+                if (!split(element)) {
+                    weight_ += weightOf(element);
+                    continue;
                 }
-                unindent();
-                writeWithIndent("]");
+                addSpan(container, depth, begin, index, literal);
+                if (index > 0)
+                    literal.append(",", 1);
+                plan(element, depth + 1, literal);
+                begin = index + 1;
             }
-            else // output on a single line
-            {
-                assert(childValues_.size() == size);
-                document_ += "[ ";
-                for (unsigned index = 0; index < size; ++index) {
-                    if (index > 0)
-                        document_ += ", ";
-                    document_ += childValues_[index];
+            addSpan(container, depth, begin, size, literal);
+            literal.append("]", 1);
+        } else {
+            literal.append("{", 1);
+            const Value::ObjectValues& members = container.items();
+            auto first = members.begin();
+            for (auto member = members.begin(); member != members.end(); ++member) {
+                if (!split(member->second)) {
+                    weight_ += weightOf(member->second);
+                    continue;
                 }
-                document_ += " ]";
+                addSpan(container, depth, first, member, literal);
+                if (member != members.begin())
+                    literal.append(",", 1);
+                writer_.writeKey(member->first.c_str(), member->first.c_str() + member->first.length(), literal);
+                plan(member->second, depth + 1, literal);
+                first = std::next(member);
             }
+            addSpan(container, depth, first, members.end(), literal);
+            literal.append("}", 1);
         }
+        JSONCPP_STATISTICS(writer_.statistics_.leaveContainer());
     }
 
-    bool StyledWriter::isMultineArray(const Value& value) {
-        auto size = static_cast<int>(value.size());
-        bool isMultiLine = size * 3 >= rightMargin_;
-        childValues_.clear();
-        for (int index = 0; index < size && !isMultiLine; ++index) {
-            const auto& childValue = value.get(index);
-            isMultiLine = isMultiLine || ((childValue.isArray() || childValue.isObject()) && childValue.size() > 0);
-        }
-        if (!isMultiLine) // check if line length > max line length
-        {
-            childValues_.reserve(size);
-            addChildValues_ = true;
-            int lineLength = 4 + (size - 1) * 2; // '[ ' + ', '*n + ' ]'
-            for (int index = 0; index < size && !isMultiLine; ++index) {
-                writeValue(value.get(index));
-                lineLength += int(childValues_[index].length());
-                isMultiLine = isMultiLine && hasCommentForValue(value.get(index));
+    void FastWriter::ParallelWrite::addSpan(const Value& container, unsigned int depth, ArrayIndex begin, ArrayIndex end, Output& literal) {
+        if (begin != end)
+            planned_.push_back(Span{ literal.size(), &container, depth, begin, end, {}, {} });
+    }
+
+    void FastWriter::ParallelWrite::addSpan(const Value& container, unsigned int depth, Value::ObjectValues::const_iterator first,
+                                            Value::ObjectValues::const_iterator last, Output& literal) {
+        if (first != last)
+            planned_.push_back(Span{ literal.size(), &container, depth, 0, 0, first, last });
+    }
+
+    /* Cuts the planned spans into the spans of tasks of about taskWeight.
+     * Returns false if the document is too small for two tasks.
+     */
+    bool FastWriter::ParallelWrite::schedule() {
+        if (weight_ < 2 * minimumTaskWeight)
+            return false;
+        size_t taskWeight = std::clamp(weight_ / (threadCount_ * tasksPerThread), minimumTaskWeight, maximumTaskWeight);
+        size_t weight = 0;
+        for (const Span& span : planned_) {
+            if (!span.container_) {
+                spans_.push_back(span);
+                break;
+            }
+            // Only the first part of a cut span starts with its literal text.
+            Span part = span;
+            if (span.container_->type() == arrayValue) {
+                for (ArrayIndex index = span.begin_; index != span.end_; ++index) {
+                    weight += weightOf(span.container_->get(index));
+                    if (weight < taskWeight)
+                        continue;
+                    part.end_ = index + 1;
+                    addTask(part);
+                    part.begin_ = part.end_;
+                    weight = 0;
+                }
+                part.end_ = span.end_;
+                if (part.begin_ != part.end_)
+                    spans_.push_back(part);
+            } else {
+                for (auto member = span.first_; member != span.last_; ++member) {
+                    weight += weightOf(member->second);
+                    if (weight < taskWeight)
+                        continue;
+                    part.last_ = std::next(member);
+                    addTask(part);
+                    part.first_ = part.last_;
+                    weight = 0;
+                }
+                part.last_ = span.last_;
+                if (part.first_ != part.last_)
+                    spans_.push_back(part);
             }
-            addChildValues_ = false;
-            isMultiLine = isMultiLine || lineLength >= rightMargin_;
         }
-        return isMultiLine;
+        tasks_.emplace_back();
+        tasks_.back().spanEnd_ = spans_.size();
+        tasks_.back().done_ = false;
+        return true;
     }
 
-    void StyledWriter::pushValue(const std::string& value) {
-        if (addChildValues_)
-            childValues_.push_back(value);
-        else
-            document_ += value;
+    void FastWriter::ParallelWrite::addTask(const Span& span) {
+        spans_.push_back(span);
+        tasks_.emplace_back();
+        tasks_.back().spanEnd_ = spans_.size();
+        tasks_.back().done_ = false;
     }
 
-    void StyledWriter::writeIndent() {
-        if (!document_.empty()) {
-            char last = document_[document_.length() - 1];
-            if (last == ' ') // already indented
+    void FastWriter::ParallelWrite::work() {
+        FastWriter writer;
+        writer.yamlCompatiblityEnabled_ = writer_.yamlCompatiblityEnabled_;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            written_.wait(lock, [this] { return stopped_ || next_ == tasks_.size() || next_ < writtenCount_ + window_; });
+            if (stopped_ || next_ == tasks_.size())
                 return;
-            if (last != '\n') // Comments may add new-line
-                document_ += '\n';
+            size_t index = next_++;
+            lock.unlock();
+            execute(writer, index);
+            lock.lock();
         }
-        document_ += indentString_;
     }
 
-    void StyledWriter::writeWithIndent(const std::string& value) {
-        writeIndent();
-        document_ += value;
+    void FastWriter::ParallelWrite::execute(FastWriter& writer, size_t index) {
+        Task& task = tasks_[index];
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!buffers_.empty()) {
+                task.document_ = std::move(buffers_.back());
+                buffers_.pop_back();
+            }
+        }
+        std::exception_ptr exception;
+        try {
+            StringSink sink(task.document_);
+            Output out(sink);
+            serialize(writer, index, out);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task.done_ = true;
+            if (exception && !exception_) {
+                exception_ = exception;
+                stopped_ = true;
+            }
+        }
+        done_.notify_all();
+        if (exception)
+            written_.notify_all();
     }
 
-    void StyledWriter::indent() {
-        indentString_ += std::string(indentSize_, ' ');
+    void FastWriter::ParallelWrite::serialize(FastWriter& writer, size_t index, Output& out) {
+        Task& task = tasks_[index];
+        JSONCPP_STATISTICS(writer.statistics_.reset(Statistics::phaseWrite));
+        JSONCPP_STATISTICS(unsigned int maxDepth = 0);
+        for (size_t span = index > 0 ? tasks_[index - 1].spanEnd_ : 0; span != task.spanEnd_; ++span) {
+            JSONCPP_STATISTICS(writer.statistics_.maxDepth_ = 0);
+            writeSpan(writer, span, out);
+            JSONCPP_STATISTICS(maxDepth = std::max(maxDepth, spans_[span].depth_ + writer.statistics_.maxDepth_));
+        }
+        JSONCPP_STATISTICS(task.statistics_ = writer.statistics_);
+        JSONCPP_STATISTICS(task.statistics_.maxDepth_ = maxDepth);
     }
 
-    void StyledWriter::unindent() {
-        assert(int(indentString_.size()) >= indentSize_);
-        indentString_.resize(indentString_.size() - indentSize_);
+    void FastWriter::ParallelWrite::writeSpan(FastWriter& writer, size_t position, Output& out) {
+        const Span& span = spans_[position];
+        size_t literalBegin = position > 0 ? spans_[position - 1].literalEnd_ : 0;
+        out.append(text_.data() + literalBegin, span.literalEnd_ - literalBegin);
+        if (!span.container_)
+            return;
+        if (span.container_->type() == arrayValue) {
+            for (ArrayIndex index = span.begin_; index != span.end_; ++index) {
+                if (index > 0)
+                    out.append(",", 1);
+                writer.writeValue(span.container_->get(index), out);
+            }
+        } else {
+            auto begin = span.container_->items().begin();
+            for (auto member = span.first_; member != span.last_; ++member) {
+                if (member != begin)
+                    out.append(",", 1);
+                writer.writeKey(member->first.c_str(), member->first.c_str() + member->first.length(), out);
+                writer.writeValue(member->second, out);
+            }
+        }
     }
 
-    void StyledWriter::writeCommentBeforeValue(const Value& root) {
-        if (!root.hasComment(commentBefore))
-            return;
-        document_ += normalizeEOL(root.getComment(commentBefore));
-        document_ += "\n";
+    void FastWriter::ParallelWrite::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        written_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+        workers_.clear();
     }
 
-    void StyledWriter::writeCommentAfterValueOnSameLine(const Value& root) {
-        if (root.hasComment(commentAfterOnSameLine))
-            document_ += " " + normalizeEOL(root.getComment(commentAfterOnSameLine));
+    std::string FastWriter::write(const Value& root) {
+        document_.clear();
+        write(root, document_);
+        return document_;
+    }
 
-        if (root.hasComment(commentAfter)) {
-            document_ += "\n";
-            document_ += normalizeEOL(root.getComment(commentAfter));
-            document_ += "\n";
-        }
+    void FastWriter::write(const Value& root, std::string& document) {
+        StringSink sink(document);
+        write(root, sink);
     }
 
-    bool StyledWriter::hasCommentForValue(const Value& value) {
-        return value.hasComment(commentBefore) || value.hasComment(commentAfterOnSameLine) || value.hasComment(commentAfter);
+    size_t FastWriter::write(const Value& root, char* buffer, size_t capacity) {
+        ArraySink sink(buffer, capacity);
+        write(root, sink);
+        return sink.length();
     }
 
-    std::string StyledWriter::normalizeEOL(const std::string& text) {
-        std::string normalized;
-        normalized.reserve(text.length());
-        const char* begin = text.c_str();
-        const char* end = begin + text.length();
-        const char* current = begin;
-        while (current != end) {
-            char c = *current++;
-            if (c == '\r') // mac or dos EOL
-            {
-                if (*current == '\n') // convert dos EOL
-                    ++current;
-                normalized += '\n';
-            } else // handle unix EOL & other char
-                normalized += c;
+    void FastWriter::write(const Value& root, std::ostream& out) {
+        StreamSink sink(out);
+        write(root, sink);
+    }
+
+    void FastWriter::write(const Value& root, OutputSink& sink) {
+        JSONCPP_STATISTICS(StatisticsScope statistics(statistics_, Statistics::phaseWrite));
+        Output out(sink);
+        if (threadCount_ <= 1 || !ParallelWrite(*this, threadCount_).write(root, out))
+            writeValue(root, out);
+        out.append("\n", 1);
+        JSONCPP_STATISTICS(statistics_.bytes_ = out.size());
+    }
+
+    void FastWriter::writeValue(const Value& value, Output& out) {
+        JSONCPP_STATISTICS(++statistics_.nodes_);
+        switch (value.type()) {
+        case nullValue:
+            out.append("null", 4);
+            break;
+        case intValue: {
+            UIntToStringBuffer buffer;
+            char* end = buffer + sizeof(buffer) - 1; // uintToString() zero-terminates
+            char* current = end + 1;
+            LargestInt integer = value.asLargestInt();
+            uintToString(integer < 0 ? 0 - LargestUInt(integer) : LargestUInt(integer), current);
+            if (integer < 0)
+                out.append("-", 1);
+            out.append(current, end - current);
+        } break;
+        case uintValue: {
+            UIntToStringBuffer buffer;
+            char* end = buffer + sizeof(buffer) - 1;
+            char* current = end + 1;
+            uintToString(value.asLargestUInt(), current);
+            out.append(current, end - current);
+        } break;
+        case realValue: {
+            DoubleToStringBuffer buffer;
+            out.append(buffer, doubleToString(value.asDouble(), buffer) - buffer);
+        } break;
+        case stringValue: {
+            const char* begin;
+            const char* end;
+            value.getString(&begin, &end);
+            JSONCPP_STATISTICS(statistics_.stringBytes_ += size_t(end - begin));
+            writeQuotedString(out, begin, end);
+        } break;
+        case booleanValue:
+            if (value.asBool())
+                out.append("true", 4);
+            else
+                out.append("false", 5);
+            break;
+        case arrayValue: {
+            JSONCPP_STATISTICS(statistics_.enterContainer());
+            out.append("[", 1);
+            auto size = value.size();
+            for (ArrayIndex index = 0; index < size; ++index) {
+                if (index > 0)
+                    out.append(",", 1);
+                writeValue(value.get(index), out);
+            }
+            out.append("]", 1);
+            JSONCPP_STATISTICS(statistics_.leaveContainer());
+        } break;
+        case objectValue: {
+            JSONCPP_STATISTICS(statistics_.enterContainer());
+            out.append("{", 1);
+            bool begin = false;
+            for (const auto& [name, member] : value.items()) {
+                if (std::exchange(begin, true))
+                    out.append(",", 1);
+                writeKey(name.c_str(), name.c_str() + name.length(), out);
+                writeValue(member, out);
+            }
+            out.append("}", 1);
+            JSONCPP_STATISTICS(statistics_.leaveContainer());
+        } break;
         }
-        return normalized;
     }
 
-    // Class StyledStreamWriter
+    void FastWriter::writeKey(const char* begin, const char* end, Output& out) {
+        JSONCPP_STATISTICS(statistics_.stringBytes_ += size_t(end - begin));
+        writeQuotedString(out, begin, end);
+        if (yamlCompatiblityEnabled_)
+            out.append(": ", 2);
+        else
+            out.append(":", 1);
+    }
+
+    // Class BinaryWriter
     // //////////////////////////////////////////////////////////////////
 
-    StyledStreamWriter::StyledStreamWriter(std::string indentation) :
-        childValues_{}, document_{ nullptr }, indentString_{}, rightMargin_{ 74 }, indentation_{ indentation }, addChildValues_{ false } {}
+    BinaryWriter::BinaryWriter() : document_{} {}
 
-    void StyledStreamWriter::write(std::ostream& out, const Value& root) {
-        document_ = &out;
-        addChildValues_ = false;
-        indentString_ = "";
-        writeCommentBeforeValue(root);
-        writeValue(root);
-        writeCommentAfterValueOnSameLine(root);
-        *document_ << "\n";
-        document_ = nullptr; // Forget the stream, for safety.
+    class BinaryWriter::Output : public ChunkedOutput {
+    public:
+        using ChunkedOutput::ChunkedOutput;
+
+        // Initial byte followed by the argument in the fewest big-endian bytes.
+        void appendHead(CborMajorType major, UInt64 argument) {
+            unsigned char head[9];
+            head[0] = static_cast<unsigned char>(major << 5);
+            size_t length;
+            if (argument < 24) {
+                head[0] |= static_cast<unsigned char>(argument);
+                length = 0;
+            } else if (argument <= 0xff) {
+                head[0] |= 24;
+                length = 1;
+            } else if (argument <= 0xffff) {
+                head[0] |= 25;
+                length = 2;
+            } else if (argument <= 0xffffffff) {
+                head[0] |= 26;
+                length = 4;
+            } else {
+                head[0] |= 27;
+                length = 8;
+            }
+            for (size_t index = length; index > 0; --index, argument >>= 8)
+                head[index] = static_cast<unsigned char>(argument);
+            append(reinterpret_cast<const char*>(head), length + 1);
+        }
+    };
+
+    std::string BinaryWriter::write(const Value& root) {
+        document_.clear();
+        write(root, document_);
+        return document_;
+    }
+
+    void BinaryWriter::write(const Value& root, std::string& document) {
+        StringSink sink(document);
+        write(root, sink);
+    }
+
+    void BinaryWriter::write(const Value& root, OutputSink& sink) {
+        JSONCPP_STATISTICS(StatisticsScope statistics(statistics_, Statistics::phaseWrite));
+        Output out(sink);
+        writeValue(root, out);
+        JSONCPP_STATISTICS(statistics_.bytes_ = out.size());
     }
 
-    void StyledStreamWriter::writeValue(const Value& value) {
+    void BinaryWriter::writeValue(const Value& value, Output& out) {
+        JSONCPP_STATISTICS(++statistics_.nodes_);
         switch (value.type()) {
         case nullValue:
-            pushValue("null");
-            break;
-        case intValue:
-            pushValue(valueToString(value.asLargestInt()));
+            out.append("\xf6", 1);
             break;
+        case intValue: {
+            LargestInt integer = value.asLargestInt();
+            if (integer < 0)
+                out.appendHead(cborNegative, UInt64(-1 - integer));
+            else
+                out.appendHead(cborUnsigned, UInt64(integer));
+        } break;
         case uintValue:
-            pushValue(valueToString(value.asLargestUInt()));
+            out.appendHead(cborUnsigned, UInt64(value.asLargestUInt()));
             break;
-        case realValue:
-            pushValue(valueToString(value.asDouble()));
+        case realValue: {
+            double real = value.asDouble();
+            float single = static_cast<float>(real);
+            char bytes[9];
+            size_t length;
+            UInt64 bits;
+            if (double(single) == real) {
+                bytes[0] = '\xfa';
+                length = 4;
+                bits = std::bit_cast<uint32_t>(single);
+            } else {
+                bytes[0] = '\xfb';
+                length = 8;
+                bits = std::bit_cast<UInt64>(real);
+            }
+            for (size_t index = length; index > 0; --index, bits >>= 8)
+                bytes[index] = static_cast<char>(bits);
+            out.append(bytes, length + 1);
+        } break;
+        case stringValue: {
+            const char* begin;
+            const char* end;
+            value.getString(&begin, &end);
+            JSONCPP_STATISTICS(statistics_.stringBytes_ += size_t(end - begin));
+            out.appendHead(cborTextString, UInt64(end - begin));
+            out.append(begin, end - begin);
+        } break;
+        case booleanValue:
+            out.append(value.asBool() ? "\xf5" : "\xf4", 1);
             break;
-        case stringValue:
-            pushValue(valueToQuotedString(value.asCString()));
+        case arrayValue: {
+            JSONCPP_STATISTICS(statistics_.enterContainer());
+            auto size = value.size();
+            out.appendHead(cborArray, size);
+            for (ArrayIndex index = 0; index < size; ++index)
+                writeValue(value.get(index), out);
+            JSONCPP_STATISTICS(statistics_.leaveContainer());
+        } break;
+        case objectValue: {
+            JSONCPP_STATISTICS(statistics_.enterContainer());
+            out.appendHead(cborMap, value.size());
+            for (const auto& [name, member] : value.items()) {
+                JSONCPP_STATISTICS(statistics_.stringBytes_ += name.length());
+                out.appendHead(cborTextString, name.length());
+                out.append(name.c_str(), name.length());
+                writeValue(member, out);
+            }
+            JSONCPP_STATISTICS(statistics_.leaveContainer());
+        } break;
+        }
+    }
+
+    // Class StyledLayout
+    // //////////////////////////////////////////////////////////////////
+
+    /* Layout engine of StyledWriter and StyledStreamWriter.
+     *
+     * Every value is rendered once, straight into the output. Whether an array fits on
+     * a single line is decided beforehand by measuring its elements, so no element is
+     * rendered into a temporary string. Output must provide append(const char* data,
+     * size_t length), and startLine(), which begins a new line and returns false if the
+     * line was already indented.
+     */
+    template <typename Output>
+    class StyledLayout {
+    public:
+        StyledLayout(Output& out, std::string_view indentation, int rightMargin, Statistics& statistics) :
+            out_{ out }, indentation_{ indentation }, rightMargin_{ size_t(rightMargin) }, depth_{ 0 }, statistics_{ statistics } {}
+
+        void write(const Value& root) {
+            writeCommentBeforeValue(root);
+            writeValue(root);
+            writeCommentAfterValueOnSameLine(root);
+            out_.append("\n", 1);
+        }
+
+    private:
+        void writeValue(const Value& value);
+        void writeArrayValue(const Value& value);
+        bool isMultilineArray(const Value& value) const;
+        void writeIndent();
+        void writeQuotedText(const char* begin, const char* end);
+        void writeNormalizedComment(const std::string& text);
+        void writeCommentBeforeValue(const Value& root);
+        void writeCommentAfterValueOnSameLine(const Value& root);
+
+        void append(std::string_view text) { out_.append(text.data(), text.size()); }
+
+        Output& out_;
+        std::string_view indentation_;
+        size_t rightMargin_;
+        unsigned int depth_;
+        [[maybe_unused]] Statistics& statistics_;
+    };
+
+    /* Length of value written on a single line by StyledLayout. Lengths of strings are
+     * only computed until they reach limit.
+     */
+    static size_t styledLength(const Value& value, size_t limit) {
+        switch (value.type()) {
+        case nullValue:
+            return 4;
+        case intValue: {
+            UIntToStringBuffer buffer;
+            char* current = buffer + sizeof(buffer);
+            LargestInt integer = value.asLargestInt();
+            uintToString(integer < 0 ? 0 - LargestUInt(integer) : LargestUInt(integer), current);
+            return size_t(buffer + sizeof(buffer) - 1 - current) + (integer < 0 ? 1 : 0);
+        }
+        case uintValue: {
+            UIntToStringBuffer buffer;
+            char* current = buffer + sizeof(buffer);
+            uintToString(value.asLargestUInt(), current);
+            return size_t(buffer + sizeof(buffer) - 1 - current);
+        }
+        case realValue: {
+            DoubleToStringBuffer buffer;
+            return size_t(doubleToString(value.asDouble(), buffer) - buffer);
+        }
+        case stringValue: {
+            const char* begin;
+            const char* end;
+            value.getString(&begin, &end);
+            // The escaped string is at least as long as the raw one, so [begin, begin + limit) is enough to reach limit.
+            if (size_t(end - begin) > limit)
+                end = begin + limit;
+            size_t length = 2;
+            for (;;) {
+                const char* special = findCharacterToEscape(begin, end);
+                length += size_t(special - begin);
+                if (special == end || length >= limit)
+                    return length;
+                length += escapeTable[static_cast<unsigned char>(*special)] == 'u' ? 6 : 2;
+                begin = special + 1;
+            }
+        }
+        case booleanValue:
+            return value.asBool() ? 4 : 5;
+        case arrayValue:
+        case objectValue:
+            return 2; // only empty ones are written on the line of their container
+        }
+        return 0;
+    }
+
+    template <typename Output>
+    void StyledLayout<Output>::writeValue(const Value& value) {
+        JSONCPP_STATISTICS(++statistics_.nodes_);
+        switch (value.type()) {
+        case nullValue:
+            append("null");
             break;
+        case intValue: {
+            UIntToStringBuffer buffer;
+            char* end = buffer + sizeof(buffer) - 1; // uintToString() zero-terminates
+            char* current = end + 1;
+            LargestInt integer = value.asLargestInt();
+            uintToString(integer < 0 ? 0 - LargestUInt(integer) : LargestUInt(integer), current);
+            if (integer < 0)
+                append("-");
+            out_.append(current, end - current);
+        } break;
+        case uintValue: {
+            UIntToStringBuffer buffer;
+            char* end = buffer + sizeof(buffer) - 1;
+            char* current = end + 1;
+            uintToString(value.asLargestUInt(), current);
+            out_.append(current, end - current);
+        } break;
+        case realValue: {
+            DoubleToStringBuffer buffer;
+            out_.append(buffer, doubleToString(value.asDouble(), buffer) - buffer);
+        } break;
+        case stringValue: {
+            const char* begin;
+            const char* end;
+            value.getString(&begin, &end);
+            JSONCPP_STATISTICS(statistics_.stringBytes_ += size_t(end - begin));
+            writeQuotedText(begin, end);
+        } break;
         case booleanValue:
-            pushValue(valueToString(value.asBool()));
+            append(value.asBool() ? "true" : "false");
             break;
         case arrayValue:
+            JSONCPP_STATISTICS(statistics_.enterContainer());
             writeArrayValue(value);
+            JSONCPP_STATISTICS(statistics_.leaveContainer());
             break;
         case objectValue: {
+            JSONCPP_STATISTICS(statistics_.enterContainer());
             auto& items = value.items();
             if (items.empty())
-                pushValue("{}");
+                append("{}");
             else {
-                writeWithIndent("{");
-                indent();
+                writeIndent();
+                append("{");
+                ++depth_;
                 auto it = items.begin();
                 for (;;) {
                     const auto& [name, childValue] = *it;
                     writeCommentBeforeValue(childValue);
-                    writeWithIndent(valueToQuotedString(name.c_str()));
-                    *document_ << " : ";
+                    JSONCPP_STATISTICS(statistics_.stringBytes_ += name.length());
+                    writeIndent();
+                    writeQuotedText(name.c_str(), name.c_str() + name.length());
+                    append(" : ");
                     writeValue(childValue);
                     if (++it == items.end()) {
                         writeCommentAfterValueOnSameLine(childValue);
                         break;
                     }
-                    *document_ << ",";
+                    append(",");
                     writeCommentAfterValueOnSameLine(childValue);
                 }
-                unindent();
-                writeWithIndent("}");
+                --depth_;
+                writeIndent();
+                append("}");
             }
+            JSONCPP_STATISTICS(statistics_.leaveContainer());
         } break;
         }
     }
 
-    void StyledStreamWriter::writeArrayValue(const Value& value) {
+    template <typename Output>
+    void StyledLayout<Output>::writeArrayValue(const Value& value) {
         auto size = value.size();
         if (size == 0)
-            pushValue("[]");
-        else {
-            bool isArrayMultiLine = isMultineArray(value);
-            if (isArrayMultiLine) {
-                writeWithIndent("[");
-                indent();
-                bool hasChildValue = !childValues_.empty();
-                ArrayIndex index = 0;
-                for (;;) {
-                    const auto& childValue = value.get(index);
-                    writeCommentBeforeValue(childValue);
-                    if (hasChildValue)
-                        writeWithIndent(childValues_[index]);
-                    else {
-                        writeIndent();
-                        writeValue(childValue);
-                    }
-                    if (++index == size) {
-                        writeCommentAfterValueOnSameLine(childValue);
-                        break;
-                    }
-                    *document_ << ",";
+            append("[]");
+        else if (isMultilineArray(value)) {
+            writeIndent();
+            append("[");
+            ++depth_;
+            ArrayIndex index = 0;
+            for (;;) {
+                const auto& childValue = value.get(index);
+                writeCommentBeforeValue(childValue);
+                writeIndent();
+                writeValue(childValue);
+                if (++index == size) {
                     writeCommentAfterValueOnSameLine(childValue);
+                    break;
                 }
-                unindent();
-                writeWithIndent("]");
-            } else // output on a single line
-            {
-                assert(childValues_.size() == size);
-                *document_ << "[ ";
-                for (ArrayIndex index = 0; index < size; ++index) {
-                    if (index > 0)
-                        *document_ << ", ";
-                    *document_ << childValues_[index];
-                }
-                *document_ << " ]";
+                append(",");
+                writeCommentAfterValueOnSameLine(childValue);
             }
-        }
-    }
-
-    bool StyledStreamWriter::isMultineArray(const Value& value) {
-        auto size = static_cast<int>(value.size());
-        bool isMultiLine = size * 3 >= rightMargin_;
-        childValues_.clear();
-        for (int index = 0; index < size && !isMultiLine; ++index) {
-            const auto& childValue = value.get(index);
-            isMultiLine = isMultiLine || ((childValue.isArray() || childValue.isObject()) && childValue.size() > 0);
-        }
-        if (!isMultiLine) // check if line length > max line length
+            --depth_;
+            writeIndent();
+            append("]");
+        } else // output on a single line, without the comments of the elements
         {
-            childValues_.reserve(size);
-            addChildValues_ = true;
-            int lineLength = 4 + (size - 1) * 2; // '[ ' + ', '*n + ' ]'
-            for (int index = 0; index < size && !isMultiLine; ++index) {
+            append("[ ");
+            for (ArrayIndex index = 0; index < size; ++index) {
+                if (index > 0)
+                    append(", ");
                 writeValue(value.get(index));
-                lineLength += int(childValues_[index].length());
-                isMultiLine = isMultiLine && hasCommentForValue(value.get(index));
             }
-            addChildValues_ = false;
-            isMultiLine = isMultiLine || lineLength >= rightMargin_;
+            append(" ]");
         }
-        return isMultiLine;
     }
 
-    void StyledStreamWriter::pushValue(const std::string& value) {
-        if (addChildValues_)
-            childValues_.push_back(value);
-        else
-            *document_ << value;
-    }
-
-    void StyledStreamWriter::writeIndent() {
-        /*
-          Some comments in this method would have been nice. ;-)
-
-         if ( !document_.empty() )
-         {
-            char last = document_[document_.length()-1];
-            if ( last == ' ' )     // already indented
-               return;
-            if ( last != '\n' )    // Comments may add new-line
-               *document_ << '\n';
-         }
-        */
-        *document_ << '\n' << indentString_;
+    template <typename Output>
+    bool StyledLayout<Output>::isMultilineArray(const Value& value) const {
+        size_t size = value.size();
+        if (size * 3 >= rightMargin_)
+            return true;
+        for (ArrayIndex index = 0; index < size; ++index) {
+            const auto& childValue = value.get(index);
+            if ((childValue.isArray() || childValue.isObject()) && childValue.size() > 0)
+                return true;
+        }
+        size_t lineLength = 4 + (size - 1) * 2; // '[ ' + ', '*n + ' ]'
+        for (ArrayIndex index = 0; index < size; ++index) {
+            lineLength += styledLength(value.get(index), rightMargin_ - lineLength);
+            if (lineLength >= rightMargin_)
+                return true;
+        }
+        return false;
     }
 
-    void StyledStreamWriter::writeWithIndent(const std::string& value) {
-        writeIndent();
-        *document_ << value;
+    template <typename Output>
+    void StyledLayout<Output>::writeIndent() {
+        if (!out_.startLine())
+            return;
+        for (unsigned int level = 0; level < depth_; ++level)
+            append(indentation_);
     }
 
-    void StyledStreamWriter::indent() {
-        indentString_ += indentation_;
+    template <typename Output>
+    void StyledLayout<Output>::writeQuotedText(const char* begin, const char* end) {
+        writeQuotedString(out_, begin, end);
     }
 
-    void StyledStreamWriter::unindent() {
-        assert(indentString_.size() >= indentation_.size());
-        indentString_.resize(indentString_.size() - indentation_.size());
+    template <typename Output>
+    void StyledLayout<Output>::writeNormalizedComment(const std::string& text) {
+        const char* current = text.c_str();
+        const char* end = current + text.length();
+        while (current != end) {
+            const char* eol = std::find(current, end, '\r');
+            out_.append(current, eol - current);
+            if (eol == end)
+                break;
+            append("\n"); // mac or dos EOL
+            current = eol + 1;
+            if (current != end && *current == '\n') // convert dos EOL
+                ++current;
+        }
     }
 
-    void StyledStreamWriter::writeCommentBeforeValue(const Value& root) {
+    template <typename Output>
+    void StyledLayout<Output>::writeCommentBeforeValue(const Value& root) {
         if (!root.hasComment(commentBefore))
             return;
-        *document_ << normalizeEOL(root.getComment(commentBefore));
-        *document_ << "\n";
+        writeNormalizedComment(root.getComment(commentBefore));
+        append("\n");
     }
 
-    void StyledStreamWriter::writeCommentAfterValueOnSameLine(const Value& root) {
-        if (root.hasComment(commentAfterOnSameLine))
-            *document_ << " " + normalizeEOL(root.getComment(commentAfterOnSameLine));
+    template <typename Output>
+    void StyledLayout<Output>::writeCommentAfterValueOnSameLine(const Value& root) {
+        if (root.hasComment(commentAfterOnSameLine)) {
+            append(" ");
+            writeNormalizedComment(root.getComment(commentAfterOnSameLine));
+        }
 
         if (root.hasComment(commentAfter)) {
-            *document_ << "\n";
-            *document_ << normalizeEOL(root.getComment(commentAfter));
-            *document_ << "\n";
+            append("\n");
+            writeNormalizedComment(root.getComment(commentAfter));
+            append("\n");
         }
     }
 
-    bool StyledStreamWriter::hasCommentForValue(const Value& value) {
-        return value.hasComment(commentBefore) || value.hasComment(commentAfterOnSameLine) || value.hasComment(commentAfter);
+    // Class StyledWriter
+    // //////////////////////////////////////////////////////////////////
+
+    StyledWriter::StyledWriter() : document_{}, rightMargin_{ 74 }, indentSize_{ 3 } {}
+
+    // Appends to the document; a line that ends with a space is already indented.
+    class StyledWriter::Output {
+    public:
+        explicit Output(std::string& document) : document_{ document } {}
+
+        void append(const char* data, size_t length) {
+            document_.append(data, length);
+        }
+
+        bool startLine() {
+            if (!document_.empty()) {
+                char last = document_.back();
+                if (last == ' ') // already indented
+                    return false;
+                if (last != '\n') // Comments may add new-line
+                    document_ += '\n';
+            }
+            return true;
+        }
+
+    private:
+        std::string& document_;
+    };
+
+    std::string StyledWriter::write(const Value& root) {
+        JSONCPP_STATISTICS(StatisticsScope statistics(statistics_, Statistics::phaseWrite));
+        document_.clear();
+        Output out(document_);
+        std::string indentation(indentSize_, ' ');
+        StyledLayout<Output>(out, indentation, rightMargin_, statistics_).write(root);
+        JSONCPP_STATISTICS(statistics_.bytes_ = document_.size());
+        return document_;
     }
 
-    std::string StyledStreamWriter::normalizeEOL(const std::string& text) {
-        std::string normalized;
-        normalized.reserve(text.length());
-        const char* begin = text.c_str();
-        const char* end = begin + text.length();
-        const char* current = begin;
-        while (current != end) {
-            char c = *current++;
-            if (c == '\r') // mac or dos EOL
-            {
-                if (*current == '\n') // convert dos EOL
-                    ++current;
-                normalized += '\n';
-            } else // handle unix EOL & other char
-                normalized += c;
-        }
-        return normalized;
+    // Class StyledStreamWriter
+    // //////////////////////////////////////////////////////////////////
+
+    StyledStreamWriter::StyledStreamWriter(std::string indentation) : rightMargin_{ 74 }, indentation_{ indentation }, statistics_{} {}
+
+    // Buffers the output to the stream; every line break is written.
+    class StyledStreamWriter::Output : public ChunkedOutput {
+    public:
+        using ChunkedOutput::ChunkedOutput;
+
+        bool startLine() {
+            append("\n", 1);
+            return true;
+        }
+    };
+
+    void StyledStreamWriter::write(std::ostream& out, const Value& root) {
+        JSONCPP_STATISTICS(StatisticsScope statistics(statistics_, Statistics::phaseWrite));
+        StreamSink sink(out);
+        Output output(sink);
+        StyledLayout<Output>(output, indentation_, rightMargin_, statistics_).write(root);
+        output.flush();
+        JSONCPP_STATISTICS(statistics_.bytes_ = output.size());
     }
 
     std::ostream& operator<<(std::ostream& sout, const Value& root) {
@@ -5,6 +5,22 @@
 
 #include <json/json.h>
 #include "jsontest.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <clocale>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
 
 
 // TODO:
@@ -186,8 +202,43 @@ JSONTEST_FIXTURE( ValueTest, accessArray )
 	JSONTEST_ASSERT( Json::Value(1234) == array1_[0] ) << "Json::Value::operator[int]";
 
 	const Json::Value &constArray = array1_;
-	JSONTEST_ASSERT( Json::Value(1234) == constArray[index0] ) << "Json::Value::operator[ArrayIndex] const";
-	JSONTEST_ASSERT( Json::Value(1234) == constArray[0] ) << "Json::Value::operator[int] const";
+	JSONTEST_ASSERT( Json::Value(1234) == constArray.get(index0) ) << "Json::Value::get(ArrayIndex) const";
+	JSONTEST_ASSERT( Json::Value(1234) == constArray.get(0) ) << "Json::Value::get(int) const";
+}
+
+
+JSONTEST_FIXTURE( ValueTest, accessOtherContainer )
+{
+   // Built without JSONCPP_ENABLE_ASSERTS: the accessors of one kind of
+   // container find nothing in the other kind and leave it unchanged.
+   Json::Value array( Json::arrayValue );
+   array.append( "element" );
+   Json::Value object( Json::objectValue );
+   object["member"] = 1;
+   const Json::Value &constArray = array;
+   const Json::Value &constObject = object;
+   const auto member = constObject.items().begin()->first;
+
+   JSONTEST_ASSERT( constObject.tryGet( 0u ) == nullptr );
+   JSONTEST_ASSERT( object.tryGet( 0u ) == nullptr );
+   JSONTEST_ASSERT( constArray.tryGet( std::string_view( "member" ) ) == nullptr );
+   JSONTEST_ASSERT( array.tryGet( std::string_view( "member" ) ) == nullptr );
+   JSONTEST_ASSERT( constArray.tryGet( member ) == nullptr );
+   JSONTEST_ASSERT( array.tryGet( member ) == nullptr );
+   JSONTEST_ASSERT( !array.isMember( "member" ) );
+   JSONTEST_ASSERT( !array.removeMember( "member", nullptr ) );
+
+   JSONTEST_ASSERT( object[0u].isNull() );
+   object[1u] = "dropped";
+   JSONTEST_ASSERT( array["member"].isNull() );
+   array["member"] = "dropped";
+   array[member] = "dropped";
+   array[Json::StaticString( "member" )] = "dropped";
+   object.append( "dropped" );
+   Json::Value( 1 )[0u] = "dropped";
+   Json::Value( "string" )["member"] = "dropped";
+   JSONTEST_ASSERT_EQUAL( std::string( "[\"element\"]\n" ), Json::FastWriter().write( array ) );
+   JSONTEST_ASSERT_EQUAL( std::string( "{\"member\":1}\n" ), Json::FastWriter().write( object ) );
 }
 
 
@@ -402,6 +453,2907 @@ ValueTest::checkIsEqual( const Json::Value &x, const Json::Value &y )
 }
 
 
+JSONTEST_FIXTURE( ValueTest, stringsAroundInlineLength )
+{
+   // Strings of up to 11 bytes are stored in the Value; test up to twice that length.
+   Json::Value object;
+   for ( size_t length = 0; length <= 24; ++length )
+   {
+      std::string string;
+      for ( size_t index = 0; index < length; ++index )
+         string += char( 'a' + index % 26 );
+      if ( length > 0 )
+         string[0] = string[length / 2] = string[length - 1] = '\0';
+
+      Json::Value value( string );
+      const char *begin;
+      const char *end;
+      JSONTEST_ASSERT( value.getString( &begin, &end ) );
+      JSONTEST_ASSERT( std::string( begin, end ) == string ) << "length " << int(length);
+      JSONTEST_ASSERT( value.asString() == string ) << "length " << int(length);
+
+      Json::Value copy( value );
+      JSONTEST_ASSERT( copy == value && copy.asString() == string ) << "length " << int(length);
+      Json::Value assigned( "a string longer than the inline buffer" );
+      assigned = value;
+      JSONTEST_ASSERT( assigned == value ) << "length " << int(length);
+      Json::Value moved( std::move( copy ) );
+      JSONTEST_ASSERT( moved.asString() == string ) << "length " << int(length);
+      assigned = Json::Value( "short" );
+      JSONTEST_ASSERT( assigned.asString() == "short" ) << "length " << int(length);
+
+      // Characters after a '\0' are compared too.
+      if ( length > 0 )
+      {
+         JSONTEST_ASSERT( Json::Value( string.substr( 0, length - 1 ) ) < value ) << "length " << int(length);
+         std::string greater = string;
+         greater[length - 1] = '\1';
+         JSONTEST_ASSERT( value < Json::Value( greater ) ) << "length " << int(length);
+         JSONTEST_ASSERT( value != Json::Value( greater ) ) << "length " << int(length);
+      }
+
+      object[string] = int(length);
+      JSONTEST_ASSERT( object.isMember( string ) ) << "length " << int(length);
+      JSONTEST_ASSERT_EQUAL( int(length), object[string].asInt() );
+      JSONTEST_ASSERT( length == 0 || !object.isMember( string.substr( 0, length - 1 ) + '\1' ) )
+         << "length " << int(length);
+   }
+   JSONTEST_ASSERT_EQUAL( 25, int(object.size()) );
+   for ( Json::Value::iterator it = object.begin(); it != object.end(); ++it )
+      JSONTEST_ASSERT( it.key().asString().size() == size_t( (*it).asInt() ) );
+
+   Json::Value read;
+   JSONTEST_ASSERT( Json::Reader().parse( Json::FastWriter().write( object ), read ) );
+   JSONTEST_ASSERT( read == object );
+
+   JSONTEST_ASSERT_EQUAL( std::string( "hello world" ), std::string( Json::Value( "hello world" ).asCString() ) );
+   JSONTEST_ASSERT_EQUAL( std::string( "hello world!" ), std::string( Json::Value( "hello world!" ).asCString() ) );
+   JSONTEST_ASSERT( Json::Value( Json::stringValue ).asString().empty() );
+   JSONTEST_ASSERT( Json::Value( Json::stringValue ) == Json::Value( "" ) );
+}
+
+
+JSONTEST_FIXTURE( ValueTest, moveIntoContainers )
+{
+   // Moved values keep their storage: the characters of long strings and the
+   // elements of containers are not copied.
+   const auto characters = []( const Json::Value &value ) {
+      const char *begin;
+      const char *end;
+      value.getString( &begin, &end );
+      return begin;
+   };
+   Json::Value string( "a string longer than the inline buffer" );
+   const char *stringCharacters = characters( string );
+   Json::Value inner( Json::arrayValue );
+   inner.append( "element" );
+   const Json::Value *innerElement = &std::as_const( inner ).get( 0u );
+
+   Json::Value array;
+   Json::Value &appended = array.append( std::move( string ) );
+   JSONTEST_ASSERT( string.isNull() );
+   JSONTEST_ASSERT( characters( appended ) == stringCharacters );
+   array.append( std::move( inner ) );
+   JSONTEST_ASSERT( inner.isNull() );
+   JSONTEST_ASSERT( &std::as_const( array ).get( 1u ).get( 0u ) == innerElement );
+
+   // Elements are built in place from the arguments of emplace_back().
+   Json::Value &emplaced = array.emplace_back( std::string_view( "emplaced" ) );
+   JSONTEST_ASSERT( &emplaced == &std::as_const( array ).get( 2u ) );
+   array.emplace_back( Json::objectValue )["key"] = 1;
+   array.emplace_back( 2.5 );
+   array.emplace_back();
+   JSONTEST_ASSERT_EQUAL( std::string( "[\"a string longer than the inline buffer\",[\"element\"],\"emplaced\",{\"key\":1},2.5,null]\n" ),
+                          Json::FastWriter().write( array ) );
+
+   // Appending an lvalue still copies it.
+   Json::Value copy;
+   copy.append( array )[0u] = "changed";
+   JSONTEST_ASSERT( array[0u].asString() == "a string longer than the inline buffer" );
+   JSONTEST_ASSERT( array.size() == 6 );
+
+   // Members are moved in and out the same way.
+   Json::Value object;
+   Json::Value member( "another string longer than the inline buffer" );
+   const char *memberCharacters = characters( member );
+   Json::Value &inserted = object.insert( "long", std::move( member ) );
+   JSONTEST_ASSERT( member.isNull() );
+   JSONTEST_ASSERT( characters( inserted ) == memberCharacters );
+   JSONTEST_ASSERT( &object.insert( "long", Json::Value( 1 ) ) == &inserted );
+   JSONTEST_ASSERT_EQUAL( 1, inserted.asInt() );
+   object.insert( "long", Json::Value( "yet another string longer than the inline buffer" ) );
+   memberCharacters = characters( std::as_const( object ).get( "long" ) );
+   const Json::Value kept( 3 );
+   object.insert( "kept", kept );
+   JSONTEST_ASSERT_EQUAL( 3, kept.asInt() );
+
+   Json::Value removed;
+   JSONTEST_ASSERT( object.removeMember( "long", &removed ) );
+   JSONTEST_ASSERT( characters( removed ) == memberCharacters );
+   JSONTEST_ASSERT( !object.isMember( "long" ) );
+   JSONTEST_ASSERT( !object.removeMember( "long", &removed ) );
+   JSONTEST_ASSERT( removed.isString() );
+   JSONTEST_ASSERT( object.removeMember( "kept", nullptr ) );
+   JSONTEST_ASSERT( object.empty() && object.isObject() );
+   JSONTEST_ASSERT( object.removeMember( "missing" ).isNull() );
+
+   object["list"] = array;
+   const Json::Value *listElement = &std::as_const( object ).get( "list" ).get( 0u );
+   Json::Value list = object.removeMember( "list" );
+   JSONTEST_ASSERT( &std::as_const( list ).get( 0u ) == listElement );
+   JSONTEST_ASSERT( list == array );
+
+   Json::Value reserved( Json::objectValue );
+   reserved.reserve( 10 );
+   JSONTEST_ASSERT( reserved.isObject() && reserved.empty() );
+   Json::Value reservedArray;
+   reservedArray.reserve( 10 );
+   JSONTEST_ASSERT( reservedArray.isArray() && reservedArray.empty() );
+}
+
+
+JSONTEST_FIXTURE( ValueTest, largeObjects )
+{
+   // Large objects are indexed by the hash of their member names: lookups,
+   // insertions and removals must still agree with the sorted members.
+   const auto name = []( int index ) { return "member " + std::to_string( index ); };
+   const std::string zero( "with\0zero", 9 );
+   Json::Value object;
+   for ( int index = 0; index < 200; ++index )
+      object[name( index )] = index;
+   object[zero] = -1;
+   const Json::Value &constObject = object;
+   for ( int index = 0; index < 200; ++index )
+      JSONTEST_ASSERT_EQUAL( index, constObject.get( name( index ) ).asInt() );
+   JSONTEST_ASSERT_EQUAL( -1, constObject.get( zero ).asInt() );
+   JSONTEST_ASSERT( !object.isMember( "with" ) );
+   JSONTEST_ASSERT( !object.isMember( "member 200" ) );
+   JSONTEST_ASSERT( !object.isMember( "member" ) );
+   JSONTEST_ASSERT_EQUAL( std::string( "member 0" ), std::string( object.begin().memberName() ) );
+
+   // Members found after a removed one must still be found.
+   for ( int index = 0; index < 200; index += 3 )
+      JSONTEST_ASSERT( object.removeMember( name( index ), nullptr ) );
+   for ( int index = 0; index < 200; ++index )
+   {
+      const Json::Value *member = constObject.tryGet( name( index ) );
+      JSONTEST_ASSERT( ( member != nullptr ) == ( index % 3 != 0 ) ) << name( index );
+      JSONTEST_ASSERT( !member || member->asInt() == index ) << name( index );
+   }
+   object[name( 0 )] = 0;
+   JSONTEST_ASSERT_EQUAL( 135u, object.size() );
+
+   // A copy is indexed when it is modified.
+   Json::Value copy = object;
+   copy[name( 3 )] = 3;
+   copy.removeMember( name( 1 ), nullptr );
+   JSONTEST_ASSERT( copy.isMember( name( 3 ) ) && !object.isMember( name( 3 ) ) );
+   JSONTEST_ASSERT( !copy.isMember( name( 1 ) ) && object.isMember( name( 1 ) ) );
+   JSONTEST_ASSERT( &copy[name( 2 )] == copy.tryGet( name( 2 ) ) );
+
+   Json::KeyTable keys;
+   for ( int index = 0; index < 200; ++index )
+      keys.resolve( object, name( index ) ) = 2 * index;
+   JSONTEST_ASSERT_EQUAL( 201u, object.size() );
+   JSONTEST_ASSERT( &keys.resolve( object, name( 3 ) ) == &object[name( 3 )] );
+   JSONTEST_ASSERT_EQUAL( 6, constObject.get( name( 3 ) ).asInt() );
+
+   object.clear();
+   JSONTEST_ASSERT( !object.isMember( name( 1 ) ) );
+   object["a"] = 1;
+   JSONTEST_ASSERT( object.isMember( "a" ) && object.size() == 1 );
+
+   // The members of parsed and arena objects are indexed the same way.
+   std::string text = "{";
+   for ( int index = 0; index < 100; ++index )
+      text += "\"" + name( index ) + "\":" + std::to_string( index ) + ",";
+   text.back() = '}';
+   Json::Value parsed;
+   JSONTEST_ASSERT( Json::Reader().parse( text, parsed ) );
+   JSONTEST_ASSERT_EQUAL( 42, std::as_const( parsed ).get( name( 42 ) ).asInt() );
+   Json::Document doc;
+   JSONTEST_ASSERT( Json::Reader().parse( text, doc ) );
+   JSONTEST_ASSERT_EQUAL( 42, std::as_const( doc.root() ).get( name( 42 ) ).asInt() );
+   doc.root().removeMember( name( 42 ), nullptr );
+   JSONTEST_ASSERT( !doc.root().isMember( name( 42 ) ) && doc.root().isMember( name( 43 ) ) );
+   JSONTEST_ASSERT( Json::Value( doc.root() ).isMember( name( 41 ) ) );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// KeyTable
+// //////////////////////////////////////////////////////////////////
+
+struct KeyTableTest : JsonTest::TestCase
+{
+   static const char *firstName( const Json::Value &object )
+   {
+      return object.begin().memberName();
+   }
+};
+
+
+JSONTEST_FIXTURE( KeyTableTest, shareNames )
+{
+   Json::KeyTable keys;
+   Json::Value first;
+   Json::Value second( Json::objectValue );
+   keys.resolve( first, "name" ) = 1;
+   keys.resolve( second, "name" ) = 2;
+   JSONTEST_ASSERT_EQUAL( Json::objectValue, first.type() );
+   JSONTEST_ASSERT( keys.size() == 1 );
+   JSONTEST_ASSERT( firstName( first ) == firstName( second ) );
+   JSONTEST_ASSERT( &keys.resolve( first, "name" ) == &first["name"] );
+   JSONTEST_ASSERT_EQUAL( 1, first["name"].asInt() );
+   JSONTEST_ASSERT_EQUAL( 2, std::as_const( second ).get( "name" ).asInt() );
+
+   // Names holding '\0', around the length of the inline strings.
+   for ( size_t length = 9; length <= 13; ++length )
+   {
+      std::string name( length, 'k' );
+      name[length / 2] = '\0';
+      keys.resolve( first, name ) = int(length);
+      JSONTEST_ASSERT( first.isMember( name ) ) << "length " << int(length);
+      JSONTEST_ASSERT( !first.isMember( name.substr( 0, length / 2 ) ) ) << "length " << int(length);
+      JSONTEST_ASSERT_EQUAL( int(length), first[name].asInt() );
+   }
+   JSONTEST_ASSERT( keys.size() == 6 );
+
+   // Interned names compare as any other name.
+   Json::Value plain( Json::objectValue );
+   plain["name"] = 2;
+   JSONTEST_ASSERT( plain == second );
+   JSONTEST_ASSERT( plain.hash() == second.hash() );
+
+   // A copy of the table shares its names.
+   Json::Value third;
+   {
+      Json::KeyTable copy( keys );
+      copy.resolve( third, "name" ) = 3;
+      JSONTEST_ASSERT( firstName( third ) == firstName( second ) );
+      JSONTEST_ASSERT( copy.size() == keys.size() );
+   }
+   JSONTEST_ASSERT( std::string( firstName( third ) ) == "name" );
+}
+
+
+JSONTEST_FIXTURE( KeyTableTest, namesOutliveTheTable )
+{
+   Json::Value copy;
+   Json::Value moved;
+   {
+      Json::KeyTable keys;
+      Json::Value object;
+      keys.resolve( object, "a name longer than the inline buffer" ) = "value";
+      keys.resolve( object, "id" ) = 1;
+      keys.clear();
+      JSONTEST_ASSERT( keys.size() == 0 );
+      JSONTEST_ASSERT( object.isMember( "id" ) );
+      JSONTEST_ASSERT_EQUAL( std::string( "value" ), object["a name longer than the inline buffer"].asString() );
+
+      // Names resolved after clear() are interned again.
+      Json::Value other;
+      keys.resolve( other, "id" ) = 2;
+      JSONTEST_ASSERT( keys.size() == 1 );
+      JSONTEST_ASSERT( other.isMember( "id" ) );
+
+      copy = object;
+      moved = std::move( object );
+   }
+   JSONTEST_ASSERT( copy == moved );
+   JSONTEST_ASSERT( std::string( firstName( copy ) ) == "a name longer than the inline buffer" );
+   copy.removeMember( "id" );
+   JSONTEST_ASSERT( moved.isMember( "id" ) );
+   JSONTEST_ASSERT( Json::FastWriter().write( moved ) == "{\"a name longer than the inline buffer\":\"value\",\"id\":1}\n" );
+}
+
+
+JSONTEST_FIXTURE( KeyTableTest, readerInternsNames )
+{
+   Json::Features features;
+   features.internKeys_ = true;
+   Json::Value first;
+   Json::Value second;
+   {
+      Json::Reader reader( features );
+      JSONTEST_ASSERT( reader.parse( "[{\"id\":1,\"k\\u00e9y\":\"x\"},{\"id\":2}]", first ) );
+      JSONTEST_ASSERT( reader.parse( "{\"id\":3}", second ) );
+   }
+   // Names are shared within and across the documents, and outlive the reader.
+   JSONTEST_ASSERT( firstName( first[0u] ) == firstName( first[1u] ) );
+   JSONTEST_ASSERT( firstName( first[0u] ) == firstName( second ) );
+   JSONTEST_ASSERT( first[0u].isMember( "k\xC3\xA9y" ) );
+   JSONTEST_ASSERT_EQUAL( 3, second["id"].asInt() );
+
+   Json::Value plain;
+   JSONTEST_ASSERT( Json::Reader().parse( "[{\"id\":1,\"k\\u00e9y\":\"x\"},{\"id\":2}]", plain ) );
+   JSONTEST_ASSERT( plain == first );
+   JSONTEST_ASSERT( firstName( plain[0u] ) != firstName( plain[1u] ) );
+}
+
+
+// Fixtures that build their trees from JSON text.
+struct ParsingTestCase : JsonTest::TestCase
+{
+   // Fails the test if document is invalid, rather than returning a null root.
+   Json::Value parse( const std::string &document )
+   {
+      Json::Reader reader;
+      Json::Value root;
+      JSONTEST_ASSERT( reader.parse( document, root ) ) << reader.getFormattedErrorMessages() << document;
+      return root;
+   }
+};
+
+
+// //////////////////////////////////////////////////////////////////
+// Copy-on-write
+// //////////////////////////////////////////////////////////////////
+
+struct CopyOnWriteTest : ParsingTestCase
+{
+};
+
+
+JSONTEST_FIXTURE( CopyOnWriteTest, copiesAreIndependent )
+{
+   Json::Value a = parse( "{\"x\":1,\"o\":{\"k\":[1,2]},\"s\":\"a string longer than the inline buffer\"}" );
+   Json::Value b = a;
+   b["x"] = 2;
+   b["o"]["k"].append( 3 );
+   b["s"] = "other";
+   JSONTEST_ASSERT_EQUAL( 1, a["x"].asInt() );
+   JSONTEST_ASSERT_EQUAL( 2u, a["o"]["k"].size() );
+   JSONTEST_ASSERT_EQUAL( std::string("a string longer than the inline buffer"), a["s"].asString() );
+   JSONTEST_ASSERT_EQUAL( 2, b["x"].asInt() );
+   JSONTEST_ASSERT_EQUAL( 3u, b["o"]["k"].size() );
+
+   Json::Value c = a;
+   a.removeMember( "x" );
+   a["o"].clear();
+   JSONTEST_ASSERT( c.isMember( "x" ) );
+   JSONTEST_ASSERT_EQUAL( 2u, c["o"]["k"].size() );
+}
+
+
+JSONTEST_FIXTURE( CopyOnWriteTest, referencesTakenBeforeCopy )
+{
+   Json::Value a;
+   a["x"] = 1;
+   Json::Value &rx = a["x"];
+   Json::Value b = a;
+   rx = 5;
+   JSONTEST_ASSERT_EQUAL( 1, b["x"].asInt() );
+   JSONTEST_ASSERT_EQUAL( 5, a["x"].asInt() );
+
+   Json::Value nested = parse( "{\"o\":{\"k\":1}}" );
+   Json::Value &k = nested["o"]["k"];
+   Json::Value nestedCopy = nested;
+   k = 2;
+   JSONTEST_ASSERT_EQUAL( 1, nestedCopy["o"]["k"].asInt() );
+
+   Json::Value array = parse( "[1,[2]]" );
+   Json::Value &element = array[1u][0u];
+   Json::Value *pointer = array.tryGet( 0u );
+   Json::Value arrayCopy = array;
+   element = 20;
+   *pointer = 10;
+   JSONTEST_ASSERT_EQUAL( 1, arrayCopy[0u].asInt() );
+   JSONTEST_ASSERT_EQUAL( 2, arrayCopy[1u][0u].asInt() );
+   JSONTEST_ASSERT_EQUAL( 10, array[0u].asInt() );
+
+   Json::Value &appended = array.append( 3 );
+   Json::Value iterated = parse( "{\"m\":1}" );
+   Json::Value::iterator it = iterated.begin();
+   Json::Value appendedCopy = array;
+   Json::Value iteratedCopy = iterated;
+   appended = 30;
+   *it = 7;
+   JSONTEST_ASSERT_EQUAL( 3, appendedCopy[2u].asInt() );
+   JSONTEST_ASSERT_EQUAL( 1, iteratedCopy["m"].asInt() );
+   JSONTEST_ASSERT_EQUAL( 7, iterated["m"].asInt() );
+}
+
+
+JSONTEST_FIXTURE( CopyOnWriteTest, pathFindDetaches )
+{
+   Json::Value e = parse( "{\"x\":{\"y\":1},\"a\":[0]}" );
+   Json::Value f = e;
+   *Json::Path( ".x.y" ).find( e ) = 7;
+   *Json::Path( "/a/0" ).find( e ) = 8;
+   JSONTEST_ASSERT_EQUAL( 1, f["x"]["y"].asInt() );
+   JSONTEST_ASSERT_EQUAL( 0, f["a"][0u].asInt() );
+   JSONTEST_ASSERT_EQUAL( 7, e["x"]["y"].asInt() );
+   JSONTEST_ASSERT_EQUAL( 8, e["a"][0u].asInt() );
+}
+
+
+JSONTEST_FIXTURE( CopyOnWriteTest, sealedTreesAreShared )
+{
+   Json::Value built;
+   built["list"].append( 1 );
+   built["list"].append( "a string longer than the inline buffer" );
+   built["object"]["member"] = true;
+   Json::Value pinnedCopy = built;
+   JSONTEST_ASSERT( &std::as_const( built ).get( "list" ) != &std::as_const( pinnedCopy ).get( "list" ) );
+
+   built.seal();
+   Json::Value copy = built;
+   JSONTEST_ASSERT( &std::as_const( built ).get( "list" ) == &std::as_const( copy ).get( "list" ) );
+   JSONTEST_ASSERT( &std::as_const( built ).get( "list" ).get( 0u ) == &std::as_const( copy ).get( "list" ).get( 0u ) );
+   copy["list"].append( 3 );
+   JSONTEST_ASSERT_EQUAL( 2u, built["list"].size() );
+   JSONTEST_ASSERT_EQUAL( 3u, copy["list"].size() );
+
+   // Non const accesses pin again, until the next seal().
+   Json::Value parsed = parse( "[1,[2]]" );
+   Json::Value &element = parsed[1u][0u];
+   Json::Value parsedCopy = parsed;
+   element = 20;
+   JSONTEST_ASSERT_EQUAL( 2, parsedCopy[1u][0u].asInt() );
+   parsed.seal();
+   Json::Value sealedCopy = parsed;
+   JSONTEST_ASSERT( &std::as_const( parsed ).get( 1u ) == &std::as_const( sealedCopy ).get( 1u ) );
+   *Json::Path( ".[1][0]" ).find( parsed ) = 30;
+   JSONTEST_ASSERT_EQUAL( 20, sealedCopy[1u][0u].asInt() );
+   JSONTEST_ASSERT_EQUAL( 30, parsed[1u][0u].asInt() );
+}
+
+
+JSONTEST_FIXTURE( CopyOnWriteTest, arenaValuesAreCopiedToTheHeap )
+{
+   Json::Document doc;
+   Json::Reader reader;
+   JSONTEST_ASSERT( reader.parse( std::string( "{\"x\":[1,\"a string longer than the inline buffer\"]}" ), doc ) );
+   Json::Value copy = doc.root();
+   doc.clear();
+   JSONTEST_ASSERT_EQUAL( 2u, copy["x"].size() );
+   JSONTEST_ASSERT_EQUAL( std::string("a string longer than the inline buffer"), copy["x"][1u].asString() );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// Hash and JSON Patch
+// //////////////////////////////////////////////////////////////////
+
+struct PatchTest : ParsingTestCase
+{
+   void checkDiff( const std::string &from, const std::string &to )
+   {
+      Json::Value source = parse( from );
+      Json::Value target = parse( to );
+      Json::Value patched = source;
+      std::string error;
+      JSONTEST_ASSERT( Json::Patch::apply( patched, Json::Patch::diff( source, target ), &error ) ) << error;
+      JSONTEST_ASSERT( patched == target ) << from << " -> " << to;
+      Json::Value merged = source;
+      Json::Patch::applyMerge( merged, Json::Patch::mergeDiff( source, target ) );
+      JSONTEST_ASSERT( merged == target ) << from << " -> " << to;
+   }
+};
+
+
+JSONTEST_FIXTURE( PatchTest, hashAfterMutation )
+{
+   Json::Value c = parse( "{\"o\":{\"k\":1}}" );
+   Json::Value d = parse( "{\"o\":{\"k\":2}}" );
+   Json::Value &k = c["o"]["k"];
+   size_t before = c.hash();
+   d.hash();
+   k = 2;
+   JSONTEST_ASSERT( c == d );
+   JSONTEST_ASSERT( d.hash() == c.hash() );
+   JSONTEST_ASSERT( before != c.hash() );
+
+   Json::Value a = parse( "[[1,2],3]" );
+   Json::Value b = parse( "[[1,5],3]" );
+   Json::Value &element = a[0u][1u];
+   a.hash();
+   b.hash();
+   element = 5;
+   JSONTEST_ASSERT( a == b );
+   JSONTEST_ASSERT( b.hash() == a.hash() );
+
+   Json::Value e = parse( "{\"m\":[1]}" );
+   Json::Value f = e;
+   e.hash();
+   f["m"].append( 2 );
+   JSONTEST_ASSERT( !( e == f ) );
+   JSONTEST_ASSERT( e.hash() != f.hash() );
+   f["m"].resize( 1 );
+   JSONTEST_ASSERT( e == f );
+   JSONTEST_ASSERT( e.hash() == f.hash() );
+}
+
+
+JSONTEST_FIXTURE( PatchTest, hashOfSealedTrees )
+{
+   Json::Value built;
+   built["list"].append( 1 );
+   built["object"]["member"] = "a string longer than the inline buffer";
+   built.hash();
+   JSONTEST_ASSERT( !built.hasCachedHash() );
+
+   built.seal();
+   Json::Value copy = built;
+   size_t hash = copy.hash();
+   JSONTEST_ASSERT( copy.hasCachedHash() );
+   JSONTEST_ASSERT( built.hasCachedHash() );
+   JSONTEST_ASSERT( std::as_const( copy ).get( "object" ).hasCachedHash() );
+   JSONTEST_ASSERT( hash == built.hash() );
+
+   // Modifying the copy detaches it and forgets its hash, not the hash of the original.
+   copy["list"].append( 2 );
+   JSONTEST_ASSERT( !copy.hasCachedHash() );
+   JSONTEST_ASSERT( built.hasCachedHash() );
+   copy.seal();
+   JSONTEST_ASSERT( copy.hash() != hash );
+   JSONTEST_ASSERT( copy.hasCachedHash() );
+
+   Json::Value parsed = parse( "{\"a\":[1,2]}" );
+   parsed.hash();
+   JSONTEST_ASSERT( parsed.hasCachedHash() );
+}
+
+
+JSONTEST_FIXTURE( PatchTest, diffThenApply )
+{
+   checkDiff( "{\"a\":1,\"b\":[1,2,3]}", "{\"a\":2,\"b\":[1,3],\"c\":{\"d\":false}}" );
+   checkDiff( "[1,2,3,4,5]", "[1,2,9,9,4,5]" );
+   checkDiff( "{\"a/b\":{\"m~n\":1}}", "{\"a/b\":{\"m~n\":[true]}}" );
+   checkDiff( "{\"a\":1}", "[1]" );
+
+   Json::Value source = parse( "{\"a\":1}" );
+   JSONTEST_ASSERT( Json::Patch::diff( source, source ).empty() );
+}
+
+
+JSONTEST_FIXTURE( PatchTest, failedApplyIsUndone )
+{
+   Json::Value root = parse( "{\"a\":1,\"b\":[1,2]}" );
+   Json::Value original = root;
+   Json::Value patch = parse( "[{\"op\":\"replace\",\"path\":\"/a\",\"value\":5},"
+                              "{\"op\":\"add\",\"path\":\"/b/-\",\"value\":3},"
+                              "{\"op\":\"test\",\"path\":\"/a\",\"value\":1}]" );
+   std::string error;
+   JSONTEST_ASSERT( !Json::Patch::apply( root, patch, &error ) );
+   JSONTEST_ASSERT( !error.empty() );
+   JSONTEST_ASSERT( root == original );
+   JSONTEST_ASSERT_EQUAL( 2u, root["b"].size() );
+
+   JSONTEST_ASSERT( !Json::Patch::apply( root, parse( "[{\"op\":\"remove\",\"path\":\"/missing\"}]" ) ) );
+   JSONTEST_ASSERT( !Json::Patch::apply( root, parse( "{\"op\":\"remove\"}" ) ) );
+   JSONTEST_ASSERT( root == original );
+
+   JSONTEST_ASSERT( Json::Patch::apply( root, parse( "[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/c\"},"
+                                                     "{\"op\":\"copy\",\"from\":\"/b\",\"path\":\"/d\"}]" ) ) );
+   JSONTEST_ASSERT( root == parse( "{\"b\":[1,2],\"c\":1,\"d\":[1,2]}" ) );
+}
+
+JSONTEST_FIXTURE( PatchTest, numbersAreComparedByValue )
+{
+   JSONTEST_ASSERT( Json::Value( 1 ).hash() == Json::Value( 1u ).hash() );
+   JSONTEST_ASSERT( Json::Value( 1 ).hash() == Json::Value( 1.0 ).hash() );
+   JSONTEST_ASSERT( Json::Value( 0.0 ).hash() == Json::Value( -0.0 ).hash() );
+   JSONTEST_ASSERT( Json::Value( Json::UInt64( 1 ) << 63 ).hash() == Json::Value( 0x1p63 ).hash() );
+
+   Json::Value root = parse( "{\"a\":1,\"b\":[1,{\"c\":-2}],\"d\":9007199254740993}" );
+   JSONTEST_ASSERT( Json::Patch::apply( root, parse( "[{\"op\":\"test\",\"path\":\"/a\",\"value\":1.0}]" ) ) );
+   JSONTEST_ASSERT( Json::Patch::apply( root, parse( "[{\"op\":\"test\",\"path\":\"/b\",\"value\":[1.0,{\"c\":-2.0}]}]" ) ) );
+   JSONTEST_ASSERT( !Json::Patch::apply( root, parse( "[{\"op\":\"test\",\"path\":\"/a\",\"value\":1.5}]" ) ) );
+   JSONTEST_ASSERT( !Json::Patch::apply( root, parse( "[{\"op\":\"test\",\"path\":\"/a\",\"value\":true}]" ) ) );
+   // 2^53 + 1 has no double representation.
+   JSONTEST_ASSERT( !Json::Patch::apply( root, parse( "[{\"op\":\"test\",\"path\":\"/d\",\"value\":9007199254740992.0}]" ) ) );
+
+   Json::Value test( Json::objectValue );
+   test["op"] = "test";
+   test["path"] = "/a";
+   test["value"] = 1u;
+   Json::Value patch( Json::arrayValue );
+   patch.append( test );
+   JSONTEST_ASSERT( Json::Patch::apply( root, patch ) );
+   patch[0u]["path"] = "/b/1/c";
+   patch[0u]["value"] = Json::UInt( 2 );
+   JSONTEST_ASSERT( !Json::Patch::apply( root, patch ) );
+
+   Json::Value target = parse( "{\"a\":1.0,\"b\":[1.0,{\"c\":-2.0}],\"d\":9007199254740993}" );
+   target["a"] = 1u;
+   JSONTEST_ASSERT_EQUAL( 0u, Json::Patch::diff( root, target ).size() );
+   JSONTEST_ASSERT_EQUAL( 0u, Json::Patch::mergeDiff( root, target ).size() );
+   target["b"][0u] = 1.5;
+   Json::Value delta = Json::Patch::diff( root, target );
+   JSONTEST_ASSERT_EQUAL( 1u, delta.size() );
+   JSONTEST_ASSERT_EQUAL( std::string( "/b/0" ), delta[0u]["path"].asString() );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// CBOR
+// //////////////////////////////////////////////////////////////////
+
+struct BinaryTest : JsonTest::TestCase
+{
+   void checkRoundTrip( const Json::Value &value )
+   {
+      Json::BinaryWriter writer;
+      Json::BinaryReader reader;
+      Json::Value read;
+      JSONTEST_ASSERT( reader.parse( writer.write( value ), read ) ) << reader.getFormattedErrorMessages();
+      JSONTEST_ASSERT( read == value );
+      JSONTEST_ASSERT_EQUAL( value.type(), read.type() );
+   }
+
+   void checkMalformed( const std::string &document )
+   {
+      Json::BinaryReader reader;
+      Json::Value read;
+      JSONTEST_ASSERT( !reader.parse( document, read ) ) << "document of " << int( document.size() ) << " bytes";
+      JSONTEST_ASSERT( !reader.getFormattedErrorMessages().empty() );
+   }
+};
+
+
+JSONTEST_FIXTURE( BinaryTest, roundTrip )
+{
+   checkRoundTrip( Json::Value() );
+   checkRoundTrip( true );
+   checkRoundTrip( 0 );
+   checkRoundTrip( 23 );
+   checkRoundTrip( -24 );
+   checkRoundTrip( Json::Value::maxInt );
+   checkRoundTrip( Json::Value::minInt );
+   checkRoundTrip( Json::Value::minLargestInt );
+   checkRoundTrip( Json::Value::maxLargestUInt );
+   checkRoundTrip( 0.5 );
+   checkRoundTrip( 1.1 );
+   checkRoundTrip( -1e300 );
+   checkRoundTrip( std::string( "nul\0inside", 10 ) );
+
+   Json::Value tree;
+   tree["empty"] = Json::Value( Json::objectValue );
+   tree["list"].append( "a string longer than the inline buffer" );
+   tree["list"].append( Json::Value( Json::arrayValue ) );
+   tree[std::string( "key\0", 4 )] = 3;
+   checkRoundTrip( tree );
+}
+
+
+JSONTEST_FIXTURE( BinaryTest, readGenericItems )
+{
+   Json::BinaryReader reader;
+   Json::Value read;
+   // Tagged indefinite-length array of a half float and an indefinite-length string.
+   JSONTEST_ASSERT( reader.parse( std::string( "\xc1\x9f\xf9\x3c\x00\x7f\x61\x61\x61\x62\xff\xff", 12 ), read ) );
+   JSONTEST_ASSERT_EQUAL( 2u, read.size() );
+   JSONTEST_ASSERT_EQUAL( 1.0, read[0u].asDouble() );
+   JSONTEST_ASSERT_EQUAL( std::string( "ab" ), read[1u].asString() );
+   // Indefinite-length map, and undefined.
+   JSONTEST_ASSERT( reader.parse( std::string( "\xbf\x61x\xf7\xff", 5 ), read ) );
+   JSONTEST_ASSERT( read.isMember( "x" ) && read["x"].isNull() );
+}
+
+
+JSONTEST_FIXTURE( BinaryTest, rejectMalformed )
+{
+   checkMalformed( "" );
+   checkMalformed( "\x19\x01" );               // truncated argument
+   checkMalformed( "\x63" "ab" );              // truncated string
+   checkMalformed( "\x83\x01\x02" );           // truncated array
+   checkMalformed( "\xa1\x01\x02" );           // member name is not a text string
+   checkMalformed( "\x1c" );                   // reserved additional information
+   checkMalformed( "\x1f" );                   // indefinite-length integer
+   checkMalformed( "\x7f\x41" "a\xff" );       // byte string chunk in a text string
+   checkMalformed( "\xff" );                   // unexpected break
+   checkMalformed( "\xf8\x20" );               // unsupported simple value
+   checkMalformed( "\x01\x02" );               // extra data
+   checkMalformed( "\x9b\xff\xff\xff\xff\xff\xff\xff\xff" ); // huge length
+}
+
+
+JSONTEST_FIXTURE( BinaryTest, rejectDeepNesting )
+{
+   std::string deep( 1000, '\x81' );
+   deep += '\x00';
+   Json::BinaryReader reader;
+   Json::Value read;
+   JSONTEST_ASSERT( reader.parse( deep, read ) ) << reader.getFormattedErrorMessages();
+
+   checkMalformed( '\x81' + deep );
+   checkMalformed( std::string( 1 << 20, '\x81' ) );
+   checkMalformed( std::string( 1 << 20, '\xa1' ) );
+   checkMalformed( std::string( 1 << 20, '\xc1' ) );
+   JSONTEST_ASSERT( !Json::BinaryReader( 2 ).parse( std::string( "\x81\x81\x81\x00", 4 ), read ) );
+   JSONTEST_ASSERT( Json::BinaryReader( 3 ).parse( std::string( "\x81\x81\x81\x00", 4 ), read ) );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// Handler
+// //////////////////////////////////////////////////////////////////
+
+struct HandlerTest : JsonTest::TestCase
+{
+   // Records the events as text.
+   struct Recorder : Json::Handler
+   {
+      std::string events;
+
+      bool startObject() override { events += "{"; return true; }
+      bool key( std::string_view name ) override { events += std::string( name ) + ":"; return true; }
+      bool endObject() override { events += "}"; return true; }
+      bool startArray() override { events += "["; return true; }
+      bool endArray() override { events += "]"; return true; }
+      bool value( std::nullptr_t ) override { events += "null "; return true; }
+      bool value( bool value ) override { events += value ? "true " : "false "; return true; }
+      bool value( Json::LargestInt value ) override { events += "int:" + std::to_string( value ) + " "; return true; }
+      bool value( Json::LargestUInt value ) override { events += "uint:" + std::to_string( value ) + " "; return true; }
+      bool value( double ) override { events += "double "; return true; }
+      bool value( std::string_view value ) override { events += "\"" + std::string( value ) + "\" "; return true; }
+   };
+
+   std::string record( const std::string &document )
+   {
+      Recorder recorder;
+      Json::Reader reader;
+      JSONTEST_ASSERT( reader.parse( document.data(), document.data() + document.size(), recorder ) )
+         << reader.getFormattedErrorMessages();
+      return recorder.events;
+   }
+};
+
+
+JSONTEST_FIXTURE( HandlerTest, events )
+{
+   JSONTEST_ASSERT_EQUAL( std::string( "{a:[null true \"s\" double ]b:{}}" ),
+                          record( "{\"a\":[null,true,\"s\",1.5],\"b\":{}}" ) );
+}
+
+
+JSONTEST_FIXTURE( HandlerTest, largeIntegers )
+{
+   JSONTEST_ASSERT_EQUAL( std::string( "[int:2147483647 int:3000000000 int:9223372036854775807 "
+                                       "uint:9223372036854775808 uint:18446744073709551615 "
+                                       "int:-9223372036854775808 double ]" ),
+                          record( "[2147483647,3000000000,9223372036854775807,9223372036854775808,"
+                                  "18446744073709551615,-9223372036854775808,18446744073709551616]" ) );
+
+   // The Value types do not depend on the dispatch.
+   Json::Reader reader;
+   Json::Value root;
+   JSONTEST_ASSERT( reader.parse( "[2147483647,3000000000,-3000000000]", root ) );
+   JSONTEST_ASSERT_EQUAL( Json::intValue, root[0u].type() );
+   JSONTEST_ASSERT_EQUAL( Json::uintValue, root[1u].type() );
+   JSONTEST_ASSERT_EQUAL( Json::intValue, root[2u].type() );
+   JSONTEST_ASSERT( root[1u].asLargestUInt() == 3000000000u );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// Numbers
+// //////////////////////////////////////////////////////////////////
+
+struct NumberTest : JsonTest::TestCase
+{
+   // Locales to run the conversions in: the C locale, and locales using a decimal
+   // comma if they are installed.
+   static std::vector<std::string> locales()
+   {
+      std::vector<std::string> names( 1, "C" );
+      for ( const char *name : { "de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "fr_FR" } )
+      {
+         if ( setlocale( LC_NUMERIC, name ) )
+            names.push_back( name );
+      }
+      setlocale( LC_NUMERIC, "C" );
+      return names;
+   }
+
+   static bool sameBits( double a, double b )
+   {
+      return memcmp( &a, &b, sizeof a ) == 0;
+   }
+
+   // Finite doubles of every magnitude, denormals included.
+   static std::vector<double> randomDoubles( size_t count )
+   {
+      std::mt19937_64 random( 42 );
+      std::vector<double> values;
+      while ( values.size() < count )
+      {
+         const Json::UInt64 bits = random();
+         double value;
+         memcpy( &value, &bits, sizeof value );
+         if ( std::isfinite( value ) )
+            values.push_back( value );
+      }
+      return values;
+   }
+};
+
+
+JSONTEST_FIXTURE( NumberTest, parseDoubles )
+{
+   struct Case { const char *text; double value; };
+   const Case cases[] = {
+      { "0.1", 0.1 },
+      { "-0.0", -0.0 },
+      { "1e300", 1e300 },
+      { "-1E+300", -1e300 },
+      { "123456.789e-3", 123.456789 },
+      { "1.7976931348623157e308", 1.7976931348623157e308 },
+      { "2.2250738585072014e-308", 2.2250738585072014e-308 }, // smallest normal
+      { "2.2250738585072009e-308", 2.2250738585072009e-308 }, // largest denormal
+      { "4.9406564584124654e-324", 4.9406564584124654e-324 }, // smallest denormal
+      { "2.4703282292062328e-324", 4.9406564584124654e-324 }, // rounds up to it
+      { "9007199254740993.0", 9007199254740992.0 },           // ties round to even
+      { "1e400", std::numeric_limits<double>::infinity() },
+      { "-1e400", -std::numeric_limits<double>::infinity() },
+      { "1e-400", 0.0 },
+   };
+   const std::vector<double> values = randomDoubles( 1000 );
+   for ( const std::string &locale : locales() )
+   {
+      setlocale( LC_NUMERIC, locale.c_str() );
+      Json::Reader reader;
+      Json::Value root;
+      for ( const Case &test : cases )
+      {
+         JSONTEST_ASSERT( reader.parse( std::string( "[" ) + test.text + "]", root ) )
+            << test.text << ": " << reader.getFormattedErrorMessages();
+         JSONTEST_ASSERT( sameBits( root[0u].asDouble(), test.value ) ) << test.text << " in locale " << locale;
+      }
+
+      // Every double is read back from its shortest representation.
+      std::string document = "[";
+      for ( double value : values )
+      {
+         char buffer[32];
+         document.append( buffer, std::to_chars( buffer, buffer + sizeof buffer, value ).ptr );
+         document += ',';
+      }
+      document.back() = ']';
+      JSONTEST_ASSERT( reader.parse( document, root ) ) << reader.getFormattedErrorMessages();
+      JSONTEST_ASSERT( root.size() == values.size() );
+      for ( Json::ArrayIndex index = 0; index < root.size(); ++index )
+         JSONTEST_ASSERT( sameBits( root[index].asDouble(), values[index] ) ) << "element " << int(index);
+   }
+   setlocale( LC_NUMERIC, "C" );
+
+   Json::Reader reader;
+   Json::Value root;
+   for ( const char *invalid : { "[1.2.3]", "[-]", "[1e]", "[1e+]", "[.5]", "[--1]" } )
+      JSONTEST_ASSERT( !reader.parse( invalid, root ) ) << invalid;
+}
+
+
+JSONTEST_FIXTURE( NumberTest, writeDoubles )
+{
+   struct Case { double value; const char *text; };
+   const Case cases[] = {
+      { 0.1, "0.1" },
+      { 0.30000000000000004, "0.30000000000000004" },
+      { 1.0, "1.0" },
+      { -0.0, "-0.0" },
+      { 100.0, "100.0" },
+      { 1e300, "1e+300" },
+      { -1.5e-7, "-1.5e-07" },
+      { 5e-324, "5e-324" },
+      { 2.2250738585072009e-308, "2.225073858507201e-308" },
+      { 1.7976931348623157e308, "1.7976931348623157e+308" },
+   };
+   const std::vector<double> values = randomDoubles( 1000 );
+   Json::Value array( Json::arrayValue );
+   for ( double value : values )
+      array.append( value );
+   for ( const std::string &locale : locales() )
+   {
+      setlocale( LC_NUMERIC, locale.c_str() );
+      for ( const Case &test : cases )
+      {
+         JSONTEST_ASSERT_EQUAL( std::string( test.text ), Json::valueToString( test.value ) ) << "in locale " << locale;
+         Json::Value single( Json::arrayValue );
+         single.append( test.value );
+         JSONTEST_ASSERT_EQUAL( std::string( "[" ) + test.text + "]\n", Json::FastWriter().write( single ) );
+      }
+
+      // Every double is written in a form read back to the same bits.
+      for ( bool styled : { false, true } )
+      {
+         const std::string document = styled ? Json::StyledWriter().write( array ) : Json::FastWriter().write( array );
+         Json::Value root;
+         JSONTEST_ASSERT( Json::Reader().parse( document, root ) );
+         JSONTEST_ASSERT( root.size() == values.size() );
+         for ( Json::ArrayIndex index = 0; index < root.size(); ++index )
+         {
+            JSONTEST_ASSERT( root[index].isDouble() ) << "element " << int(index);
+            JSONTEST_ASSERT( sameBits( root[index].asDouble(), values[index] ) ) << "element " << int(index);
+         }
+      }
+   }
+   setlocale( LC_NUMERIC, "C" );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// Writers
+// //////////////////////////////////////////////////////////////////
+
+struct WriterTest : JsonTest::TestCase
+{
+   // Checks that root is written as by a single thread, with any number of threads.
+   void checkParallelWrite( const Json::Value &root, bool yaml = false )
+   {
+      Json::FastWriter serial;
+      if ( yaml )
+         serial.enableYAMLCompatibility();
+      const std::string expected = serial.write( root );
+      for ( unsigned int threadCount : { 1u, 2u, 3u, 8u, 0u } )
+      {
+         Json::FastWriter writer;
+         if ( yaml )
+            writer.enableYAMLCompatibility();
+         writer.enableParallelWrite( threadCount );
+         JSONTEST_ASSERT( writer.write( root ) == expected ) << "threads: " << threadCount;
+
+         std::string appended = "prefix";
+         writer.write( root, appended );
+         JSONTEST_ASSERT( appended == "prefix" + expected ) << "threads: " << threadCount;
+
+         std::ostringstream stream;
+         writer.write( root, stream );
+         JSONTEST_ASSERT( stream.str() == expected ) << "threads: " << threadCount;
+
+         std::string truncated( expected.length() / 2, '*' );
+         JSONTEST_ASSERT( writer.write( root, &truncated[0], truncated.length() ) == expected.length() );
+         JSONTEST_ASSERT( truncated == expected.substr( 0, truncated.length() ) ) << "threads: " << threadCount;
+      }
+   }
+
+   // The escape expected for each byte, as the writers wrote it before the escape table.
+   static std::string expectedEscape( unsigned char c )
+   {
+      switch ( c )
+      {
+      case '"': return "\\\"";
+      case '\\': return "\\\\";
+      case '\b': return "\\b";
+      case '\f': return "\\f";
+      case '\n': return "\\n";
+      case '\r': return "\\r";
+      case '\t': return "\\t";
+      default:
+         if ( c < 0x20 )
+         {
+            char escape[7];
+            snprintf( escape, sizeof escape, "\\u%04X", c );
+            return escape;
+         }
+         return std::string( 1, char(c) );
+      }
+   }
+};
+
+
+JSONTEST_FIXTURE( WriterTest, styledLayout )
+{
+   // The layout of the writers before the single pass engine: nested and empty
+   // containers, arrays around the right margin, and comments, which are dropped.
+   struct Case
+   {
+      const char *input;
+      const char *styled;
+      const char *stream;
+   };
+   const Case cases[] = {
+      { "{\"a\":[1,2,{\"b\":null}],\"c\":{\"d\":\"e\",\"f\":[],\"g\":{}},\"h\":true,\"i\":-12}",
+        "{\n"
+        "   \"a\" : [\n"
+        "      1,\n"
+        "      2,\n"
+        "      {\n"
+        "         \"b\" : null\n"
+        "      }\n"
+        "   ],\n"
+        "   \"c\" : {\n"
+        "      \"d\" : \"e\",\n"
+        "      \"f\" : [],\n"
+        "      \"g\" : {}\n"
+        "   },\n"
+        "   \"h\" : true,\n"
+        "   \"i\" : -12\n"
+        "}\n",
+        "\n"
+        "{\n"
+        "\t\"a\" : \n"
+        "\t[\n"
+        "\t\t1,\n"
+        "\t\t2,\n"
+        "\t\t\n"
+        "\t\t{\n"
+        "\t\t\t\"b\" : null\n"
+        "\t\t}\n"
+        "\t],\n"
+        "\t\"c\" : \n"
+        "\t{\n"
+        "\t\t\"d\" : \"e\",\n"
+        "\t\t\"f\" : [],\n"
+        "\t\t\"g\" : {}\n"
+        "\t},\n"
+        "\t\"h\" : true,\n"
+        "\t\"i\" : -12\n"
+        "}\n" },
+      { "[[1,2,3],[],{},[[]],[{\"deep\":[[[\"x\"]]]}],\"s\",false]",
+        "[\n"
+        "   [ 1, 2, 3 ],\n"
+        "   [],\n"
+        "   {},\n"
+        "   [ [] ],\n"
+        "   [\n"
+        "      {\n"
+        "         \"deep\" : [\n"
+        "            [\n"
+        "               [ \"x\" ]\n"
+        "            ]\n"
+        "         ]\n"
+        "      }\n"
+        "   ],\n"
+        "   \"s\",\n"
+        "   false\n"
+        "]\n",
+        "\n"
+        "[\n"
+        "\t[ 1, 2, 3 ],\n"
+        "\t[],\n"
+        "\t{},\n"
+        "\t[ [] ],\n"
+        "\t\n"
+        "\t[\n"
+        "\t\t\n"
+        "\t\t{\n"
+        "\t\t\t\"deep\" : \n"
+        "\t\t\t[\n"
+        "\t\t\t\t\n"
+        "\t\t\t\t[\n"
+        "\t\t\t\t\t[ \"x\" ]\n"
+        "\t\t\t\t]\n"
+        "\t\t\t]\n"
+        "\t\t}\n"
+        "\t],\n"
+        "\t\"s\",\n"
+        "\tfalse\n"
+        "]\n" },
+      { "{\"edge\":[\"eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee\"],\"over\":[\"oooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooo\"],\"three\":[\"ttttttttttttttttttt\",\"ttttttttttttttttttt\",\"ttttttttttttttttttt\"],\"threeOver\":[\"tttttttttttttttttttt\",\"tttttttttttttttttttt\",\"tttttttttttttttttttt\"],\"wide\":[1000000,2000000,3000000,4000000,5000000,6000000,7000000,8000000,9000000,10000000,11000000],\"objects\":[{}],\"escaped \\\"key\\\"\":[[],{}]}",
+        "{\n"
+        "   \"edge\" : [ \"eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee\" ],\n"
+        "   \"escaped \\\"key\\\"\" : [ [], {} ],\n"
+        "   \"objects\" : [ {} ],\n"
+        "   \"over\" : [\n"
+        "      \"oooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooo\"\n"
+        "   ],\n"
+        "   \"three\" : [ \"ttttttttttttttttttt\", \"ttttttttttttttttttt\", \"ttttttttttttttttttt\" ],\n"
+        "   \"threeOver\" : [\n"
+        "      \"tttttttttttttttttttt\",\n"
+        "      \"tttttttttttttttttttt\",\n"
+        "      \"tttttttttttttttttttt\"\n"
+        "   ],\n"
+        "   \"wide\" : [\n"
+        "      1000000,\n"
+        "      2000000,\n"
+        "      3000000,\n"
+        "      4000000,\n"
+        "      5000000,\n"
+        "      6000000,\n"
+        "      7000000,\n"
+        "      8000000,\n"
+        "      9000000,\n"
+        "      10000000,\n"
+        "      11000000\n"
+        "   ]\n"
+        "}\n",
+        "\n"
+        "{\n"
+        "\t\"edge\" : [ \"eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee\" ],\n"
+        "\t\"escaped \\\"key\\\"\" : [ [], {} ],\n"
+        "\t\"objects\" : [ {} ],\n"
+        "\t\"over\" : \n"
+        "\t[\n"
+        "\t\t\"oooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooo\"\n"
+        "\t],\n"
+        "\t\"three\" : [ \"ttttttttttttttttttt\", \"ttttttttttttttttttt\", \"ttttttttttttttttttt\" ],\n"
+        "\t\"threeOver\" : \n"
+        "\t[\n"
+        "\t\t\"tttttttttttttttttttt\",\n"
+        "\t\t\"tttttttttttttttttttt\",\n"
+        "\t\t\"tttttttttttttttttttt\"\n"
+        "\t],\n"
+        "\t\"wide\" : \n"
+        "\t[\n"
+        "\t\t1000000,\n"
+        "\t\t2000000,\n"
+        "\t\t3000000,\n"
+        "\t\t4000000,\n"
+        "\t\t5000000,\n"
+        "\t\t6000000,\n"
+        "\t\t7000000,\n"
+        "\t\t8000000,\n"
+        "\t\t9000000,\n"
+        "\t\t10000000,\n"
+        "\t\t11000000\n"
+        "\t]\n"
+        "}\n" },
+      { "[\"quote \\\" backslash \\\\ tab \\t newline \\n\",\"control \\u0001 unicode \xc3" "\xa9" "\",\"\"]",
+        "[\n"
+        "   \"quote \\\" backslash \\\\ tab \\t newline \\n\",\n"
+        "   \"control \\u0001 unicode \xc3" "\xa9" "\",\n"
+        "   \"\"\n"
+        "]\n",
+        "\n"
+        "[\n"
+        "\t\"quote \\\" backslash \\\\ tab \\t newline \\n\",\n"
+        "\t\"control \\u0001 unicode \xc3" "\xa9" "\",\n"
+        "\t\"\"\n"
+        "]\n" },
+      { "// before the root\n"
+        "{\n"
+        "   // before a\n"
+        "   \"a\" : 1, // after a\n"
+        "   /* before b */\n"
+        "   \"b\" : [ 1, /* after one */ 2 ], // after b\n"
+        "   \"c\" : { \"d\" : \"e\" }\n"
+        "}\n"
+        "// after the root",
+        "{\n"
+        "   \"a\" : 1,\n"
+        "   \"b\" : [ 1, 2 ],\n"
+        "   \"c\" : {\n"
+        "      \"d\" : \"e\"\n"
+        "   }\n"
+        "}\n",
+        "\n"
+        "{\n"
+        "\t\"a\" : 1,\n"
+        "\t\"b\" : [ 1, 2 ],\n"
+        "\t\"c\" : \n"
+        "\t{\n"
+        "\t\t\"d\" : \"e\"\n"
+        "\t}\n"
+        "}\n" },
+      { "\"root string\"",
+        "\"root string\"\n",
+        "\"root string\"\n" },
+      { "[]",
+        "[]\n",
+        "[]\n" },
+   };
+   // The same writers are reused from one document to the next.
+   Json::StyledWriter styledWriter;
+   Json::StyledStreamWriter streamWriter;
+   for ( const Case &test : cases )
+   {
+      Json::Reader reader;
+      Json::Value root;
+      JSONTEST_ASSERT( reader.parse( test.input, root, true ) ) << reader.getFormattedErrorMessages();
+      JSONTEST_ASSERT_EQUAL( std::string( test.styled ), styledWriter.write( root ) ) << test.input;
+      JSONTEST_ASSERT_EQUAL( std::string( test.styled ), root.toStyledString() ) << test.input;
+      std::ostringstream stream;
+      streamWriter.write( stream, root );
+      JSONTEST_ASSERT_EQUAL( std::string( test.stream ), stream.str() ) << test.input;
+   }
+}
+
+
+JSONTEST_FIXTURE( WriterTest, embeddedZeros )
+{
+   Json::Value root;
+   root[std::string( "k\0ey", 4 )] = std::string( "va\0lue", 6 );
+   root["list"].append( std::string( "\0", 1 ) );
+
+   const std::string fast = Json::FastWriter().write( root );
+   JSONTEST_ASSERT( fast.find( "\"k\\u0000ey\"" ) != std::string::npos ) << fast;
+   JSONTEST_ASSERT( fast.find( "\"va\\u0000lue\"" ) != std::string::npos ) << fast;
+
+   const std::string styled = Json::StyledWriter().write( root );
+   JSONTEST_ASSERT( styled.find( "\"k\\u0000ey\" : \"va\\u0000lue\"" ) != std::string::npos ) << styled;
+   JSONTEST_ASSERT( styled.find( "[ \"\\u0000\" ]" ) != std::string::npos ) << styled;
+
+   std::ostringstream stream;
+   stream << root;
+   JSONTEST_ASSERT( stream.str().find( "\"k\\u0000ey\" : \"va\\u0000lue\"" ) != std::string::npos ) << stream.str();
+
+   Json::Reader reader;
+   Json::Value read;
+   JSONTEST_ASSERT( reader.parse( styled, read ) ) << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT( read == root );
+}
+
+
+JSONTEST_FIXTURE( WriterTest, parallelWriteLargeDocuments )
+{
+   Json::Value array( Json::arrayValue );
+   for ( int index = 0; index < 100000; ++index )
+   {
+      switch ( index % 5 )
+      {
+      case 0: array.append( index ); break;
+      case 1: array.append( index * 0.5 ); break;
+      case 2: array.append( "string number " + std::to_string( index ) ); break;
+      case 3: array.append( index % 2 == 0 ); break;
+      default: array.append( Json::Value() ); break;
+      }
+   }
+   checkParallelWrite( array );
+
+   Json::Value object( Json::objectValue );
+   for ( int index = 0; index < 20000; ++index )
+   {
+      Json::Value &member = object["member " + std::to_string( index )];
+      member["index"] = index;
+      member["list"].append( index );
+      member["list"].append( "\"quoted\"\n" );
+   }
+   checkParallelWrite( object );
+   checkParallelWrite( object, true );
+
+   // A small root holding large containers: they are split too.
+   Json::Value nested;
+   nested["array"] = array;
+   nested["object"] = object;
+   nested["empty"] = Json::Value( Json::arrayValue );
+   nested["scalar"] = 1;
+   checkParallelWrite( nested );
+
+   // Containers nested deeper than the split depth are written whole.
+   Json::Value deep = array;
+   for ( int depth = 0; depth < 8; ++depth )
+   {
+      Json::Value parent( Json::arrayValue );
+      parent.append( deep );
+      parent.append( depth );
+      deep = parent;
+   }
+   checkParallelWrite( deep );
+}
+
+
+JSONTEST_FIXTURE( WriterTest, parallelWriteSmallDocuments )
+{
+   // Scalars, empty and small containers are written by the calling thread.
+   checkParallelWrite( Json::Value() );
+   checkParallelWrite( Json::Value( "scalar" ) );
+   checkParallelWrite( Json::Value( Json::arrayValue ) );
+   checkParallelWrite( Json::Value( Json::objectValue ) );
+   Json::Value small;
+   small["a"].append( 1 );
+   small["b"] = "text";
+   checkParallelWrite( small );
+   checkParallelWrite( small, true );
+
+   // The same writer serializes large and small documents in turn.
+   Json::Value large( Json::arrayValue );
+   for ( int index = 0; index < 50000; ++index )
+      large.append( index );
+   Json::FastWriter writer;
+   writer.enableParallelWrite( 4 );
+   for ( int round = 0; round < 3; ++round )
+   {
+      JSONTEST_ASSERT( writer.write( large ) == Json::FastWriter().write( large ) );
+      JSONTEST_ASSERT( writer.write( small ) == Json::FastWriter().write( small ) );
+   }
+}
+
+
+JSONTEST_FIXTURE( WriterTest, writeIntoBuffers )
+{
+   Json::Value root;
+   JSONTEST_ASSERT( Json::Reader().parse( "{\"a\":[1,2.5,\"x\"],\"b\":null}", root ) );
+   const std::string expected = Json::FastWriter().write( root );
+   Json::FastWriter writer;
+
+   // Strings are appended to.
+   std::string document = "prefix";
+   writer.write( root, document );
+   writer.write( root, document );
+   JSONTEST_ASSERT( document == "prefix" + expected + expected );
+
+   std::ostringstream stream;
+   writer.write( root, stream );
+   JSONTEST_ASSERT( stream.str() == expected );
+
+   // Arrays hold what fits, and the length of the whole document is returned.
+   for ( size_t capacity : { size_t(0), size_t(1), size_t(7), expected.size() - 1, expected.size(), expected.size() + 4 } )
+   {
+      std::vector<char> buffer( capacity + 8, '#' );
+      JSONTEST_ASSERT( writer.write( root, buffer.data(), capacity ) == expected.size() ) << "capacity " << int(capacity);
+      const size_t written = std::min( capacity, expected.size() );
+      JSONTEST_ASSERT( std::string( buffer.data(), written ) == expected.substr( 0, written ) ) << "capacity " << int(capacity);
+      JSONTEST_ASSERT( std::string( buffer.data() + written, buffer.size() - written ) == std::string( buffer.size() - written, '#' ) )
+         << "capacity " << int(capacity);
+   }
+   JSONTEST_ASSERT( writer.write( root, nullptr, 0 ) == expected.size() );
+
+   // Large documents are passed to sinks in several blocks, and truncated anywhere.
+   Json::Value large( Json::arrayValue );
+   for ( int index = 0; index < 5000; ++index )
+      large.append( "string \"" + std::to_string( index ) + "\"" );
+   const std::string largeExpected = Json::FastWriter().write( large );
+   struct BlockSink : Json::OutputSink
+   {
+      std::string document;
+      int blocks = 0;
+
+      void write( const char *data, size_t length ) override
+      {
+         document.append( data, length );
+         ++blocks;
+      }
+   } sink;
+   writer.write( large, sink );
+   JSONTEST_ASSERT( sink.document == largeExpected );
+   JSONTEST_ASSERT( sink.blocks > 1 );
+   for ( size_t capacity : { size_t(4095), size_t(4096), size_t(4097), largeExpected.size() / 2 } )
+   {
+      std::vector<char> buffer( capacity + 1, '#' );
+      JSONTEST_ASSERT( writer.write( large, buffer.data(), capacity ) == largeExpected.size() ) << "capacity " << int(capacity);
+      JSONTEST_ASSERT( std::string( buffer.data(), capacity ) == largeExpected.substr( 0, capacity ) ) << "capacity " << int(capacity);
+      JSONTEST_ASSERT( buffer[capacity] == '#' ) << "capacity " << int(capacity);
+   }
+}
+
+
+JSONTEST_FIXTURE( WriterTest, escapeEveryByte )
+{
+   Json::FastWriter writer;
+   for ( int c = 0; c < 256; ++c )
+   {
+      const char character = char(c);
+      const std::string expected = "\"" + expectedEscape( (unsigned char)c ) + "\"";
+      JSONTEST_ASSERT( writer.write( Json::Value( std::string_view( &character, 1 ) ) ) == expected + "\n" ) << "byte " << c;
+      if ( c != 0 )
+      {
+         const char string[] = { character, 0 };
+         JSONTEST_ASSERT( Json::valueToQuotedString( string ) == expected ) << "byte " << c;
+      }
+   }
+
+   // Each byte at every position of the blocks scanned at once, among ASCII and
+   // non-ASCII characters.
+   for ( const char *filler : { "a", "\xC3\xA9", "\x7F" } )
+   {
+      std::string text;
+      while ( text.size() < 70 )
+         text += filler;
+      for ( int c : { 0x00, 0x01, 0x1F, 0x20, int('"'), int('\\'), int('/'), 0x7F, 0x80, 0xFF } )
+      {
+         for ( size_t position = 0; position <= text.size(); ++position )
+         {
+            std::string string = text;
+            string.insert( position, 1, char(c) );
+            std::string expected = "\"";
+            for ( char character : string )
+               expected += expectedEscape( (unsigned char)character );
+            expected += "\"\n";
+            JSONTEST_ASSERT( writer.write( Json::Value( std::string_view( string ) ) ) == expected )
+               << "byte " << c << " at " << int(position);
+         }
+      }
+   }
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// BatchReader
+// //////////////////////////////////////////////////////////////////
+
+struct BatchReaderTest : JsonTest::TestCase
+{
+   // count lines of about 100 bytes, the line of index bad being invalid.
+   static std::string makeBatch( int count, int bad )
+   {
+      std::string batch;
+      for ( int index = 0; index < count; ++index )
+      {
+         if ( index == bad )
+            batch += "{\"index\":}\n";
+         else
+            batch += "{\"index\":" + std::to_string( index ) + ",\"padding\":\"" + std::string( 70, 'x' ) + "\"}\r\n";
+         if ( index % 1000 == 0 )
+            batch += "\n";
+      }
+      return batch;
+   }
+
+   void checkBatch( Json::BatchReader &reader, int count, int bad )
+   {
+      const std::string batch = makeBatch( count, bad );
+      Json::BatchReader::Records records;
+      JSONTEST_ASSERT_EQUAL( bad < 0, reader.parse( batch, records ) );
+      JSONTEST_ASSERT_EQUAL( count, int( records.size() ) );
+      for ( int index = 0; index < int( records.size() ); ++index )
+      {
+         const Json::BatchReader::Record &record = records[index];
+         JSONTEST_ASSERT_EQUAL( index == bad, !record.errors_.empty() );
+         if ( index != bad )
+            JSONTEST_ASSERT_EQUAL( index, record.root_.get( "index" ).asInt() ) << "record " << index;
+         JSONTEST_ASSERT_EQUAL( '{', batch[record.offset_] );
+      }
+   }
+};
+
+
+JSONTEST_FIXTURE( BatchReaderTest, parseSeveralBatches )
+{
+   Json::BatchReader reader( Json::Features::all(), 4 );
+   checkBatch( reader, 10, -1 );
+   checkBatch( reader, 20000, 12345 );
+   checkBatch( reader, 5000, -1 );
+   checkBatch( reader, 20000, 0 );
+   checkBatch( reader, 0, -1 );
+
+   Json::BatchReader single( Json::Features::all(), 1 );
+   checkBatch( single, 5000, 4999 );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// Arena and Document
+// //////////////////////////////////////////////////////////////////
+
+struct ArenaTest : JsonTest::TestCase
+{
+};
+
+
+JSONTEST_FIXTURE( ArenaTest, allocate )
+{
+   Json::Arena arena( 16 );
+   for ( int index = 0; index < 100; ++index )
+   {
+      void *memory = arena.allocate( 24, 16 );
+      JSONTEST_ASSERT( reinterpret_cast<size_t>( memory ) % 16 == 0 );
+   }
+   const char *copy = arena.duplicate( std::string_view( "abc\0def", 7 ) );
+   JSONTEST_ASSERT( std::string( copy, 8 ) == std::string( "abc\0def\0", 8 ) );
+   arena.release();
+   JSONTEST_ASSERT( arena.allocate( 1 ) != 0 );
+}
+
+
+JSONTEST_FIXTURE( ArenaTest, buildTree )
+{
+   Json::Arena arena;
+   Json::Value root( Json::objectValue, arena );
+   root["name"] = Json::Value( std::string_view( "a string longer than the inline buffer" ), arena );
+   Json::Value &list = root["list"];
+   list = Json::Value( Json::arrayValue, arena );
+   for ( int index = 0; index < 100; ++index )
+      list.append( index );
+   list[50u] = Json::Value( Json::objectValue, arena );
+   list[50u]["nested"] = true;
+   root.removeMember( "missing" );
+
+   JSONTEST_ASSERT_EQUAL( 100u, root["list"].size() );
+   JSONTEST_ASSERT_EQUAL( 99, root["list"][99u].asInt() );
+   JSONTEST_ASSERT( root["list"][50u]["nested"].asBool() );
+   JSONTEST_ASSERT_EQUAL( std::string( "a string longer than the inline buffer" ), root["name"].asString() );
+
+   Json::Value heap = root;
+   Json::Reader reader;
+   Json::Value expected;
+   JSONTEST_ASSERT( reader.parse( Json::FastWriter().write( root ), expected ) );
+   JSONTEST_ASSERT( heap == expected );
+   JSONTEST_ASSERT( heap == root );
+}
+
+
+JSONTEST_FIXTURE( ArenaTest, parseDocument )
+{
+   const std::string text = "{\"a\":[1,2.5,\"s\",\"escaped \\u00e9\",null],\"b\":{\"c\":true},\"d\":\"\"}";
+   Json::Reader reader;
+   Json::Value expected;
+   JSONTEST_ASSERT( reader.parse( text, expected ) );
+
+   Json::Document doc;
+   for ( int pass = 0; pass < 3; ++pass )
+   {
+      JSONTEST_ASSERT( reader.parse( text, doc ) ) << reader.getFormattedErrorMessages();
+      JSONTEST_ASSERT( doc.root() == expected );
+      doc.root()["b"]["added"] = "value";
+      JSONTEST_ASSERT_EQUAL( 2u, doc.root()["b"].size() );
+      doc.clear();
+      JSONTEST_ASSERT( doc.root().isNull() );
+   }
+   JSONTEST_ASSERT( !reader.parse( std::string( "{\"a\":[1,]" ), doc ) );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// IncrementalReader
+// //////////////////////////////////////////////////////////////////
+
+struct IncrementalReaderTest : JsonTest::TestCase
+{
+   // Feeds input in chunks of chunkSize bytes and returns the documents written by FastWriter.
+   std::string readInChunks( const std::string &input, size_t chunkSize )
+   {
+      Json::IncrementalReader reader;
+      Json::FastWriter writer;
+      std::string documents;
+      Json::Value root;
+      for ( size_t offset = 0; offset < input.size(); offset += chunkSize )
+      {
+         JSONTEST_ASSERT( reader.feed( input.data() + offset, std::min( chunkSize, input.size() - offset ) ) )
+            << reader.getFormattedErrorMessages();
+         while ( reader.next( root ) )
+            documents += writer.write( root );
+      }
+      JSONTEST_ASSERT( reader.finish() ) << reader.getFormattedErrorMessages();
+      while ( reader.next( root ) )
+         documents += writer.write( root );
+      return documents;
+   }
+};
+
+
+JSONTEST_FIXTURE( IncrementalReaderTest, splitAnywhere )
+{
+   const std::string input = "{\"a\":\"x\\\"}{y\",\"b\":[1,{\"c\":null}]}\n"
+                             "/* comment } */ [true,false] // comment ]\n"
+                             "\"string\" 12 -3.5e2\r\n"
+                             "{}\n";
+   const std::string expected = "{\"a\":\"x\\\"}{y\",\"b\":[1,{\"c\":null}]}\n"
+                                "[true,false]\n"
+                                "\"string\"\n"
+                                "12\n"
+                                "-350.0\n"
+                                "{}\n";
+   for ( size_t chunkSize = 1; chunkSize <= input.size(); ++chunkSize )
+      JSONTEST_ASSERT_EQUAL( expected, readInChunks( input, chunkSize ) ) << "chunks of " << int( chunkSize );
+}
+
+
+JSONTEST_FIXTURE( IncrementalReaderTest, pendingNumberAtEnd )
+{
+   Json::IncrementalReader reader;
+   Json::Value root;
+   JSONTEST_ASSERT( reader.feed( "42", 2 ) );
+   JSONTEST_ASSERT( !reader.next( root ) );
+   JSONTEST_ASSERT( reader.finish() );
+   JSONTEST_ASSERT( reader.next( root ) );
+   JSONTEST_ASSERT_EQUAL( 42, root.asInt() );
+}
+
+
+JSONTEST_FIXTURE( IncrementalReaderTest, stopAtInvalidDocument )
+{
+   Json::IncrementalReader reader;
+   Json::Value root;
+   const std::string input = "[1] {\"a\":} [2]";
+   JSONTEST_ASSERT( !reader.feed( input.data(), input.size() ) );
+   JSONTEST_ASSERT( !reader.getFormattedErrorMessages().empty() );
+   JSONTEST_ASSERT( !reader.feed( "[3]", 3 ) );
+   JSONTEST_ASSERT( !reader.finish() );
+
+   reader.reset();
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages().empty() );
+   JSONTEST_ASSERT( reader.feed( "[3]", 3 ) );
+   JSONTEST_ASSERT( reader.next( root ) );
+   JSONTEST_ASSERT_EQUAL( 3, root[0u].asInt() );
+
+   JSONTEST_ASSERT( reader.feed( "{\"open\":[", 9 ) );
+   JSONTEST_ASSERT( !reader.finish() );
+}
+
+
+JSONTEST_FIXTURE( IncrementalReaderTest, largeStreams )
+{
+   // Small documents around large ones, so that the input is consumed both while
+   // documents are pending and while one is being received.
+   std::string input;
+   std::string expected;
+   for ( int index = 0; index < 2000; ++index )
+   {
+      input += "[" + std::to_string( index ) + "] ";
+      expected += "[" + std::to_string( index ) + "]\n";
+      if ( index % 500 == 0 )
+      {
+         std::string large = "{\"list\":[";
+         for ( int element = 0; element < 5000; ++element )
+            large += "\"element " + std::to_string( element ) + "\",";
+         large.back() = ']';
+         large += "}";
+         input += large + "\n";
+         expected += large + "\n";
+      }
+   }
+   for ( size_t chunkSize : { size_t(1), size_t(7), size_t(4096), input.size() } )
+      JSONTEST_ASSERT( readInChunks( input, chunkSize ) == expected ) << "chunks of " << int( chunkSize );
+}
+
+
+JSONTEST_FIXTURE( IncrementalReaderTest, parseWhileReceiving )
+{
+   // The error is reported by the chunk that contains it, before the document ends,
+   // and located from the beginning of the document although its lines were dropped.
+   const std::string input = "[0] {\"list\":[1,\n2,\n3,\n4,\n  x, 5]}";
+   for ( size_t chunkSize : { size_t(1), size_t(3), input.size() } )
+   {
+      Json::IncrementalReader reader;
+      size_t offset = 0;
+      while ( offset < input.size()  &&  reader.feed( input.data() + offset, std::min( chunkSize, input.size() - offset ) ) )
+         offset += chunkSize;
+      JSONTEST_ASSERT( offset < input.size() ) << "chunks of " << int( chunkSize );
+      JSONTEST_ASSERT( reader.getFormattedErrorMessages().find( "Line 5, Column 3" ) != std::string::npos )
+         << reader.getFormattedErrorMessages();
+   }
+
+   // A token split across many chunks is only read again once it is complete.
+   const std::string text( 200000, 'a' );
+   JSONTEST_ASSERT_EQUAL( "[\"" + text + "\",1]\n", readInChunks( "[\"" + text + "\", 1]", 1 ) );
+   JSONTEST_ASSERT_EQUAL( "{\"" + text + "\":true}\n", readInChunks( "{\"" + text + "\" : true}", 7 ) );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// LazyDocument
+// //////////////////////////////////////////////////////////////////
+
+struct LazyDocumentTest : JsonTest::TestCase
+{
+};
+
+
+JSONTEST_FIXTURE( LazyDocumentTest, lookups )
+{
+   const std::string text = "{ \"skip\" : [[1,2],{\"name\":0}], \"user\" : { \"name\" : \"J\\u00e9r\\u00f4me\", \"id\" : 3000000000 },"
+                            " \"list\" : [ 1.5, true, null, \"s\", [] ], \"a\\\"b\" : -7 }";
+   Json::LazyDocument doc;
+   JSONTEST_ASSERT( doc.parse( text ) ) << doc.getFormattedErrorMessages();
+   Json::LazyValue root = doc.root();
+   JSONTEST_ASSERT( root.isObject() );
+   JSONTEST_ASSERT_EQUAL( 4u, root.size() );
+   JSONTEST_ASSERT_EQUAL( std::string( "J\xc3\xa9r\xc3\xb4me" ), root["user"]["name"].asString() );
+   JSONTEST_ASSERT( root["user"]["id"].asLargestUInt() == 3000000000u );
+   JSONTEST_ASSERT_EQUAL( -7, int( root["a\"b"].asLargestInt() ) );
+   JSONTEST_ASSERT_EQUAL( 1.5, root["list"][0u].asDouble() );
+   JSONTEST_ASSERT( root["list"][1u].asBool() );
+   JSONTEST_ASSERT( root["list"][2u].isNull() );
+   JSONTEST_ASSERT( root["list"][4u].isArray() );
+   JSONTEST_ASSERT_EQUAL( 0u, root["list"][4u].size() );
+   JSONTEST_ASSERT_EQUAL( std::string( "[[1,2],{\"name\":0}]" ), std::string( root["skip"].text() ) );
+
+   // Missing values reference nothing and behave like null.
+   JSONTEST_ASSERT( !root["missing"] );
+   JSONTEST_ASSERT( !root["list"][5u] );
+   JSONTEST_ASSERT( !root["user"][0u] );
+   JSONTEST_ASSERT_EQUAL( std::string( "default" ), root["missing"]["deeper"].asString( "default" ) );
+   Json::LazyValue found;
+   JSONTEST_ASSERT( !root.tryGet( "missing", found ) );
+   JSONTEST_ASSERT( root.tryGet( "list", found ) && found.isArray() );
+}
+
+
+JSONTEST_FIXTURE( LazyDocumentTest, iterateAndDecode )
+{
+   const std::string text = "{\"b\":1,\"a\":[1,{\"c\":\"d\"}],\"e\\n\":null}";
+   Json::LazyDocument doc;
+   JSONTEST_ASSERT( doc.parse( text ) );
+   std::string keys;
+   Json::ArrayIndex expectedIndex = 0;
+   for ( Json::LazyValue::const_iterator it = doc.root().begin(); it != doc.root().end(); ++it )
+   {
+      keys += it.key() + ",";
+      JSONTEST_ASSERT_EQUAL( expectedIndex++, it.index() );
+   }
+   JSONTEST_ASSERT_EQUAL( std::string( "b,a,e\n," ), keys );
+
+   Json::Reader reader;
+   Json::Value expected;
+   JSONTEST_ASSERT( reader.parse( text, expected ) );
+   JSONTEST_ASSERT( doc.root().toValue() == expected );
+   JSONTEST_ASSERT( doc.root()["a"].toValue() == expected["a"] );
+}
+
+
+JSONTEST_FIXTURE( LazyDocumentTest, invalidDocuments )
+{
+   Json::LazyDocument doc;
+   JSONTEST_ASSERT( !doc.parse( std::string( "{\"a\":[1,2}" ) ) );
+   JSONTEST_ASSERT( !doc.getFormattedErrorMessages().empty() );
+   JSONTEST_ASSERT( !doc.root() );
+   JSONTEST_ASSERT( !doc.parse( std::string( "[1] 2" ) ) );
+   JSONTEST_ASSERT( !doc.parse( std::string( "[1] // comment" ) ) );
+
+   // Syntax errors inside balanced brackets are reported when the value is decoded.
+   JSONTEST_ASSERT( doc.parse( std::string( "{\"good\":1,\"bad\":[1,,2]}" ) ) );
+   JSONTEST_ASSERT_EQUAL( 1, int( doc.root()["good"].asLargestInt() ) );
+   Json::Value value;
+   JSONTEST_ASSERT( !doc.root()["bad"].toValue( value ) );
+   JSONTEST_ASSERT( !doc.getFormattedErrorMessages().empty() );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// BindingReader and BindingWriter
+// //////////////////////////////////////////////////////////////////
+
+struct BoundAddress
+{
+   std::string city;
+   int zip = 0;
+};
+
+struct BoundPerson
+{
+   std::string name;
+   Json::Int64 id = 0;
+   unsigned int age = 0;
+   double score = 0;
+   bool active = false;
+   std::vector<BoundAddress> addresses;
+   std::optional<std::string> email;
+   std::map<std::string, std::vector<int> > tags;
+   int kept = 5;
+};
+
+template <> class Json::Binding<BoundAddress>
+{
+public:
+   static Json::Fields fields() { return { JSONCPP_FIELD( BoundAddress, city ), JSONCPP_FIELD( BoundAddress, zip ) }; }
+};
+
+template <> class Json::Binding<BoundPerson>
+{
+public:
+   static Json::Fields fields()
+   {
+      return { JSONCPP_FIELD( BoundPerson, name ), Json::field<&BoundPerson::id>( "personId" ),
+               JSONCPP_FIELD( BoundPerson, age ), JSONCPP_FIELD( BoundPerson, score ),
+               JSONCPP_FIELD( BoundPerson, active ), JSONCPP_FIELD( BoundPerson, addresses ),
+               JSONCPP_FIELD( BoundPerson, email ), JSONCPP_FIELD( BoundPerson, tags ),
+               Json::field<&BoundPerson::kept>( "kept", Json::fieldOptional ) };
+   }
+};
+
+struct BindingTest : JsonTest::TestCase
+{
+   void checkRejected( const std::string &document, const std::string &pointer )
+   {
+      Json::BindingReader reader;
+      BoundPerson person;
+      JSONTEST_ASSERT( !reader.parse( document, person ) ) << document;
+      const std::string errors = reader.getFormattedErrorMessages();
+      JSONTEST_ASSERT( errors.find( pointer ) != std::string::npos ) << errors;
+   }
+};
+
+
+JSONTEST_FIXTURE( BindingTest, readAndWrite )
+{
+   const std::string document = "{\"personId\":3000000000,\"name\":\"Ann\",\"unknown\":{\"x\":[1]},\"age\":40,"
+                                "\"score\":2,\"active\":true,\"addresses\":[{\"zip\":1e3,\"city\":\"Paris\"}],"
+                                "\"tags\":{\"a\":[1,2],\"b\":[]}}";
+   Json::BindingReader reader;
+   BoundPerson person;
+   JSONTEST_ASSERT( reader.parse( document, person ) ) << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT_EQUAL( std::string( "Ann" ), person.name );
+   JSONTEST_ASSERT( person.id == 3000000000LL );
+   JSONTEST_ASSERT_EQUAL( 40u, person.age );
+   JSONTEST_ASSERT_EQUAL( 2.0, person.score );
+   JSONTEST_ASSERT( person.active );
+   JSONTEST_ASSERT_EQUAL( 1, int( person.addresses.size() ) );
+   JSONTEST_ASSERT_EQUAL( std::string( "Paris" ), person.addresses[0].city );
+   JSONTEST_ASSERT_EQUAL( 1000, person.addresses[0].zip );
+   JSONTEST_ASSERT( !person.email );
+   JSONTEST_ASSERT_EQUAL( 2, int( person.tags["a"].size() ) );
+   JSONTEST_ASSERT_EQUAL( 5, person.kept );
+
+   // The written document reads back into the same Value.
+   const std::string written = Json::BindingWriter().write( person );
+   Json::Reader valueReader;
+   Json::Value writtenValue;
+   Json::Value expected;
+   JSONTEST_ASSERT( valueReader.parse( written, writtenValue ) ) << written;
+   JSONTEST_ASSERT( valueReader.parse( document, expected ) );
+   expected.removeMember( "unknown" );
+   expected["kept"] = 5;
+   expected["score"] = 2.0;
+   expected["addresses"][0u]["zip"] = 1000;
+   JSONTEST_ASSERT( writtenValue == expected ) << written;
+
+   person.email = "ann@example.com";
+   BoundPerson copy;
+   JSONTEST_ASSERT( reader.parse( Json::BindingWriter().write( person ), copy ) ) << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT_EQUAL( std::string( "ann@example.com" ), copy.email.value_or( "" ) );
+}
+
+
+JSONTEST_FIXTURE( BindingTest, rejectMismatches )
+{
+   const std::string valid = "\"name\":\"Ann\",\"personId\":1,\"age\":1,\"score\":1,\"active\":false,\"addresses\":[],\"tags\":{}";
+   checkRejected( "{\"name\":\"Ann\"}", "personId" );
+   checkRejected( "{" + valid + ",\"age\":-1}", "/age" );
+   checkRejected( "{" + valid + ",\"age\":4294967296}", "/age" );
+   checkRejected( "{" + valid + ",\"personId\":1.5}", "/personId" );
+   checkRejected( "{" + valid + ",\"addresses\":[{\"city\":\"P\",\"zip\":\"x\"}]}", "/addresses/0/zip" );
+   checkRejected( "{" + valid + ",\"addresses\":[{\"city\":\"P\"}]}", "zip" );
+   checkRejected( "{" + valid + ",\"tags\":{\"a\":[true]}}", "/tags/a/0" );
+   checkRejected( "[]", "" );
+   checkRejected( "{" + valid + ",}", "" );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// In-situ parsing
+// //////////////////////////////////////////////////////////////////
+
+struct InSituTest : JsonTest::TestCase
+{
+   // Text of a string literal that may contain '\0'.
+   template <size_t N>
+   static std::string literal( const char ( &text )[N] )
+   {
+      return std::string( text, N - 1 );
+   }
+
+   // Parses document with parse() and parseInSitu(), and checks that the roots are equal.
+   void checkSameRoot( const std::string &document )
+   {
+      Json::Reader reader;
+      Json::Value expected;
+      JSONTEST_ASSERT( reader.parse( document, expected ) ) << reader.getFormattedErrorMessages();
+      std::vector<char> buffer( document.begin(), document.end() );
+      Json::Value inSitu;
+      JSONTEST_ASSERT( reader.parseInSitu( buffer.data(), buffer.data() + buffer.size(), inSitu ) )
+         << reader.getFormattedErrorMessages();
+      JSONTEST_ASSERT( inSitu == expected ) << document;
+      JSONTEST_ASSERT( Json::FastWriter().write( inSitu ) == Json::FastWriter().write( expected ) ) << document;
+   }
+};
+
+
+JSONTEST_FIXTURE( InSituTest, sameRootAsParse )
+{
+   checkSameRoot( "[\"\",\"short\",\"eleven char\",\"twelve chars\",\"a string longer than the inline buffer\"]" );
+   checkSameRoot( "[\"esc\\\"aped\",\"\\u00e9t\\u00e9 \\n\\t a string longer than the inline buffer\",\"\\u0000\"]" );
+   checkSameRoot( literal( "[\"a\0b\",\"a long string with a raw \0 inside\"]" ) );
+   checkSameRoot( literal( "{\"k\0ey\":\"v\0\",\"key\":{\"nested\":[\"x\"]}}" ) );
+   checkSameRoot( "\"root string\"" );
+}
+
+
+JSONTEST_FIXTURE( InSituTest, referencesTheDocument )
+{
+   std::string document = "[\"a string longer than the inline buffer\",\"escaped \\n string longer than the buffer\"]";
+   Json::Reader reader;
+   Json::Value root;
+   JSONTEST_ASSERT( reader.parseInSitu( &document[0], &document[0] + document.size(), root ) );
+   const char *unescaped = root[0u].asCString();
+   const char *escaped = root[1u].asCString();
+   JSONTEST_ASSERT( unescaped > document.data() && unescaped < document.data() + document.size() );
+   JSONTEST_ASSERT( !( escaped > document.data() && escaped < document.data() + document.size() ) );
+
+   // Copies duplicate the strings that reference the document.
+   Json::Value copy = root;
+   document.assign( document.size(), 'x' );
+   JSONTEST_ASSERT_EQUAL( std::string( "a string longer than the inline buffer" ), copy[0u].asString() );
+   JSONTEST_ASSERT_EQUAL( std::string( "escaped \n string longer than the buffer" ), copy[1u].asString() );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// Path
+// //////////////////////////////////////////////////////////////////
+
+struct PathTest : ParsingTestCase
+{
+};
+
+
+JSONTEST_FIXTURE( PathTest, pointers )
+{
+   const Json::Value root = parse( "{\"a/b\":1,\"m~n\":2,\"~1\":3,\"\":4,\"list\":[10,11,12],"
+                                   "\"object\":{\"0\":\"zero\",\"01\":\"leading zero\",\"-\":\"dash\"}}" );
+   JSONTEST_ASSERT( Json::Path( "" ).find( root ) == &root );
+   JSONTEST_ASSERT( Json::Path( "" ).size() == 0 );
+   JSONTEST_ASSERT( Json::Path( "." ).find( root ) == &root );
+   JSONTEST_ASSERT_EQUAL( 1, Json::Path( "/a~1b" ).resolve( root ).asInt() );
+   JSONTEST_ASSERT_EQUAL( 2, Json::Path( "/m~0n" ).resolve( root ).asInt() );
+   // "~01" is '~' then '1', not '/'.
+   JSONTEST_ASSERT_EQUAL( 3, Json::Path( "/~01" ).resolve( root ).asInt() );
+   // "/" is the member named "".
+   JSONTEST_ASSERT_EQUAL( 4, Json::Path( "/" ).resolve( root ).asInt() );
+
+   JSONTEST_ASSERT_EQUAL( 10, Json::Path( "/list/0" ).resolve( root ).asInt() );
+   JSONTEST_ASSERT_EQUAL( 12, Json::Path( "/list/2" ).resolve( root ).asInt() );
+   JSONTEST_ASSERT( Json::Path( "/list/3" ).find( root ) == nullptr );
+   JSONTEST_ASSERT( Json::Path( "/list/01" ).find( root ) == nullptr );
+   JSONTEST_ASSERT( Json::Path( "/list/-" ).find( root ) == nullptr );
+   JSONTEST_ASSERT( Json::Path( "/list/" ).find( root ) == nullptr );
+   JSONTEST_ASSERT( Json::Path( "/list/1a" ).find( root ) == nullptr );
+   JSONTEST_ASSERT( Json::Path( "/list/4294967295" ).find( root ) == nullptr );
+   JSONTEST_ASSERT( Json::Path( "/list/99999999999999999999" ).find( root ) == nullptr );
+   // Tokens are member names in objects, even if they look like indices.
+   JSONTEST_ASSERT_EQUAL( std::string( "zero" ), Json::Path( "/object/0" ).resolve( root ).asString() );
+   JSONTEST_ASSERT_EQUAL( std::string( "leading zero" ), Json::Path( "/object/01" ).resolve( root ).asString() );
+   JSONTEST_ASSERT_EQUAL( std::string( "dash" ), Json::Path( "/object/-" ).resolve( root ).asString() );
+   JSONTEST_ASSERT( Json::Path( "/a~1b/0" ).find( root ) == nullptr );
+   JSONTEST_ASSERT( Json::Path( "/missing" ).resolve( root, Json::Value( 5 ) ) == Json::Value( 5 ) );
+
+   for ( const char *invalid : { "/a~", "/a~2", "/~/list", "/list/~x" } )
+   {
+      JSONTEST_ASSERT( !Json::Path( invalid ).isValid() ) << invalid;
+   }
+   JSONTEST_ASSERT( Json::Path( "/a~1b" ).isValid() );
+   JSONTEST_ASSERT( Json::Path( "/a~1b" ).size() == 1 );
+   JSONTEST_ASSERT( Json::Path( "/list/0" ).size() == 2 );
+}
+
+
+JSONTEST_FIXTURE( PathTest, makePointers )
+{
+   Json::Value root;
+   Json::Path( "/list/-" ).make( root ) = 1;
+   JSONTEST_ASSERT( root == parse( "{\"list\":{\"-\":1}}" ) );
+
+   root = parse( "{\"list\":[]}" );
+   Json::Path( "/list/-" ).make( root ) = 1;
+   Json::Path( "/list/-" ).make( root ) = 2;
+   Json::Path( "/list/3" ).make( root ) = 4;
+   Json::Path( "/a~1b/m~0n" ).make( root ) = "escaped";
+   JSONTEST_ASSERT( root == parse( "{\"list\":[1,2,null,4],\"a/b\":{\"m~n\":\"escaped\"}}" ) );
+
+   Json::Value *found = Json::Path( "/list/1" ).find( root );
+   JSONTEST_ASSERT( found != nullptr );
+   *found = 3;
+   JSONTEST_ASSERT_EQUAL( 3, root["list"][1u].asInt() );
+
+   Json::Path classic( ".list[%].%", Json::ArrayIndex( 0 ), std::string( "name" ) );
+   JSONTEST_ASSERT( classic.isValid() );
+   JSONTEST_ASSERT( classic.size() == 3 );
+   JSONTEST_ASSERT( classic.find( std::as_const( root ) ) == nullptr );
+   Json::Path arguments( ".a/b.%", std::string( "m~n" ) );
+   JSONTEST_ASSERT( arguments.isValid() );
+   JSONTEST_ASSERT_EQUAL( std::string( "escaped" ), arguments.resolve( root ).asString() );
+   JSONTEST_ASSERT( !Json::Path( ".[%]", std::string( "key" ) ).isValid() );
+   JSONTEST_ASSERT( !Json::Path( ".%" ).isValid() );
+   JSONTEST_ASSERT( !Json::Path( ".[0" ).isValid() );
+}
+
+
+JSONTEST_FIXTURE( PathTest, pathSet )
+{
+   const Json::Value root = parse( "{\"a\":{\"b\":[1,{\"c\":2}],\"d\":3},\"e\":[4]}" );
+   Json::PathSet set;
+   JSONTEST_ASSERT( set.add( Json::Path( "/a/b/1/c" ) ) == 0 );
+   JSONTEST_ASSERT( set.add( Json::Path( ".a.d" ) ) == 1 );
+   JSONTEST_ASSERT( set.add( Json::Path( "/a/b/0" ) ) == 2 );
+   JSONTEST_ASSERT( set.add( Json::Path( "/e/1" ) ) == 3 );
+   JSONTEST_ASSERT( set.add( Json::Path( "" ) ) == 4 );
+   // The same path twice.
+   JSONTEST_ASSERT( set.add( Json::Path( "/a/b/0" ) ) == 5 );
+   JSONTEST_ASSERT( set.add( Json::Path( "/a" ) ) == 6 );
+   JSONTEST_ASSERT( set.size() == 7 );
+
+   std::vector<const Json::Value *> results( 1, &root );
+   set.find( root, results );
+   JSONTEST_ASSERT( results.size() == 7 );
+   JSONTEST_ASSERT_EQUAL( 2, results[0]->asInt() );
+   JSONTEST_ASSERT_EQUAL( 3, results[1]->asInt() );
+   JSONTEST_ASSERT_EQUAL( 1, results[2]->asInt() );
+   JSONTEST_ASSERT( results[3] == nullptr );
+   JSONTEST_ASSERT( results[4] == &root );
+   JSONTEST_ASSERT( results[5] == results[2] );
+   JSONTEST_ASSERT( results[6] == &std::as_const( root ).get( "a" ) );
+
+   // The results of the set are those of the paths evaluated one by one.
+   const Json::Value other = parse( "{\"a\":{\"b\":{\"0\":5,\"1\":{\"c\":6}}},\"e\":[7,8]}" );
+   set.find( other, results );
+   JSONTEST_ASSERT_EQUAL( 6, results[0]->asInt() );
+   JSONTEST_ASSERT( results[1] == nullptr );
+   JSONTEST_ASSERT( results[2] == Json::Path( "/a/b/0" ).find( other ) );
+   JSONTEST_ASSERT_EQUAL( 8, results[3]->asInt() );
+
+   Json::PathSet empty;
+   empty.find( root, results );
+   JSONTEST_ASSERT( results.empty() );
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// Reader
+// //////////////////////////////////////////////////////////////////
+
+struct ReaderTest : JsonTest::TestCase
+{
+   static Json::Features withMaxDepth( unsigned int maxDepth )
+   {
+      Json::Features features;
+      features.maxDepth_ = maxDepth;
+      return features;
+   }
+
+   static Json::Features withStrictUtf8()
+   {
+      Json::Features features;
+      features.strictUtf8_ = true;
+      return features;
+   }
+
+   static std::string nested( const std::string &open, int depth, const std::string &value, const std::string &close )
+   {
+      std::string document;
+      for ( int level = 0; level < depth; ++level )
+         document += open;
+      document += value;
+      for ( int level = 0; level < depth; ++level )
+         document += close;
+      return document;
+   }
+};
+
+
+JSONTEST_FIXTURE( ReaderTest, maxDepth )
+{
+   Json::Reader reader( withMaxDepth( 3 ) );
+   Json::Value root;
+   JSONTEST_ASSERT( reader.parse( "[[[1]]]", root ) ) << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT_EQUAL( 1, root[0u][0u][0u].asInt() );
+   JSONTEST_ASSERT( reader.parse( "{\"a\":[{\"b\":1}]}", root ) ) << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT( reader.parse( "[[1],[2],{\"a\":[3]}]", root ) ) << reader.getFormattedErrorMessages();
+
+   JSONTEST_ASSERT( !reader.parse( "[[[[1]]]]", root ) );
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages().find( "maximum nesting depth" ) != std::string::npos )
+      << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT( reader.getStructuredErrors().size() == 1 );
+   JSONTEST_ASSERT( reader.getStructuredErrors()[0].offsetStart_ == 3 );
+   JSONTEST_ASSERT( !reader.parse( "{\"a\":{\"b\":{\"c\":{}}}}", root ) );
+   JSONTEST_ASSERT( !reader.parse( "[[1],[[[2]]]]", root ) );
+
+   Json::StrictReader strict( withMaxDepth( 2 ) );
+   JSONTEST_ASSERT( strict.parse( "[[1]]", root ) ) << strict.getFormattedErrorMessages();
+   JSONTEST_ASSERT( !strict.parse( "[[[1]]]", root ) );
+
+   // Destroying a tree this deep would recurse as deeply: parse into a Handler.
+   Json::Reader raised( withMaxDepth( 100000 ) );
+   Json::Handler ignored;
+   const std::string deepArrays = nested( "[", 100000, "1", "]" );
+   JSONTEST_ASSERT( raised.parse( deepArrays.data(), deepArrays.data() + deepArrays.size(), ignored ) )
+      << raised.getFormattedErrorMessages();
+   const std::string deepObjects = nested( "{\"a\":", 100000, "1", "}" );
+   JSONTEST_ASSERT( raised.parse( deepObjects.data(), deepObjects.data() + deepObjects.size(), ignored ) )
+      << raised.getFormattedErrorMessages();
+   const std::string tooDeep = nested( "[", 100001, "1", "]" );
+   JSONTEST_ASSERT( !raised.parse( tooDeep.data(), tooDeep.data() + tooDeep.size(), ignored ) );
+   JSONTEST_ASSERT( raised.getFormattedErrorMessages().find( "(100000)" ) != std::string::npos )
+      << raised.getFormattedErrorMessages();
+}
+
+
+JSONTEST_FIXTURE( ReaderTest, deepDocuments )
+{
+   // Only the explicit stack of the reader grows: the call stack does not.
+   const std::string deep( 100000, '[' );
+   Json::Reader reader;
+   Json::Value root;
+   JSONTEST_ASSERT( !reader.parse( deep, root ) );
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages().find( "(1000)" ) != std::string::npos )
+      << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT( !reader.parse( nested( "[", 1001, "", "]" ), root ) );
+   JSONTEST_ASSERT( reader.parse( nested( "[", 1000, "", "]" ), root ) ) << reader.getFormattedErrorMessages();
+
+   Json::Features failFast;
+   failFast.failFast_ = true;
+   Json::Reader fast( failFast );
+   JSONTEST_ASSERT( !fast.parse( deep, root ) );
+   JSONTEST_ASSERT( fast.getStructuredErrors().size() == 1 );
+
+   // Within the limit, the unclosed arrays are reported at the end of the document.
+   Json::Reader raised( withMaxDepth( 200000 ) );
+   Json::Handler ignored;
+   JSONTEST_ASSERT( !raised.parse( deep.data(), deep.data() + deep.size(), ignored ) );
+   JSONTEST_ASSERT( raised.getFormattedErrorMessages().find( "Line 1, Column 100001" ) != std::string::npos )
+      << raised.getFormattedErrorMessages();
+
+   // The incremental reader stops buffering a document once it is too deep.
+   Json::IncrementalReader incremental;
+   JSONTEST_ASSERT( !incremental.feed( deep.data(), deep.size() ) );
+   JSONTEST_ASSERT( incremental.getFormattedErrorMessages().find( "maximum nesting depth" ) != std::string::npos )
+      << incremental.getFormattedErrorMessages();
+   incremental.reset();
+   for ( size_t fed = 0; fed < 1000; fed += 100 )
+      JSONTEST_ASSERT( incremental.feed( deep.data(), 100 ) );
+   JSONTEST_ASSERT( !incremental.feed( deep.data(), 100 ) );
+   JSONTEST_ASSERT( !incremental.feed( "]", 1 ) );
+   incremental.reset();
+   const std::string tooDeep = nested( "[", 1001, "", "]" );
+   JSONTEST_ASSERT( !incremental.feed( tooDeep.data(), tooDeep.size() ) );
+   JSONTEST_ASSERT( incremental.getFormattedErrorMessages().find( "maximum nesting depth" ) != std::string::npos )
+      << incremental.getFormattedErrorMessages();
+}
+
+
+JSONTEST_FIXTURE( ReaderTest, reuseAfterFailure )
+{
+   Json::Reader reader( withMaxDepth( 3 ) );
+   Json::Value root;
+   for ( int round = 0; round < 3; ++round )
+   {
+      JSONTEST_ASSERT( !reader.parse( "[[[[[[1]]]]]]", root ) );
+      JSONTEST_ASSERT( !reader.getFormattedErrorMessages().empty() );
+      JSONTEST_ASSERT( reader.parse( "[[[1]]]", root ) ) << reader.getFormattedErrorMessages();
+      JSONTEST_ASSERT( reader.getFormattedErrorMessages().empty() );
+      JSONTEST_ASSERT( reader.getStructuredErrors().empty() );
+      JSONTEST_ASSERT_EQUAL( 1, root[0u][0u][0u].asInt() );
+      JSONTEST_ASSERT( !reader.parse( "[1,", root ) );
+      JSONTEST_ASSERT( reader.parse( "{\"a\":[1,2]}", root ) ) << reader.getFormattedErrorMessages();
+      JSONTEST_ASSERT( root["a"].size() == 2 );
+   }
+}
+
+JSONTEST_FIXTURE( ReaderTest, structuredErrors )
+{
+   Json::Reader reader;
+   Json::Value root;
+   JSONTEST_ASSERT( reader.parse( "{\"a\":1}", root ) );
+   JSONTEST_ASSERT( reader.getStructuredErrors().empty() );
+
+   const std::string document = "{\n  \"a\" : 1,\r\n  \"b\" : tru,\r  \"c\" : \"\\x\"\n}";
+   JSONTEST_ASSERT( !reader.parse( document, root ) );
+   std::vector<Json::StructuredError> errors = reader.getStructuredErrors();
+   JSONTEST_ASSERT( errors.size() == 1 );
+   JSONTEST_ASSERT( errors[0].offsetStart_ == document.find( "tru" ) );
+   JSONTEST_ASSERT( errors[0].offsetLimit_ >= errors[0].offsetStart_ );
+   JSONTEST_ASSERT_EQUAL( 3, errors[0].line_ );
+   JSONTEST_ASSERT_EQUAL( 9, errors[0].column_ );
+   JSONTEST_ASSERT( !errors[0].message_.empty() );
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages().find( "Line 3, Column 9" ) != std::string::npos )
+      << reader.getFormattedErrorMessages();
+
+   const std::string misplaced = "[\n[1,,2],\n[\"\\u12\"],\n[1 2]\n]";
+   JSONTEST_ASSERT( !reader.parse( misplaced, root ) );
+   errors = reader.getStructuredErrors();
+   JSONTEST_ASSERT( errors.size() == 1 );
+   JSONTEST_ASSERT( errors[0].offsetStart_ == misplaced.find( ",," ) + 1 );
+   JSONTEST_ASSERT( errors[0].offsetLimit_ == errors[0].offsetStart_ + 1 );
+   JSONTEST_ASSERT_EQUAL( 2, errors[0].line_ );
+   JSONTEST_ASSERT_EQUAL( 4, errors[0].column_ );
+
+   JSONTEST_ASSERT( !reader.parseFile( "missing/file.json", root ) );
+   errors = reader.getStructuredErrors();
+   JSONTEST_ASSERT( errors.size() == 1 );
+   JSONTEST_ASSERT( errors[0].offsetStart_ == 0 );
+   JSONTEST_ASSERT_EQUAL( 1, errors[0].line_ );
+}
+
+
+JSONTEST_FIXTURE( ReaderTest, errorsOutliveTheDocument )
+{
+   Json::Reader reader;
+   Json::Value root;
+   std::string expectedMessages;
+   size_t expectedOffset;
+   {
+      std::vector<char> document( 4096, ' ' );
+      const std::string text = "{\n\"a\":[1,2,\n\"\\uZZZZ\"]}";
+      std::copy( text.begin(), text.end(), document.begin() );
+      JSONTEST_ASSERT( !reader.parse( document.data(), document.data() + document.size(), root ) );
+      expectedMessages = reader.getFormattedErrorMessages();
+      expectedOffset = reader.getStructuredErrors()[0].offsetStart_;
+      // Overwritten, then freed: the errors do not read the document again.
+      std::fill( document.begin(), document.end(), '\n' );
+   }
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages() == expectedMessages ) << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages().find( "Line 3" ) != std::string::npos );
+   JSONTEST_ASSERT( reader.getStructuredErrors().size() == 1 );
+   JSONTEST_ASSERT( reader.getStructuredErrors()[0].offsetStart_ == expectedOffset );
+   JSONTEST_ASSERT_EQUAL( 3, reader.getStructuredErrors()[0].line_ );
+
+   // A temporary string is not copied either.
+   JSONTEST_ASSERT( !reader.parse( std::string( "[1,\n,2]" ), root ) );
+   JSONTEST_ASSERT( reader.getStructuredErrors()[0].offsetStart_ == 4 );
+   JSONTEST_ASSERT_EQUAL( 2, reader.getStructuredErrors()[0].line_ );
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages().find( "Line 2, Column 1" ) != std::string::npos )
+      << reader.getFormattedErrorMessages();
+}
+
+
+JSONTEST_FIXTURE( ReaderTest, failFast )
+{
+   Json::Features failFast;
+   failFast.failFast_ = true;
+   const char *documents[] = {
+      "[1,2,",
+      "{\"a\":[1,,2],\"b\":3}",
+      "[[1,2],[3,}],[4]]",
+      "{\"a\":\"\\q\"}",
+      "[1 2]",
+      "{\"a\" 1}",
+      "[\"\\ud800\"]",
+      "  \n  nul",
+      "[[[[[[[[[[[[[[[[[[[[[[[",
+   };
+   for ( const char *document : documents )
+   {
+      Json::Reader normal;
+      Json::Reader fast( failFast );
+      Json::Value root;
+      JSONTEST_ASSERT( !normal.parse( document, root ) ) << document;
+      JSONTEST_ASSERT( !fast.parse( document, root ) ) << document;
+      const std::vector<Json::StructuredError> expected = normal.getStructuredErrors();
+      const std::vector<Json::StructuredError> errors = fast.getStructuredErrors();
+      JSONTEST_ASSERT( errors.size() == expected.size() ) << document;
+      for ( size_t index = 0; index < errors.size() && index < expected.size(); ++index )
+      {
+         JSONTEST_ASSERT( errors[index].offsetStart_ == expected[index].offsetStart_ ) << document;
+         JSONTEST_ASSERT( errors[index].offsetLimit_ == expected[index].offsetLimit_ ) << document;
+         JSONTEST_ASSERT_EQUAL( expected[index].line_, errors[index].line_ );
+         JSONTEST_ASSERT_EQUAL( expected[index].column_, errors[index].column_ );
+         JSONTEST_ASSERT_EQUAL( expected[index].message_, errors[index].message_ );
+      }
+      JSONTEST_ASSERT_EQUAL( normal.getFormattedErrorMessages(), fast.getFormattedErrorMessages() );
+   }
+}
+
+JSONTEST_FIXTURE( ReaderTest, strictUtf8 )
+{
+   const char *valid[] = {
+      "\xC2\x80", "\xC3\xA9", "\xDF\xBF", "\xE0\xA0\x80", "\xE2\x82\xAC", "\xED\x9F\xBF", "\xEE\x80\x80",
+      "\xEF\xBF\xBF", "\xF0\x90\x80\x80", "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF",
+   };
+   const char *invalid[] = {
+      // Overlong.
+      "\xC0\x80", "\xC1\xBF", "\xE0\x80\x80", "\xE0\x9F\xBF", "\xF0\x80\x80\x80", "\xF0\x8F\xBF\xBF",
+      // Surrogates.
+      "\xED\xA0\x80", "\xED\xAF\xBF", "\xED\xB0\x80", "\xED\xBF\xBF",
+      // Above U+10FFFF.
+      "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xF7\xBF\xBF\xBF", "\xF8\x88\x80\x80\x80", "\xFE", "\xFF",
+      // Truncated, or continuations without a lead byte.
+      "\xC3", "\xE2\x82", "\xF0\x9F\x98", "\xE2\x82" "a", "\xF0\x9F" "ab", "\x80", "\xBF", "\xC3\xA9\xA9",
+   };
+   Json::Reader strict( withStrictUtf8() );
+   Json::Reader lenient;
+   Json::Value root;
+   // Each sequence at every position of the blocks of the vectorized validation.
+   for ( size_t position = 0; position < 40; ++position )
+   {
+      for ( size_t tail : { size_t( 0 ), size_t( 1 ), size_t( 37 ) } )
+      {
+         const std::string before( position, 'a' );
+         const std::string after( tail, 'b' );
+         for ( const char *sequence : valid )
+         {
+            const std::string text = before + sequence + after;
+            JSONTEST_ASSERT( strict.parse( "[\"" + text + "\"]", root ) ) << strict.getFormattedErrorMessages();
+            JSONTEST_ASSERT( root[0u].asString() == text );
+            JSONTEST_ASSERT( strict.parse( "{\"" + text + "\":1}", root ) ) << strict.getFormattedErrorMessages();
+            JSONTEST_ASSERT( root.isMember( text ) );
+         }
+         for ( const char *sequence : invalid )
+         {
+            const std::string text = before + sequence + after;
+            JSONTEST_ASSERT( !strict.parse( "[\"" + text + "\"]", root ) ) << int( position ) << " " << int( tail );
+            JSONTEST_ASSERT( strict.getFormattedErrorMessages().find( "Invalid UTF-8" ) != std::string::npos )
+               << strict.getFormattedErrorMessages();
+            JSONTEST_ASSERT( strict.getStructuredErrors()[0].offsetStart_ == 1 );
+            JSONTEST_ASSERT( !strict.parse( "{\"" + text + "\":1}", root ) ) << int( position ) << " " << int( tail );
+            JSONTEST_ASSERT( lenient.parse( "[\"" + text + "\"]", root ) ) << lenient.getFormattedErrorMessages();
+            JSONTEST_ASSERT( root[0u].asString() == text );
+         }
+      }
+   }
+   // The invalid byte is located: "See Line 1, Column ..." points at it.
+   JSONTEST_ASSERT( !strict.parse( "[\"abc\xC3\xA9\xED\xA0\x80\"]", root ) );
+   JSONTEST_ASSERT( strict.getFormattedErrorMessages().find( "See Line 1, Column 8 " ) != std::string::npos )
+      << strict.getFormattedErrorMessages();
+   // Escaped strings are validated too.
+   JSONTEST_ASSERT( !strict.parse( "[\"\\n\xC0\x80\"]", root ) );
+   JSONTEST_ASSERT( strict.parse( "[\"\\n\xC3\xA9\"]", root ) ) << strict.getFormattedErrorMessages();
+}
+
+
+JSONTEST_FIXTURE( ReaderTest, strictUtf8Escapes )
+{
+   Json::Reader strict( withStrictUtf8() );
+   Json::Reader lenient;
+   Json::Value root;
+   JSONTEST_ASSERT( strict.parse( "[\"\\ud83d\\ude00\"]", root ) ) << strict.getFormattedErrorMessages();
+   JSONTEST_ASSERT( root[0u].asString() == "\xF0\x9F\x98\x80" );
+   JSONTEST_ASSERT( strict.parse( "[\"\\udbff\\udfff\"]", root ) ) << strict.getFormattedErrorMessages();
+   JSONTEST_ASSERT( root[0u].asString() == "\xF4\x8F\xBF\xBF" );
+   JSONTEST_ASSERT( strict.parse( "[\"\\ud7ff\\ue000\"]", root ) ) << strict.getFormattedErrorMessages();
+
+   for ( const char *unpaired : { "[\"\\ud800\"]", "[\"\\ud800abcdef\"]", "[\"\\ud800\\u0041\"]", "[\"\\udbff\\ud800\"]",
+                                  "[\"\\udc00\"]", "[\"\\udfff\\udc00\"]", "{\"\\udc00\":1}" } )
+   {
+      JSONTEST_ASSERT( !strict.parse( unpaired, root ) ) << unpaired;
+   }
+   // Without strictUtf8_, a lone low surrogate is encoded as is.
+   JSONTEST_ASSERT( lenient.parse( "[\"\\udc00\"]", root ) ) << lenient.getFormattedErrorMessages();
+   JSONTEST_ASSERT( root[0u].asString() == "\xED\xB0\x80" );
+}
+
+JSONTEST_FIXTURE( ReaderTest, strictReader )
+{
+   const char *rejected[] = {
+      "// comment\n[1]", "/* comment */ {}", "[1 /* comment */]", "{\"a\":1 // comment\n}",
+      "1", "-2.5", "\"string\"", "null", "true", "false", " \n 7 ",
+   };
+   for ( const char *document : rejected )
+   {
+      Json::Reader reader;
+      Json::Value root;
+      JSONTEST_ASSERT( reader.parse( document, root ) ) << document << ": " << reader.getFormattedErrorMessages();
+
+      // Whatever the features passed to it, StrictReader behaves like Features::strictMode().
+      Json::Reader strictMode( Json::Features::strictMode() );
+      JSONTEST_ASSERT( !strictMode.parse( document, root ) ) << document;
+      for ( const Json::Features &features : { Json::Features::strictMode(), Json::Features::all() } )
+      {
+         Json::StrictReader strict( features );
+         JSONTEST_ASSERT( !strict.parse( document, root ) ) << document;
+         JSONTEST_ASSERT_EQUAL( strictMode.getFormattedErrorMessages(), strict.getFormattedErrorMessages() );
+      }
+   }
+
+   Json::StrictReader strict;
+   Json::Value root;
+   JSONTEST_ASSERT( !strict.parse( "42", root ) );
+   JSONTEST_ASSERT( strict.getFormattedErrorMessages().find( "must be either an array or an object" ) != std::string::npos )
+      << strict.getFormattedErrorMessages();
+
+   const char *accepted[] = { "[]", "{}", " [1, \"two\", {\"three\": [null, true, false, -4.5e1]}] ", "{\"a\":{\"b\":[]}}" };
+   for ( const char *document : accepted )
+   {
+      Json::Reader reader;
+      Json::Value expected;
+      JSONTEST_ASSERT( reader.parse( document, expected ) ) << document;
+      JSONTEST_ASSERT( strict.parse( document, root ) ) << document << ": " << strict.getFormattedErrorMessages();
+      JSONTEST_ASSERT( root == expected ) << document;
+      Json::Document doc;
+      JSONTEST_ASSERT( strict.parse( document, doc ) ) << document;
+      JSONTEST_ASSERT( doc.root() == expected ) << document;
+   }
+
+   // The other features are read at run time.
+   Json::Features features = Json::Features::strictMode();
+   features.strictUtf8_ = true;
+   Json::StrictReader strictUtf8( features );
+   JSONTEST_ASSERT( !strictUtf8.parse( "[\"\xC0\x80\"]", root ) );
+   JSONTEST_ASSERT( strict.parse( "[\"\xC0\x80\"]", root ) ) << strict.getFormattedErrorMessages();
+}
+
+
+JSONTEST_FIXTURE( ReaderTest, scanSpacesAndStrings )
+{
+   // Whitespace runs of every length around the blocks skipped at once.
+   const char blanks[] = " \t\n\r";
+   for ( size_t length = 0; length < 70; ++length )
+   {
+      std::string spaces;
+      for ( size_t index = 0; index < length; ++index )
+         spaces += blanks[( index * 7 + length ) % 4];
+      const std::string document = spaces + "[" + spaces + "1" + spaces + "," + spaces + "\"a\"" + spaces + "]" + spaces;
+      Json::Value root;
+      Json::Reader reader;
+      JSONTEST_ASSERT( reader.parse( document, root ) ) << "length " << int(length) << ": " << reader.getFormattedErrorMessages();
+      JSONTEST_ASSERT( root.size() == 2 && root[1u].asString() == "a" ) << "length " << int(length);
+      JSONTEST_ASSERT( !reader.parse( spaces + "[1" + spaces + "x]", root ) ) << "length " << int(length);
+      JSONTEST_ASSERT( reader.getStructuredErrors()[0].offsetStart_ == length + 2 + length )
+         << "length " << int(length);
+   }
+
+   // An escape, a quote or a control character at every position of the blocks scanned
+   // at once, in strings read with and without UTF-8 validation.
+   for ( bool strict : { false, true } )
+   {
+      Json::Reader reader( strict ? withStrictUtf8() : Json::Features() );
+      for ( size_t position = 0; position <= 70; ++position )
+      {
+         const std::string before( position, 'a' );
+         const std::string after( 70 - position, 'b' );
+         Json::Value root;
+         JSONTEST_ASSERT( reader.parse( "[\"" + before + "\\\"" + after + "\",\"" + before + after + "\"]", root ) )
+            << "position " << int(position);
+         JSONTEST_ASSERT( root[0u].asString() == before + "\"" + after ) << "position " << int(position);
+         // The string following an escaped one is referenced as is.
+         JSONTEST_ASSERT( root[1u].asString() == before + after ) << "position " << int(position);
+         JSONTEST_ASSERT( reader.parse( "{\"" + before + "\\u00e9\\n\":\"" + after + "\\\\\"}", root ) )
+            << "position " << int(position);
+         JSONTEST_ASSERT( root.isMember( before + "\xC3\xA9\n" ) ) << "position " << int(position);
+         JSONTEST_ASSERT( root[before + "\xC3\xA9\n"].asString() == after + "\\" ) << "position " << int(position);
+         // Unterminated strings, which may end with a backslash.
+         JSONTEST_ASSERT( !reader.parse( "[\"" + before, root ) ) << "position " << int(position);
+         JSONTEST_ASSERT( !reader.parse( "[\"" + before + "\\", root ) ) << "position " << int(position);
+         JSONTEST_ASSERT( !reader.parse( "[\"" + before + "\\\"]", root ) ) << "position " << int(position);
+      }
+   }
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// Reclaimer
+// //////////////////////////////////////////////////////////////////
+
+struct ReclaimerTest : JsonTest::TestCase
+{
+#if !defined(JSONCPP_ENABLE_STATISTICS)
+   /* Counts the blocks of the containers built while it is the default resource.
+    * While blocked, releasing a block waits for unblock(): the thread destroying the
+    * tree stays busy.
+    */
+   class TrackingResource : public std::pmr::memory_resource
+   {
+   public:
+      int outstanding()
+      {
+         std::lock_guard<std::mutex> lock( mutex_ );
+         return outstanding_;
+      }
+
+      void block()
+      {
+         std::lock_guard<std::mutex> lock( mutex_ );
+         blocked_ = true;
+      }
+
+      // Waits until a thread is blocked releasing a block.
+      void waitUntilBlocking()
+      {
+         std::unique_lock<std::mutex> lock( mutex_ );
+         changed_.wait( lock, [this] { return blocking_; } );
+      }
+
+      void unblock()
+      {
+         {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            blocked_ = false;
+         }
+         changed_.notify_all();
+      }
+
+   private:
+      void *do_allocate( size_t bytes, size_t alignment ) override
+      {
+         std::lock_guard<std::mutex> lock( mutex_ );
+         ++outstanding_;
+         return std::pmr::new_delete_resource()->allocate( bytes, alignment );
+      }
+
+      void do_deallocate( void *block, size_t bytes, size_t alignment ) override
+      {
+         {
+            std::unique_lock<std::mutex> lock( mutex_ );
+            blocking_ = blocked_;
+            changed_.notify_all();
+            changed_.wait( lock, [this] { return !blocked_; } );
+            blocking_ = false;
+            --outstanding_;
+         }
+         std::pmr::new_delete_resource()->deallocate( block, bytes, alignment );
+      }
+
+      bool do_is_equal( const std::pmr::memory_resource &other ) const noexcept override
+      {
+         return this == &other;
+      }
+
+      std::mutex mutex_;
+      std::condition_variable changed_;
+      int outstanding_ = 0;
+      bool blocked_ = false;
+      bool blocking_ = false;
+   };
+
+   // A tree whose containers are allocated by resource.
+   static Json::Value makeTree( TrackingResource &resource )
+   {
+      std::pmr::memory_resource *previous = std::pmr::set_default_resource( &resource );
+      Json::Value tree( Json::arrayValue );
+      for ( int index = 0; index < 4; ++index )
+         tree.append( Json::Value( Json::objectValue ) )["member"] = index;
+      std::pmr::set_default_resource( previous );
+      return tree;
+   }
+#endif
+};
+
+
+// The containers of the library built with statistics are allocated by its counting
+// resource, not by the default resource: the tests relying on TrackingResource are
+// skipped.
+#if !defined(JSONCPP_ENABLE_STATISTICS)
+JSONTEST_FIXTURE( ReclaimerTest, deferAndFlush )
+{
+   TrackingResource blocker;
+   TrackingResource tracked;
+   Json::Reclaimer reclaimer( 2 );
+
+   Json::Value blocking = makeTree( blocker );
+   blocker.block();
+   JSONTEST_ASSERT( reclaimer.reclaim( std::move( blocking ) ) );
+   JSONTEST_ASSERT( blocking.isNull() );
+   blocker.waitUntilBlocking();
+
+   // The thread is busy: the trees wait in the backlog.
+   Json::Value first = makeTree( tracked );
+   Json::Value second = makeTree( tracked );
+   const int blockCount = tracked.outstanding();
+   JSONTEST_ASSERT( blockCount > 0 );
+   JSONTEST_ASSERT( reclaimer.reclaim( std::move( first ) ) );
+   JSONTEST_ASSERT( reclaimer.reclaim( std::move( second ) ) );
+   JSONTEST_ASSERT( first.isNull() && second.isNull() );
+   JSONTEST_ASSERT_EQUAL( blockCount, tracked.outstanding() );
+
+   // The backlog is full: the calling thread destroys the tree.
+   Json::Value third = makeTree( tracked );
+   JSONTEST_ASSERT( !reclaimer.reclaim( std::move( third ) ) );
+   JSONTEST_ASSERT( third.isNull() );
+   JSONTEST_ASSERT_EQUAL( blockCount, tracked.outstanding() );
+
+   blocker.unblock();
+   reclaimer.flush();
+   JSONTEST_ASSERT_EQUAL( 0, tracked.outstanding() );
+   JSONTEST_ASSERT_EQUAL( 0, blocker.outstanding() );
+
+   // The backlog is reused once emptied.
+   Json::Value fourth = makeTree( tracked );
+   JSONTEST_ASSERT( reclaimer.reclaim( std::move( fourth ) ) );
+   reclaimer.flush();
+   JSONTEST_ASSERT_EQUAL( 0, tracked.outstanding() );
+   reclaimer.flush();
+}
+#endif
+
+
+JSONTEST_FIXTURE( ReclaimerTest, destroyInline )
+{
+   Json::Reclaimer reclaimer;
+   Json::Value scalar( 5 );
+   JSONTEST_ASSERT( !reclaimer.reclaim( std::move( scalar ) ) );
+   JSONTEST_ASSERT( scalar.isNull() );
+   Json::Value string( "a string longer than the inline buffer" );
+   JSONTEST_ASSERT( !reclaimer.reclaim( std::move( string ) ) );
+   JSONTEST_ASSERT( string.isNull() );
+   JSONTEST_ASSERT( !reclaimer.reclaim( Json::Value() ) );
+
+   // Only a reference to a shared container is released.
+   Json::Value tree;
+   tree["list"].append( 1 );
+   tree.seal();
+   Json::Value copy = tree;
+   JSONTEST_ASSERT( !reclaimer.reclaim( std::move( tree ) ) );
+   JSONTEST_ASSERT( tree.isNull() );
+   JSONTEST_ASSERT_EQUAL( 1, copy["list"][0u].asInt() );
+
+   // Trees of an arena are released with the arena.
+   Json::Arena arena;
+   Json::Value arenaTree( Json::objectValue, arena );
+   arenaTree["name"] = Json::Value( std::string_view( "a string longer than the inline buffer" ), arena );
+   JSONTEST_ASSERT( !reclaimer.reclaim( std::move( arenaTree ) ) );
+   JSONTEST_ASSERT( arenaTree.isNull() );
+
+   JSONTEST_ASSERT( !reclaimer.reclaim( std::unique_ptr<Json::Document>() ) );
+   auto document = std::make_unique<Json::Document>();
+   Json::Reader reader;
+   JSONTEST_ASSERT( reader.parse( "{\"a\":[1,2,3]}", *document ) );
+   JSONTEST_ASSERT( reclaimer.reclaim( std::move( document ) ) );
+   JSONTEST_ASSERT( !document );
+   reclaimer.flush();
+
+   // Without a backlog, everything is destroyed by the calling thread.
+   Json::Reclaimer immediate( 0 );
+   Json::Value owned;
+   owned["list"].append( 1 );
+   JSONTEST_ASSERT( !immediate.reclaim( std::move( owned ) ) );
+   JSONTEST_ASSERT( owned.isNull() );
+   document = std::make_unique<Json::Document>();
+   JSONTEST_ASSERT( reader.parse( "[1,2,3]", *document ) );
+   JSONTEST_ASSERT( !immediate.reclaim( std::move( document ) ) );
+   JSONTEST_ASSERT( !document );
+   immediate.flush();
+}
+
+
+#if !defined(JSONCPP_ENABLE_STATISTICS)
+JSONTEST_FIXTURE( ReclaimerTest, destructorDrainsBacklog )
+{
+   TrackingResource blocker;
+   TrackingResource tracked;
+   std::thread unblocker;
+   {
+      Json::Reclaimer reclaimer( 8 );
+      Json::Value blocking = makeTree( blocker );
+      blocker.block();
+      JSONTEST_ASSERT( reclaimer.reclaim( std::move( blocking ) ) );
+      blocker.waitUntilBlocking();
+      for ( int index = 0; index < 5; ++index )
+         JSONTEST_ASSERT( reclaimer.reclaim( makeTree( tracked ) ) );
+      auto document = std::make_unique<Json::Document>();
+      Json::Reader reader;
+      JSONTEST_ASSERT( reader.parse( "{\"a\":[1,2,3]}", *document ) );
+      JSONTEST_ASSERT( reclaimer.reclaim( std::move( document ) ) );
+      JSONTEST_ASSERT( tracked.outstanding() > 0 );
+      // The destructor is entered while the thread is still blocked.
+      unblocker = std::thread( [&blocker] {
+         std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+         blocker.unblock();
+      } );
+   }
+   unblocker.join();
+   JSONTEST_ASSERT_EQUAL( 0, tracked.outstanding() );
+   JSONTEST_ASSERT_EQUAL( 0, blocker.outstanding() );
+}
+#endif
+
+
+// //////////////////////////////////////////////////////////////////
+// MappedFile
+// //////////////////////////////////////////////////////////////////
+
+struct FileTest : JsonTest::TestCase
+{
+   // Writes content to a file of the temporary directory, removed with the fixture.
+   std::string makeFile( const std::string &content )
+   {
+      std::filesystem::path path = std::filesystem::temp_directory_path() /
+         ( "jsoncpp_test_" + std::to_string( std::hash<std::thread::id>{}( std::this_thread::get_id() ) ) + "_" +
+           std::to_string( paths_.size() ) + ".json" );
+      std::ofstream out( path, std::ios::binary );
+      out.write( content.data(), std::streamsize( content.size() ) );
+      paths_.push_back( path.string() );
+      return path.string();
+   }
+
+   ~FileTest()
+   {
+      for ( const std::string &path : paths_ )
+         std::remove( path.c_str() );
+   }
+
+   std::vector<std::string> paths_;
+};
+
+
+JSONTEST_FIXTURE( FileTest, mapRegularFiles )
+{
+   const std::string content = "{\"name\":\"a string longer than the inline buffer\",\"list\":[1,2,3]}";
+   const std::string path = makeFile( content );
+   Json::MappedFile file;
+   JSONTEST_ASSERT( file.open( path ) );
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+   JSONTEST_ASSERT( file.isMapped() );
+#endif
+   JSONTEST_ASSERT( std::string( file.begin(), file.end() ) == content );
+   JSONTEST_ASSERT( file.size() == content.size() );
+   file.close();
+   JSONTEST_ASSERT( file.size() == 0 && !file.isMapped() );
+
+   Json::Value root;
+   {
+      Json::Reader reader;
+      JSONTEST_ASSERT( reader.parseFile( path, root ) ) << reader.getFormattedErrorMessages();
+   }
+   // The strings are copied: root outlives the reader and the mapping.
+   JSONTEST_ASSERT_EQUAL( std::string( "a string longer than the inline buffer" ), root["name"].asString() );
+   JSONTEST_ASSERT_EQUAL( 3u, root["list"].size() );
+
+   Json::Reader reader;
+   Json::Document doc;
+   JSONTEST_ASSERT( reader.parseFile( path, doc ) ) << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT( doc.root() == root );
+
+   // Errors are reported after the file is unmapped.
+   const std::string invalid = makeFile( "{\n\"a\":[1,\n2,,3]}" );
+   JSONTEST_ASSERT( !reader.parseFile( invalid, root ) );
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages().find( "Line 3, Column 3" ) != std::string::npos )
+      << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT( reader.parseFile( path, root ) ) << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages().empty() );
+}
+
+
+JSONTEST_FIXTURE( FileTest, readOtherFiles )
+{
+   // Empty files cannot be mapped: they are read.
+   const std::string empty = makeFile( "" );
+   Json::MappedFile file;
+   JSONTEST_ASSERT( file.open( empty ) );
+   JSONTEST_ASSERT( !file.isMapped() );
+   JSONTEST_ASSERT( file.size() == 0 && file.begin() == file.end() );
+   Json::Reader reader;
+   Json::Value root;
+   JSONTEST_ASSERT( !reader.parseFile( empty, root ) );
+
+#if defined(__unix__) || defined(__APPLE__)
+   // Devices are not regular files.
+   JSONTEST_ASSERT( file.open( "/dev/null" ) );
+   JSONTEST_ASSERT( !file.isMapped() );
+   JSONTEST_ASSERT( file.size() == 0 );
+#endif
+
+   // Opening a file releases the previous one.
+   const std::string content = "[1,2,3]";
+   JSONTEST_ASSERT( file.open( makeFile( content ) ) );
+   JSONTEST_ASSERT( std::string( file.begin(), file.end() ) == content );
+   JSONTEST_ASSERT( file.open( empty ) );
+   JSONTEST_ASSERT( file.size() == 0 );
+}
+
+
+JSONTEST_FIXTURE( FileTest, missingFiles )
+{
+   const std::string path = ( std::filesystem::temp_directory_path() / "jsoncpp_test_missing" / "file.json" ).string();
+   Json::MappedFile file;
+   JSONTEST_ASSERT( !file.open( path ) );
+   JSONTEST_ASSERT( file.size() == 0 && !file.isMapped() );
+
+   Json::Reader reader;
+   Json::Value root;
+   JSONTEST_ASSERT( !reader.parseFile( path, root ) );
+   JSONTEST_ASSERT( reader.getFormattedErrorMessages().find( "Unable to read file '" + path + "'." ) != std::string::npos )
+      << reader.getFormattedErrorMessages();
+   JSONTEST_ASSERT( reader.getStructuredErrors().size() == 1 );
+   Json::Document doc;
+   JSONTEST_ASSERT( !reader.parseFile( path, doc ) );
+   JSONTEST_ASSERT( reader.getStructuredErrors().size() == 1 );
+}
+
+
+JSONTEST_FIXTURE( FileTest, documentsEndingAtPageBoundaries )
+{
+   // The page following the mapping is not readable: reading past the end would fault.
+   for ( size_t size : { size_t( 4096 ), size_t( 16384 ), size_t( 65536 ) } )
+   {
+      const std::string values[] = { "7", "-12.5e3", "true", "null", "\"text\"", "[1,2]", "{\"a\":1}" };
+      for ( const std::string &value : values )
+      {
+         const std::string path = makeFile( std::string( size - value.size(), ' ' ) + value );
+         Json::Reader reader;
+         Json::Value root;
+         JSONTEST_ASSERT( reader.parseFile( path, root ) ) << value << ": " << reader.getFormattedErrorMessages();
+         Json::Reader expectedReader;
+         Json::Value expected;
+         expectedReader.parse( value, expected );
+         JSONTEST_ASSERT( root == expected ) << value;
+
+         Json::MappedFile file;
+         JSONTEST_ASSERT( file.open( path ) );
+         JSONTEST_ASSERT( file.size() == size );
+         Json::LazyDocument lazy;
+         JSONTEST_ASSERT( lazy.parse( file.begin(), file.end() ) ) << value;
+      }
+      // A string left open at the end of the page.
+      const std::string path = makeFile( "[\"" + std::string( size - 2, 'a' ) );
+      Json::Reader reader;
+      Json::Value root;
+      JSONTEST_ASSERT( !reader.parseFile( path, root ) );
+   }
+}
+
+
+// //////////////////////////////////////////////////////////////////
+// Statistics
+// //////////////////////////////////////////////////////////////////
+
+struct StatisticsTest : JsonTest::TestCase
+{
+   // Keeps the statistics of the last operation reported.
+   struct Recorder : Json::StatisticsListener
+   {
+      std::vector<Json::Statistics> records;
+
+      void record( const Json::Statistics &statistics ) override { records.push_back( statistics ); }
+   };
+};
+
+
+#if defined(JSONCPP_ENABLE_STATISTICS)
+JSONTEST_FIXTURE( StatisticsTest, counters )
+{
+   Json::Reader reader;
+   Json::Value root;
+   const std::string document = "{\"a\":[1,\"xy\"],\"b\":{}}";
+   JSONTEST_ASSERT( reader.parse( document, root ) );
+   const Json::Statistics &parsed = reader.getStatistics();
+   JSONTEST_ASSERT( parsed.phase_ == Json::Statistics::phaseParse );
+   JSONTEST_ASSERT( parsed.bytes_ == document.size() );
+   // 14 tokens and the end of the document.
+   JSONTEST_ASSERT( parsed.tokens_ == 15 );
+   JSONTEST_ASSERT( parsed.nodes_ == 5 );
+   JSONTEST_ASSERT_EQUAL( 2u, parsed.maxDepth_ );
+   // "a", "xy" and "b".
+   JSONTEST_ASSERT( parsed.stringBytes_ == 4 );
+   JSONTEST_ASSERT( parsed.allocations_ > 0 );
+
+   // Comments are tokens; unescaped strings are counted once decoded.
+   JSONTEST_ASSERT( reader.parse( "// comment\n[\"v\\u00e9\" /* comment */]", root ) );
+   JSONTEST_ASSERT( reader.getStatistics().tokens_ == 6 );
+   JSONTEST_ASSERT( reader.getStatistics().nodes_ == 2 );
+   JSONTEST_ASSERT( reader.getStatistics().stringBytes_ == 3 );
+   JSONTEST_ASSERT_EQUAL( 1u, reader.getStatistics().maxDepth_ );
+
+   JSONTEST_ASSERT( reader.parse( "[]", root ) );
+   JSONTEST_ASSERT( reader.getStatistics().allocations_ == 1 );
+   JSONTEST_ASSERT( reader.parse( "[[[[1]]],[2]]", root ) );
+   JSONTEST_ASSERT_EQUAL( 4u, reader.getStatistics().maxDepth_ );
+
+   // The trees of a Document are allocated in its arena.
+   Json::Document doc;
+   JSONTEST_ASSERT( reader.parse( "{\"a\":[1,\"a string longer than the inline buffer\"]}", doc ) );
+   JSONTEST_ASSERT( reader.getStatistics().allocations_ == 0 );
+   JSONTEST_ASSERT( reader.getStatistics().stringBytes_ == 39 );
+
+   JSONTEST_ASSERT( Json::Reader().parse( document, root ) );
+   Json::FastWriter writer;
+   const std::string written = writer.write( root );
+   const Json::Statistics &write = writer.getStatistics();
+   JSONTEST_ASSERT( write.phase_ == Json::Statistics::phaseWrite );
+   JSONTEST_ASSERT( write.bytes_ == written.size() );
+   JSONTEST_ASSERT( write.tokens_ == 0 );
+   JSONTEST_ASSERT( write.nodes_ == 5 );
+   JSONTEST_ASSERT_EQUAL( 2u, write.maxDepth_ );
+   JSONTEST_ASSERT( write.stringBytes_ == 4 );
+
+   Json::StyledWriter styled;
+   JSONTEST_ASSERT( styled.write( root ).size() == styled.getStatistics().bytes_ );
+   JSONTEST_ASSERT( styled.getStatistics().nodes_ == 5 );
+
+   // The parallel writer counts like the serial one.
+   Json::Value large( Json::arrayValue );
+   for ( int index = 0; index < 20000; ++index )
+      large.append( "element" );
+   Json::FastWriter serial;
+   serial.write( large );
+   Json::FastWriter parallel;
+   parallel.enableParallelWrite( 4 );
+   parallel.write( large );
+   JSONTEST_ASSERT( parallel.getStatistics().nodes_ == serial.getStatistics().nodes_ );
+   JSONTEST_ASSERT( parallel.getStatistics().stringBytes_ == serial.getStatistics().stringBytes_ );
+   JSONTEST_ASSERT( parallel.getStatistics().bytes_ == serial.getStatistics().bytes_ );
+   JSONTEST_ASSERT_EQUAL( serial.getStatistics().maxDepth_, parallel.getStatistics().maxDepth_ );
+}
+
+
+JSONTEST_FIXTURE( StatisticsTest, listener )
+{
+   Recorder recorder;
+   Json::setStatisticsListener( &recorder );
+   Json::Reader reader;
+   Json::Value root;
+   reader.parse( "[1,2,3]", root );
+   Json::FastWriter().write( root );
+   Json::setStatisticsListener( nullptr );
+   reader.parse( "[1,2,3]", root );
+
+   JSONTEST_ASSERT( recorder.records.size() == 2 );
+   JSONTEST_ASSERT( recorder.records[0].phase_ == Json::Statistics::phaseParse );
+   JSONTEST_ASSERT( recorder.records[0].nodes_ == 4 );
+   JSONTEST_ASSERT( recorder.records[1].phase_ == Json::Statistics::phaseWrite );
+   JSONTEST_ASSERT( recorder.records[1].bytes_ == 8 );
+}
+#else
+JSONTEST_FIXTURE( StatisticsTest, disabled )
+{
+   Recorder recorder;
+   Json::setStatisticsListener( &recorder );
+   Json::Reader reader;
+   Json::Value root;
+   JSONTEST_ASSERT( reader.parse( "{\"a\":[1,\"xy\"]}", root ) );
+   Json::FastWriter writer;
+   writer.write( root );
+   Json::setStatisticsListener( nullptr );
+
+   for ( const Json::Statistics *statistics : { &reader.getStatistics(), &writer.getStatistics() } )
+   {
+      JSONTEST_ASSERT( statistics->bytes_ == 0 && statistics->tokens_ == 0 && statistics->nodes_ == 0 );
+      JSONTEST_ASSERT( statistics->maxDepth_ == 0 && statistics->stringBytes_ == 0 && statistics->allocations_ == 0 );
+   }
+   JSONTEST_ASSERT( recorder.records.empty() );
+}
+#endif
+
+
 int main( int argc, const char *argv[] )
 {
    JsonTest::Runner runner;
@@ -416,6 +3368,7 @@ int main( int argc, const char *argv[] )
    JSONTEST_REGISTER_FIXTURE( runner, ValueTest, isNull );
    JSONTEST_REGISTER_FIXTURE( runner, ValueTest, isNull );
    JSONTEST_REGISTER_FIXTURE( runner, ValueTest, accessArray );
+   JSONTEST_REGISTER_FIXTURE( runner, ValueTest, accessOtherContainer );
    JSONTEST_REGISTER_FIXTURE( runner, ValueTest, asFloat );
    JSONTEST_REGISTER_FIXTURE( runner, ValueTest, compareNull );
    JSONTEST_REGISTER_FIXTURE( runner, ValueTest, compareInt );
@@ -426,5 +3379,79 @@ int main( int argc, const char *argv[] )
    JSONTEST_REGISTER_FIXTURE( runner, ValueTest, compareArray );
    JSONTEST_REGISTER_FIXTURE( runner, ValueTest, compareObject );
    JSONTEST_REGISTER_FIXTURE( runner, ValueTest, compareType );
+   JSONTEST_REGISTER_FIXTURE( runner, ValueTest, stringsAroundInlineLength );
+   JSONTEST_REGISTER_FIXTURE( runner, ValueTest, moveIntoContainers );
+   JSONTEST_REGISTER_FIXTURE( runner, ValueTest, largeObjects );
+   JSONTEST_REGISTER_FIXTURE( runner, KeyTableTest, shareNames );
+   JSONTEST_REGISTER_FIXTURE( runner, KeyTableTest, namesOutliveTheTable );
+   JSONTEST_REGISTER_FIXTURE( runner, KeyTableTest, readerInternsNames );
+   JSONTEST_REGISTER_FIXTURE( runner, CopyOnWriteTest, copiesAreIndependent );
+   JSONTEST_REGISTER_FIXTURE( runner, CopyOnWriteTest, referencesTakenBeforeCopy );
+   JSONTEST_REGISTER_FIXTURE( runner, CopyOnWriteTest, pathFindDetaches );
+   JSONTEST_REGISTER_FIXTURE( runner, CopyOnWriteTest, sealedTreesAreShared );
+   JSONTEST_REGISTER_FIXTURE( runner, CopyOnWriteTest, arenaValuesAreCopiedToTheHeap );
+   JSONTEST_REGISTER_FIXTURE( runner, PatchTest, hashAfterMutation );
+   JSONTEST_REGISTER_FIXTURE( runner, PatchTest, hashOfSealedTrees );
+   JSONTEST_REGISTER_FIXTURE( runner, PatchTest, diffThenApply );
+   JSONTEST_REGISTER_FIXTURE( runner, PatchTest, failedApplyIsUndone );
+   JSONTEST_REGISTER_FIXTURE( runner, PatchTest, numbersAreComparedByValue );
+   JSONTEST_REGISTER_FIXTURE( runner, BinaryTest, roundTrip );
+   JSONTEST_REGISTER_FIXTURE( runner, BinaryTest, readGenericItems );
+   JSONTEST_REGISTER_FIXTURE( runner, BinaryTest, rejectMalformed );
+   JSONTEST_REGISTER_FIXTURE( runner, BinaryTest, rejectDeepNesting );
+   JSONTEST_REGISTER_FIXTURE( runner, HandlerTest, events );
+   JSONTEST_REGISTER_FIXTURE( runner, HandlerTest, largeIntegers );
+   JSONTEST_REGISTER_FIXTURE( runner, NumberTest, parseDoubles );
+   JSONTEST_REGISTER_FIXTURE( runner, NumberTest, writeDoubles );
+   JSONTEST_REGISTER_FIXTURE( runner, WriterTest, styledLayout );
+   JSONTEST_REGISTER_FIXTURE( runner, WriterTest, embeddedZeros );
+   JSONTEST_REGISTER_FIXTURE( runner, WriterTest, parallelWriteLargeDocuments );
+   JSONTEST_REGISTER_FIXTURE( runner, WriterTest, parallelWriteSmallDocuments );
+   JSONTEST_REGISTER_FIXTURE( runner, WriterTest, writeIntoBuffers );
+   JSONTEST_REGISTER_FIXTURE( runner, WriterTest, escapeEveryByte );
+   JSONTEST_REGISTER_FIXTURE( runner, BatchReaderTest, parseSeveralBatches );
+   JSONTEST_REGISTER_FIXTURE( runner, ArenaTest, allocate );
+   JSONTEST_REGISTER_FIXTURE( runner, ArenaTest, buildTree );
+   JSONTEST_REGISTER_FIXTURE( runner, ArenaTest, parseDocument );
+   JSONTEST_REGISTER_FIXTURE( runner, IncrementalReaderTest, splitAnywhere );
+   JSONTEST_REGISTER_FIXTURE( runner, IncrementalReaderTest, pendingNumberAtEnd );
+   JSONTEST_REGISTER_FIXTURE( runner, IncrementalReaderTest, stopAtInvalidDocument );
+   JSONTEST_REGISTER_FIXTURE( runner, IncrementalReaderTest, largeStreams );
+   JSONTEST_REGISTER_FIXTURE( runner, IncrementalReaderTest, parseWhileReceiving );
+   JSONTEST_REGISTER_FIXTURE( runner, LazyDocumentTest, lookups );
+   JSONTEST_REGISTER_FIXTURE( runner, LazyDocumentTest, iterateAndDecode );
+   JSONTEST_REGISTER_FIXTURE( runner, LazyDocumentTest, invalidDocuments );
+   JSONTEST_REGISTER_FIXTURE( runner, BindingTest, readAndWrite );
+   JSONTEST_REGISTER_FIXTURE( runner, BindingTest, rejectMismatches );
+   JSONTEST_REGISTER_FIXTURE( runner, InSituTest, sameRootAsParse );
+   JSONTEST_REGISTER_FIXTURE( runner, InSituTest, referencesTheDocument );
+   JSONTEST_REGISTER_FIXTURE( runner, PathTest, pointers );
+   JSONTEST_REGISTER_FIXTURE( runner, PathTest, makePointers );
+   JSONTEST_REGISTER_FIXTURE( runner, PathTest, pathSet );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, maxDepth );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, deepDocuments );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, reuseAfterFailure );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, structuredErrors );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, errorsOutliveTheDocument );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, failFast );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, strictUtf8 );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, strictUtf8Escapes );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, strictReader );
+   JSONTEST_REGISTER_FIXTURE( runner, ReaderTest, scanSpacesAndStrings );
+#if !defined(JSONCPP_ENABLE_STATISTICS)
+   JSONTEST_REGISTER_FIXTURE( runner, ReclaimerTest, deferAndFlush );
+   JSONTEST_REGISTER_FIXTURE( runner, ReclaimerTest, destructorDrainsBacklog );
+#endif
+   JSONTEST_REGISTER_FIXTURE( runner, ReclaimerTest, destroyInline );
+   JSONTEST_REGISTER_FIXTURE( runner, FileTest, mapRegularFiles );
+   JSONTEST_REGISTER_FIXTURE( runner, FileTest, readOtherFiles );
+   JSONTEST_REGISTER_FIXTURE( runner, FileTest, missingFiles );
+   JSONTEST_REGISTER_FIXTURE( runner, FileTest, documentsEndingAtPageBoundaries );
+#if defined(JSONCPP_ENABLE_STATISTICS)
+   JSONTEST_REGISTER_FIXTURE( runner, StatisticsTest, counters );
+   JSONTEST_REGISTER_FIXTURE( runner, StatisticsTest, listener );
+#else
+   JSONTEST_REGISTER_FIXTURE( runner, StatisticsTest, disabled );
+#endif
    return runner.runCommandLine( argc, argv );
 }